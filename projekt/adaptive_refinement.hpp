@@ -0,0 +1,538 @@
+#ifndef SIMU_PROJEKT_ADAPTIVE_REFINEMENT_HPP
+#define SIMU_PROJEKT_ADAPTIVE_REFINEMENT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mef_process.hpp"
+#include "mesh.hpp"
+#include "solver_options.hpp"
+#include "vector.hpp"
+
+const float ADAPT_MARKING_FRACTION = 0.5f;  // fraccion del error estimado que cubren los elementos marcados (Dorfler)
+
+// Aristas locales de un tetraedro y caras locales (la cara i es la opuesta al nodo i)
+const int TET_EDGES[6][2] = { {0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3} };
+const int TET_FACES[4][3] = { {1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2} };
+
+// Clave de una arista a partir de sus dos nodos (base 0), independiente del orden
+inline unsigned long long edge_key(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return ((unsigned long long)a << 32) | (unsigned int)b;
+}
+
+/*
+  Malla Tet4 en arreglos planos: es la forma en que el refinamiento recibe
+  la malla actual y arma la siguiente, sin tocar los pools de Mesh. Los nodos
+  con condicion de Dirichlet guardan su valor fijo.
+
+  Las condiciones de Neumann son cargas nodales. Las de los nodos de una
+  cara cargada (cara del contorno con sus tres vertices cargados) se
+  guardan como flujo por unidad de area: la carga dividida por el area
+  tributaria del nodo (un tercio del area de cada cara cargada que lo
+  contiene). Al refinar, el flujo se interpola en los puntos medios de esas
+  caras y las cargas se vuelven a integrar sobre las caras hijas, de modo
+  que la carga total se conserva y no queda concentrada en los nodos
+  gruesos. Las cargas de nodos fuera de toda cara cargada quedan como
+  cargas puntuales.
+ */
+struct TetMesh {
+    float k = 0, Q = 0;                       // datos del problema
+    std::vector<float> coordinates;           // x, y, z de cada nodo
+    std::vector<int> tets;                    // 4 nodos (base 0) por elemento
+    std::vector<char> constrained;            // 1 si el nodo tiene condicion de Dirichlet
+    std::vector<float> fixed_value;           // valor de Dirichlet del nodo
+    std::vector<char> loaded;                 // 1 si el nodo pertenece a una cara cargada
+    std::vector<float> flux;                  // flujo de Neumann por unidad de area del nodo de una cara cargada
+    std::vector<std::pair<int, float>> loads; // cargas puntuales (nodo, valor) de los nodos fuera de las caras cargadas
+
+    int get_num_nodes() const { return (int)constrained.size(); }
+    int get_num_elements() const { return (int)tets.size() / 4; }
+
+    // metodo para obtener el cuadrado de la longitud de la arista (a, b)
+    double edge_length2(int a, int b) const {
+        double dx = coordinates[3 * a] - coordinates[3 * b];
+        double dy = coordinates[3 * a + 1] - coordinates[3 * b + 1];
+        double dz = coordinates[3 * a + 2] - coordinates[3 * b + 2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // metodo que indica si la arista (a, b) es mas larga que (c, d); los empates se resuelven por los nodos
+    bool longer(int a, int b, int c, int d) const {
+        double first = edge_length2(a, b), second = edge_length2(c, d);
+        if (first != second) return first > second;
+        return edge_key(a, b) > edge_key(c, d);
+    }
+
+    // metodo para obtener la arista mas larga del elemento e
+    unsigned long long longest_edge(int e) const {
+        const int* t = &tets[4 * e];
+        int best = 0;
+        for (int i = 1; i < 6; i++)
+            if (longer(t[TET_EDGES[i][0]], t[TET_EDGES[i][1]], t[TET_EDGES[best][0]], t[TET_EDGES[best][1]]))
+                best = i;
+        return edge_key(t[TET_EDGES[best][0]], t[TET_EDGES[best][1]]);
+    }
+
+    // metodo para obtener el area del triangulo (a, b, c)
+    double face_area(int a, int b, int c) const {
+        double u[3], v[3];
+        for (int d = 0; d < 3; d++) {
+            u[d] = coordinates[3 * b + d] - coordinates[3 * a + d];
+            v[d] = coordinates[3 * c + d] - coordinates[3 * a + d];
+        }
+        double n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        return 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    }
+
+    // metodo para obtener las caras del contorno (de un solo elemento) con sus tres vertices marcados en flag
+    std::vector<std::array<int, 3>> boundary_faces(const std::vector<char>& flag) const {
+        std::vector<std::array<int, 3>> faces;
+        for (int e = 0; e < get_num_elements(); e++)
+            for (int f = 0; f < 4; f++) {
+                std::array<int, 3> face;
+                for (int i = 0; i < 3; i++) face[i] = tets[4 * e + TET_FACES[f][i]];
+                if (!flag[face[0]] || !flag[face[1]] || !flag[face[2]]) continue;
+                std::sort(face.begin(), face.end());
+                faces.push_back(face);
+            }
+        std::sort(faces.begin(), faces.end());
+
+        // las caras interiores aparecen dos veces
+        std::vector<std::array<int, 3>> boundary;
+        for (size_t i = 0; i < faces.size();) {
+            size_t j = i + 1;
+            while (j < faces.size() && faces[j] == faces[i]) j++;
+            if (j == i + 1) boundary.push_back(faces[i]);
+            i = j;
+        }
+        return boundary;
+    }
+};
+
+// Funcion para copiar una malla Tet4 a arreglos planos
+void extract_tet_mesh(Mesh* M, TetMesh* mesh) {
+    int num_nodes = M->get_quantity(NUM_NODES);
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    const DofMap* dofs = M->get_dof_map();
+
+    mesh->k = M->get_problem_data(THERMAL_CONDUCTIVITY);
+    mesh->Q = M->get_problem_data(HEAT_SOURCE);
+    mesh->coordinates.resize(3 * (size_t)num_nodes);
+    mesh->constrained.resize(num_nodes);
+    mesh->fixed_value.resize(num_nodes);
+    for (int i = 0; i < num_nodes; i++) {
+        Node* node = M->get_node(i);
+        mesh->coordinates[3 * i] = node->get_x_coordinate();
+        mesh->coordinates[3 * i + 1] = node->get_y_coordinate();
+        mesh->coordinates[3 * i + 2] = node->get_z_coordinate();
+        mesh->constrained[i] = dofs->is_constrained(i) ? 1 : 0;
+        mesh->fixed_value[i] = dofs->is_constrained(i) ? dofs->get_fixed_value(i) : 0;
+    }
+    mesh->tets.resize(4 * (size_t)num_elements);
+    for (int e = 0; e < num_elements; e++)
+        for (int a = 0; a < 4; a++)
+            mesh->tets[4 * e + a] = M->get_element(e)->get_node(a)->get_ID() - 1;
+
+    // cargas nodales: las de las caras cargadas pasan a flujo por unidad de area
+    std::vector<char> has_load(num_nodes, 0);
+    std::vector<float> load(num_nodes, 0);
+    for (int c = 0; c < M->get_quantity(NUM_NEUMANN); c++) {
+        Condition* condition = M->get_neumann_condition(c);
+        int i = condition->get_node()->get_ID() - 1;
+        has_load[i] = 1;
+        load[i] += condition->get_value();
+    }
+    std::vector<double> area(num_nodes, 0.0);
+    for (const std::array<int, 3>& face : mesh->boundary_faces(has_load)) {
+        double third = mesh->face_area(face[0], face[1], face[2]) / 3;
+        for (int i : face) area[i] += third;
+    }
+    mesh->loaded.assign(num_nodes, 0);
+    mesh->flux.assign(num_nodes, 0);
+    mesh->loads.clear();
+    for (int i = 0; i < num_nodes; i++) {
+        if (!has_load[i]) continue;
+        if (area[i] > 0) {
+            mesh->loaded[i] = 1;
+            mesh->flux[i] = (float)(load[i] / area[i]);
+        }
+        else
+            mesh->loads.push_back(std::make_pair(i, load[i]));
+    }
+}
+
+/*
+  Funcion para armar una malla a partir de arreglos planos: nodos y
+  elementos se numeran en orden desde 1, se crean las condiciones (las
+  cargas de las caras cargadas se integran con el flujo de cada nodo) y se
+  calculan la numeracion de grados de libertad y la geometria. Devuelve la
+  cantidad de elementos degenerados.
+ */
+int build_tet_mesh(const TetMesh& mesh, Mesh* M) {
+    int num_nodes = mesh.get_num_nodes();
+    int num_elements = mesh.get_num_elements();
+    int num_dirichlet = 0;
+    for (int i = 0; i < num_nodes; i++) num_dirichlet += mesh.constrained[i];
+
+    std::vector<double> load(num_nodes, 0.0);
+    for (const std::array<int, 3>& face : mesh.boundary_faces(mesh.loaded)) {
+        double third = mesh.face_area(face[0], face[1], face[2]) / 3;
+        for (int i : face) load[i] += mesh.flux[i] * third;
+    }
+    int num_loaded = 0;
+    for (int i = 0; i < num_nodes; i++) num_loaded += mesh.loaded[i];
+
+    M->set_problem_data(mesh.k, mesh.Q);
+    M->set_quantities(num_nodes, num_elements, num_dirichlet, num_loaded + (int)mesh.loads.size());
+    M->init_arrays();
+
+    for (int i = 0; i < num_nodes; i++)
+        M->insert_node(M->create_node(i + 1, mesh.coordinates[3 * i], mesh.coordinates[3 * i + 1],
+            mesh.coordinates[3 * i + 2]), i);
+    for (int e = 0; e < num_elements; e++) {
+        Node* element_nodes[4];
+        for (int a = 0; a < 4; a++) element_nodes[a] = M->get_node(mesh.tets[4 * e + a]);
+        M->insert_element(M->create_element(e + 1, ELEMENT_TET4, element_nodes), e);
+    }
+    for (int i = 0, d = 0; i < num_nodes; i++)
+        if (mesh.constrained[i])
+            M->insert_dirichlet_condition(M->create_condition(M->get_node(i), mesh.fixed_value[i]), d++);
+    int c = 0;
+    for (int i = 0; i < num_nodes; i++)
+        if (mesh.loaded[i]) M->insert_neumann_condition(M->create_condition(M->get_node(i), (float)load[i]), c++);
+    for (const std::pair<int, float>& point : mesh.loads)
+        M->insert_neumann_condition(M->create_condition(M->get_node(point.first), point.second), c++);
+
+    M->build_dof_map();
+    return M->build_geometry();
+}
+
+/*
+  Estimador de error a posteriori basado en residuos para -k lap(T) = Q con
+  elementos Tet4. En cada elemento el gradiente es constante, de modo que el
+  residuo interior es Q y el flujo salta de un elemento a su vecino a traves
+  de cada cara compartida F:
+
+    eta_e^2 = h_e^2 Q^2 |e| / k + sum_F 1/2 h_F |F| [k grad(T) . n]^2 / k
+
+  (h: diametro; la mitad del salto de cada cara se asigna a cada uno de los
+  dos elementos). Las caras se encuentran ordenando sus tres nodos. Guarda
+  eta_e^2 en indicators y devuelve la norma de energia de la solucion,
+  sum k |grad T|^2 |e|, con la que se hace relativo el error global.
+ */
+double compute_error_indicators(Mesh* M, const Vector* T_full, std::vector<double>* indicators) {
+    const ElementGeometry* geometry = M->get_geometry();
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    double k = M->get_problem_data(THERMAL_CONDUCTIVITY);
+    double Q = M->get_problem_data(HEAT_SOURCE);
+
+    struct Face {
+        int node[3];   // nodos de la cara en orden creciente
+        int element;   // elemento que la contiene
+    };
+    std::vector<Face> faces(4 * (size_t)num_elements);
+    std::vector<double> gradients(3 * (size_t)num_elements, 0.0);
+    indicators->assign(num_elements, 0.0);
+    double energy = 0;
+
+    for (int e = 0; e < num_elements; e++) {
+        double volume = std::fabs(geometry->get_volume(e));
+        double h2 = 0;
+        for (int i = 0; i < 6; i++) {
+            Node* a = M->get_element(e)->get_node(TET_EDGES[i][0]);
+            Node* b = M->get_element(e)->get_node(TET_EDGES[i][1]);
+            double dx = a->get_x_coordinate() - b->get_x_coordinate();
+            double dy = a->get_y_coordinate() - b->get_y_coordinate();
+            double dz = a->get_z_coordinate() - b->get_z_coordinate();
+            h2 = std::max(h2, dx * dx + dy * dy + dz * dz);
+        }
+        for (int a = 0; a < 4; a++) {
+            float g[3];
+            geometry->get_gradient(e, a, g);
+            float value = T_full->get(geometry->get_node(e, a));
+            for (int d = 0; d < 3; d++) gradients[3 * e + d] += value * g[d];
+        }
+        const double* g = &gradients[3 * e];
+        energy += k * (g[0] * g[0] + g[1] * g[1] + g[2] * g[2]) * volume;
+        (*indicators)[e] = h2 * Q * Q * volume / k;
+
+        for (int f = 0; f < 4; f++) {
+            Face& face = faces[4 * (size_t)e + f];
+            for (int i = 0; i < 3; i++) face.node[i] = geometry->get_node(e, TET_FACES[f][i]);
+            std::sort(face.node, face.node + 3);
+            face.element = e;
+        }
+    }
+
+    std::sort(faces.begin(), faces.end(), [](const Face& x, const Face& y) {
+        return std::lexicographical_compare(x.node, x.node + 3, y.node, y.node + 3);
+    });
+
+    for (size_t i = 0; i + 1 < faces.size(); i++) {
+        const Face& first = faces[i];
+        const Face& second = faces[i + 1];
+        if (!std::equal(first.node, first.node + 3, second.node)) continue;
+
+        Node* p[3];
+        for (int j = 0; j < 3; j++) p[j] = M->get_node(first.node[j]);
+        double u[3] = { p[1]->get_x_coordinate() - p[0]->get_x_coordinate(),
+            p[1]->get_y_coordinate() - p[0]->get_y_coordinate(), p[1]->get_z_coordinate() - p[0]->get_z_coordinate() };
+        double v[3] = { p[2]->get_x_coordinate() - p[0]->get_x_coordinate(),
+            p[2]->get_y_coordinate() - p[0]->get_y_coordinate(), p[2]->get_z_coordinate() - p[0]->get_z_coordinate() };
+        double normal[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        double twice_area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (twice_area == 0) continue;
+
+        double w[3] = { v[0] - u[0], v[1] - u[1], v[2] - u[2] };
+        double hF = std::sqrt(std::max({ u[0] * u[0] + u[1] * u[1] + u[2] * u[2],
+            v[0] * v[0] + v[1] * v[1] + v[2] * v[2], w[0] * w[0] + w[1] * w[1] + w[2] * w[2] }));
+
+        double jump = 0;
+        for (int d = 0; d < 3; d++)
+            jump += (gradients[3 * first.element + d] - gradients[3 * second.element + d]) * normal[d];
+        jump *= k / twice_area;
+
+        double contribution = 0.5 * hF * 0.5 * twice_area * jump * jump / k;
+        (*indicators)[first.element] += contribution;
+        (*indicators)[second.element] += contribution;
+        i++;
+    }
+    return energy;
+}
+
+/*
+  Marcado de Dorfler: se eligen los elementos de mayor indicador hasta que
+  su suma cubre la fraccion theta del error estimado total.
+ */
+std::vector<int> mark_elements(const std::vector<double>& indicators, float theta) {
+    std::vector<int> order(indicators.size());
+    for (size_t e = 0; e < order.size(); e++) order[e] = (int)e;
+    std::sort(order.begin(), order.end(), [&indicators](int a, int b) { return indicators[a] > indicators[b]; });
+
+    double total = 0, covered = 0;
+    for (double value : indicators) total += value;
+    std::vector<int> marked;
+    for (int e : order) {
+        if (covered >= theta * total) break;
+        marked.push_back(e);
+        covered += indicators[e];
+    }
+    return marked;
+}
+
+/*
+  Refinamiento por biseccion de la arista mas larga, conforme:
+
+  1. Se marca la arista mas larga de cada elemento marcado.
+  2. Clausura: todo elemento que tiene alguna arista marcada marca tambien
+     su arista mas larga (se propaga con una lista de trabajo sobre la
+     adyacencia nodo -> elementos). Asi ninguna arista partida queda con un
+     nodo colgante y cada elemento se divide primero por su arista mayor.
+  3. Se crea un nodo en el punto medio de cada arista marcada. El valor de T
+     se interpola linealmente (promedio de los extremos). El nodo es de
+     Dirichlet solo si la arista pertenece a una cara del contorno (de un
+     solo elemento) con sus tres vertices de Dirichlet: una arista interior
+     entre dos nodos fijos, por ejemplo de una cara fija a la opuesta en una
+     capa de un elemento, no esta sobre el contorno fijo. Con la misma
+     regla, el nodo queda en las caras cargadas si la arista pertenece a
+     una de ellas, con el promedio del flujo de los extremos.
+  4. Cada elemento se biseca por su arista marcada mas larga y los hijos se
+     vuelven a bisecar mientras contengan aristas marcadas. Como la regla de
+     eleccion es la misma en todos los elementos, las caras compartidas se
+     dividen igual de ambos lados.
+
+  Al reemplazar un nodo por el punto medio en la misma posicion, los hijos
+  conservan la orientacion del elemento padre.
+ */
+void refine_tet_mesh(TetMesh* mesh, const std::vector<int>& marked_elements, std::vector<float>* T) {
+    int num_nodes = mesh->get_num_nodes();
+    int num_elements = mesh->get_num_elements();
+
+    std::vector<unsigned long long> longest(num_elements);
+    for (int e = 0; e < num_elements; e++) longest[e] = mesh->longest_edge(e);
+
+    // adyacencia nodo -> elementos
+    std::vector<int> node_start(num_nodes + 1, 0), node_elements(4 * (size_t)num_elements);
+    for (int node : mesh->tets) node_start[node + 1]++;
+    for (int i = 0; i < num_nodes; i++) node_start[i + 1] += node_start[i];
+    std::vector<int> fill(node_start.begin(), node_start.end() - 1);
+    for (int e = 0; e < num_elements; e++)
+        for (int a = 0; a < 4; a++) node_elements[fill[mesh->tets[4 * e + a]]++] = e;
+
+    std::unordered_map<unsigned long long, int> midpoint;  // arista marcada -> nodo del punto medio
+    std::vector<unsigned long long> work;
+    for (int e : marked_elements)
+        if (midpoint.emplace(longest[e], -1).second) work.push_back(longest[e]);
+    while (!work.empty()) {
+        unsigned long long key = work.back();
+        work.pop_back();
+        int a = (int)(key >> 32), b = (int)(key & 0xffffffffu);
+        for (int j = node_start[a]; j < node_start[a + 1]; j++) {
+            int e = node_elements[j];
+            const int* t = &mesh->tets[4 * e];
+            if (t[0] != b && t[1] != b && t[2] != b && t[3] != b) continue;
+            if (midpoint.emplace(longest[e], -1).second) work.push_back(longest[e]);
+        }
+    }
+
+    // aristas de las caras del contorno con sus tres vertices de Dirichlet y de las caras cargadas
+    auto face_edges = [](const std::vector<std::array<int, 3>>& faces) {
+        std::vector<unsigned long long> edges;
+        for (const std::array<int, 3>& face : faces) {
+            edges.push_back(edge_key(face[0], face[1]));
+            edges.push_back(edge_key(face[0], face[2]));
+            edges.push_back(edge_key(face[1], face[2]));
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    };
+    std::vector<unsigned long long> fixed_edges = face_edges(mesh->boundary_faces(mesh->constrained));
+    std::vector<unsigned long long> loaded_edges = face_edges(mesh->boundary_faces(mesh->loaded));
+
+    // nodos nuevos, numerados en el orden de las aristas para que el resultado no dependa del hash
+    std::vector<unsigned long long> edges;
+    edges.reserve(midpoint.size());
+    for (const auto& entry : midpoint) edges.push_back(entry.first);
+    std::sort(edges.begin(), edges.end());
+    int total_nodes = num_nodes + (int)edges.size();
+    mesh->coordinates.resize(3 * (size_t)total_nodes);
+    mesh->constrained.resize(total_nodes);
+    mesh->fixed_value.resize(total_nodes);
+    mesh->loaded.resize(total_nodes);
+    mesh->flux.resize(total_nodes);
+    T->resize(total_nodes);
+    for (size_t i = 0; i < edges.size(); i++) {
+        int a = (int)(edges[i] >> 32), b = (int)(edges[i] & 0xffffffffu);
+        int m = num_nodes + (int)i;
+        midpoint[edges[i]] = m;
+        for (int d = 0; d < 3; d++)
+            mesh->coordinates[3 * m + d] = 0.5f * (mesh->coordinates[3 * a + d] + mesh->coordinates[3 * b + d]);
+        mesh->constrained[m] = std::binary_search(fixed_edges.begin(), fixed_edges.end(), edges[i]);
+        mesh->fixed_value[m] = mesh->constrained[m] ? 0.5f * (mesh->fixed_value[a] + mesh->fixed_value[b]) : 0;
+        mesh->loaded[m] = std::binary_search(loaded_edges.begin(), loaded_edges.end(), edges[i]);
+        mesh->flux[m] = mesh->loaded[m] ? 0.5f * (mesh->flux[a] + mesh->flux[b]) : 0;
+        (*T)[m] = 0.5f * ((*T)[a] + (*T)[b]);
+    }
+
+    std::vector<int> children;
+    children.reserve(mesh->tets.size() + 8 * edges.size());
+    std::vector<std::array<int, 4>> stack;
+    for (int e = 0; e < num_elements; e++) {
+        stack.push_back({ mesh->tets[4 * e], mesh->tets[4 * e + 1], mesh->tets[4 * e + 2], mesh->tets[4 * e + 3] });
+        while (!stack.empty()) {
+            std::array<int, 4> t = stack.back();
+            stack.pop_back();
+
+            int best = -1;
+            for (int i = 0; i < 6; i++) {
+                int a = t[TET_EDGES[i][0]], b = t[TET_EDGES[i][1]];
+                if (midpoint.find(edge_key(a, b)) == midpoint.end()) continue;
+                if (best < 0 || mesh->longer(a, b, t[TET_EDGES[best][0]], t[TET_EDGES[best][1]])) best = i;
+            }
+            if (best < 0) {
+                children.insert(children.end(), t.begin(), t.end());
+                continue;
+            }
+            int m = midpoint[edge_key(t[TET_EDGES[best][0]], t[TET_EDGES[best][1]])];
+            std::array<int, 4> first = t, second = t;
+            first[TET_EDGES[best][1]] = m;
+            second[TET_EDGES[best][0]] = m;
+            stack.push_back(first);
+            stack.push_back(second);
+        }
+    }
+    mesh->tets.swap(children);
+}
+
+/*
+  Funcion que resuelve el problema con refinamiento adaptativo: resuelve,
+  estima el error por elemento, marca los elementos con mayor error y los
+  refina por biseccion, hasta que el error estimado relativo a la norma de
+  energia de la solucion baja de options.adapt_tolerance o se hacen
+  options.adapt_max_steps refinamientos; tambien se detiene (con un aviso)
+  si el error estimado crece de un paso al siguiente. Cada nueva solucion
+  parte de la anterior interpolada en la malla refinada. Solo admite
+  mallas Tet4.
+
+  Se usa PCG (con AMG, salvo que se haya pedido pcg-jacobi). Si hubo
+  refinamiento, refined recibe la malla final, que es a la que corresponde
+  T_full. Devuelve false si la malla no es Tet4, si la conductividad
+  depende de la temperatura o si el sistema de algun paso no se pudo
+  resolver o PCG no convergio.
+ */
+bool solve_problem_adaptive(Mesh* M, Vector* T_full, const SolverOptions& options, std::unique_ptr<Mesh>* refined) {
+    for (int e = 0; e < M->get_quantity(NUM_ELEMENTS); e++)
+        if (M->get_element(e)->get_type() != ELEMENT_TET4) {
+            diagnostic_stream(options.diagnostics) << "Error: adaptive refinement requires a Tet4 mesh\n";
+            return false;
+        }
+    if (!options.conductivity.empty()) {
+        diagnostic_stream(options.diagnostics) << "Error: adaptive refinement does not support a temperature-dependent conductivity (-kt)\n";
+        return false;
+    }
+
+    SolverOptions solve_options = options;
+    solve_options.verbose = false;
+    if (solve_options.solver != SOLVER_PCG_JACOBI) solve_options.solver = SOLVER_PCG_AMG;
+
+    refined->reset();
+    Mesh* current = M;
+    T_full->set_size(M->get_quantity(NUM_NODES));
+
+    if (options.verbose)
+        std::cout << "Solving with adaptive refinement (tolerance " << options.adapt_tolerance << ")...\n\n";
+    double previous = 0;
+    for (int step = 0;; step++) {
+        SolveReport report;
+        if (!solve_problem_sparse(current, T_full, solve_options, step > 0, &report)) return false;
+
+        std::vector<double> indicators;
+        double energy = compute_error_indicators(current, T_full, &indicators);
+        double estimate = 0;
+        for (double value : indicators) estimate += value;
+        double relative = energy > 0 ? std::sqrt(estimate / energy) : std::sqrt(estimate);
+
+        if (options.verbose)
+            std::cout << "\tPaso " << step << ": " << current->get_quantity(NUM_ELEMENTS) << " elementos, "
+                << current->get_quantity(NUM_NODES) << " nodos, " << report.iterations << " iteraciones de PCG, "
+                << "error estimado relativo " << relative << "\n";
+        if (relative <= options.adapt_tolerance) break;
+        if (step > 0 && relative > previous) {
+            diagnostic_stream(options.diagnostics) << "Warning: adaptive refinement stopped after " << step
+                << " steps because the estimated error grew (" << previous << " -> " << relative << ")\n";
+            break;
+        }
+        previous = relative;
+        if (step == options.adapt_max_steps) {
+            diagnostic_stream(options.diagnostics) << "Warning: adaptive refinement stopped after " << step
+                << " steps above the tolerance (estimated error " << relative << ")\n";
+            break;
+        }
+
+        TetMesh mesh;
+        extract_tet_mesh(current, &mesh);
+        std::vector<float> T(T_full->get_data(), T_full->get_data() + T_full->get_size());
+        refine_tet_mesh(&mesh, mark_elements(indicators, ADAPT_MARKING_FRACTION), &T);
+
+        std::unique_ptr<Mesh> next(new Mesh());
+        int degenerate = build_tet_mesh(mesh, next.get());
+        if (degenerate > 0)
+            diagnostic_stream(options.diagnostics) << "Warning: " << degenerate << " degenerate elements after refinement\n";
+        *refined = std::move(next);
+        current = refined->get();
+
+        T_full->set_size((int)T.size());
+        for (int i = 0; i < (int)T.size(); i++) T_full->set(T[i], i);
+    }
+    if (options.verbose) std::cout << "\n";
+    return true;
+}
+
+#endif  // SIMU_PROJEKT_ADAPTIVE_REFINEMENT_HPP
\ No newline at end of file
@@ -0,0 +1,354 @@
+#ifndef SIMU_PROJEKT_AMG_HPP
+#define SIMU_PROJEKT_AMG_HPP
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "matrix.hpp"
+#include "matrix_operations.hpp"
+#include "preconditioners.hpp"
+#include "sparse_matrix.hpp"
+#include "sparse_operations.hpp"
+#include "vector.hpp"
+
+// Suavizadores disponibles para el ciclo V
+enum amg_smoother { SMOOTHER_GAUSS_SEIDEL, SMOOTHER_CHEBYSHEV };
+
+// Datos de un nivel de la jerarquia multimalla
+struct AMGLevel {
+    SparseMatrix A;   // operador del nivel
+    SparseMatrix P;   // prolongador desde el nivel siguiente (mas grueso) a este
+    SparseMatrix R;   // restriccion, R = P^T
+    Vector inv_diag;  // inversa de la diagonal de A
+    float rho;        // estimacion del radio espectral de D^-1 A
+    Vector x, b, r;   // vectores de trabajo del ciclo V
+    Vector d;         // direccion de Chebyshev
+};
+
+/*
+  Precondicionador multimalla algebraico por agregacion suavizada (SA-AMG).
+
+  Fase de configuracion, por nivel:
+    1. grafo de conexiones fuertes: |a_ij| >= theta * sqrt(|a_ii * a_jj|)
+    2. agregacion en tres pasadas sobre ese grafo
+    3. prolongador tentativo constante por agregado, suavizado con un paso
+       de Jacobi: P = (I - omega * D^-1 * A) * P_tent, omega = 4 / (3 * rho)
+    4. operador grueso de Galerkin: A_c = P^T * A * P
+  El nivel mas grueso se resuelve con la factorizacion de Cholesky densa;
+  si no es definido positivo se repite con la diagonal desplazada
+  (FACTOR_SHIFTS) y, si aun asi falla, la configuracion devuelve false.
+
+  Fase de aplicacion: un ciclo V con Gauss-Seidel simetrico (hacia adelante
+  antes de restringir, hacia atras despues de prolongar) o con Chebyshev, de
+  modo que el precondicionador es simetrico y puede usarse con PCG.
+ */
+class AMGPreconditioner : public Preconditioner {
+private:
+    std::vector<AMGLevel*> levels;  // jerarquia, levels[0] es la malla fina
+    Matrix coarse_factor;           // factor de Cholesky denso del operador mas grueso
+    amg_smoother smoother;          // suavizador del ciclo V
+    int smoothing_steps;            // barridos (o grado de Chebyshev) por suavizado
+    float strength_threshold;       // theta del grafo de conexiones fuertes
+    int max_coarse_size;            // tamano maximo del nivel grueso
+    int max_levels;                 // cantidad maxima de niveles
+
+    // metodo para liberar la jerarquia
+    void clear() {
+        for (AMGLevel* level : levels) delete level;
+        levels.clear();
+    }
+
+    // metodo para agregar los nodos del nivel segun el grafo de conexiones fuertes
+    int aggregate(const SparseMatrix* A, std::vector<int>* agg) const {
+        int n = A->get_nrows();
+        const int* Ap = A->get_row_ptr();
+        const int* Aj = A->get_col_idx();
+        const float* Ax = A->get_values();
+
+        std::vector<float> diag(n);
+        for (int i = 0; i < n; i++) diag[i] = std::abs(A->get_diagonal(i));
+
+        // grafo de conexiones fuertes, con el mismo formato CSR que A
+        std::vector<int> Sp(n + 1, 0), Sj;
+        Sj.reserve(A->get_nnz());
+        for (int i = 0; i < n; i++) {
+            for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+                int j = Aj[k];
+                if (j != i && std::abs(Ax[k]) >= strength_threshold * std::sqrt(diag[i] * diag[j]))
+                    Sj.push_back(j);
+            }
+            Sp[i + 1] = (int)Sj.size();
+        }
+
+        agg->assign(n, -1);
+        int num_aggregates = 0;
+
+        // pasada 1: un nodo cuyo vecindario fuerte esta libre forma un agregado con el
+        for (int i = 0; i < n; i++) {
+            if ((*agg)[i] != -1) continue;
+            bool free_neighbourhood = true;
+            for (int k = Sp[i]; k < Sp[i + 1] && free_neighbourhood; k++)
+                if ((*agg)[Sj[k]] != -1) free_neighbourhood = false;
+            if (!free_neighbourhood) continue;
+            (*agg)[i] = num_aggregates;
+            for (int k = Sp[i]; k < Sp[i + 1]; k++) (*agg)[Sj[k]] = num_aggregates;
+            num_aggregates++;
+        }
+
+        // pasada 2: los nodos restantes se unen al agregado de su vecino fuerte ya agregado
+        std::vector<int> first_pass(*agg);
+        for (int i = 0; i < n; i++) {
+            if ((*agg)[i] != -1) continue;
+            for (int k = Sp[i]; k < Sp[i + 1]; k++)
+                if (first_pass[Sj[k]] != -1) {
+                    (*agg)[i] = first_pass[Sj[k]];
+                    break;
+                }
+        }
+
+        // pasada 3: lo que queda forma agregados con sus vecinos fuertes todavia libres
+        for (int i = 0; i < n; i++) {
+            if ((*agg)[i] != -1) continue;
+            (*agg)[i] = num_aggregates;
+            for (int k = Sp[i]; k < Sp[i + 1]; k++)
+                if ((*agg)[Sj[k]] == -1) (*agg)[Sj[k]] = num_aggregates;
+            num_aggregates++;
+        }
+
+        return num_aggregates;
+    }
+
+    // metodo para construir el prolongador suavizado P = (I - omega D^-1 A) P_tent; devuelve false si falla el producto
+    bool build_prolongator(AMGLevel* level, const std::vector<int>& agg, int num_aggregates) const {
+        const SparseMatrix* A = &level->A;
+        int n = A->get_nrows();
+
+        SparseMatrix P_tent;
+        P_tent.set_size(n, num_aggregates, n);
+        int* Tp = P_tent.get_row_ptr();
+        int* Tj = P_tent.get_col_idx();
+        float* Tx = P_tent.get_values();
+        for (int i = 0; i < n; i++) {
+            Tp[i] = i;
+            Tj[i] = agg[i];
+            Tx[i] = 1;
+        }
+        Tp[n] = n;
+
+        // AP contiene la columna agg[i] en cada fila i porque a_ii != 0
+        SparseMatrix* P = &level->P;
+        if (!sparse_product_matrix_by_matrix(A, &P_tent, P)) return false;
+
+        float omega = (level->rho > 0) ? 4.0f / (3.0f * level->rho) : 0;
+        const int* Pp = P->get_row_ptr();
+        const int* Pj = P->get_col_idx();
+        float* Px = P->get_values();
+        for (int i = 0; i < n; i++) {
+            float scale = -omega * level->inv_diag.get(i);
+            for (int k = Pp[i]; k < Pp[i + 1]; k++) {
+                Px[k] *= scale;
+                if (Pj[k] == agg[i]) Px[k] += 1;
+            }
+        }
+        return true;
+    }
+
+    // metodo para preparar los datos del suavizador de un nivel
+    void prepare_level(AMGLevel* level) const {
+        int n = level->A.get_nrows();
+        level->inv_diag.set_size(n);
+        for (int i = 0; i < n; i++) {
+            float d = level->A.get_diagonal(i);
+            level->inv_diag.set((d != 0) ? 1 / d : 1, i);
+        }
+        level->rho = estimate_spectral_radius(&level->A, &level->inv_diag);
+        level->x.set_size(n);
+        level->b.set_size(n);
+        level->r.set_size(n);
+        level->d.set_size(n);
+    }
+
+    // barrido de Gauss-Seidel sobre x para A x = b, hacia adelante o hacia atras
+    void gauss_seidel(AMGLevel* level, bool forward) const {
+        const SparseMatrix* A = &level->A;
+        int n = A->get_nrows();
+        const int* Ap = A->get_row_ptr();
+        const int* Aj = A->get_col_idx();
+        const float* Ax = A->get_values();
+
+        for (int step = 0; step < n; step++) {
+            int i = forward ? step : n - 1 - step;
+            float acc = level->b.get(i);
+            for (int k = Ap[i]; k < Ap[i + 1]; k++)
+                if (Aj[k] != i) acc -= Ax[k] * level->x.get(Aj[k]);
+            level->x.set(acc * level->inv_diag.get(i), i);
+        }
+    }
+
+    // metodo para calcular r = b - A x en el nivel
+    void residual(AMGLevel* level) const {
+        level->A.multiply(&level->x, &level->r);
+        int n = level->A.get_nrows();
+        for (int i = 0; i < n; i++)
+            level->r.set(level->b.get(i) - level->r.get(i), i);
+    }
+
+    // suavizado de Chebyshev sobre D^-1 A en el intervalo [rho / 30, 1.1 * rho]
+    void chebyshev(AMGLevel* level, int degree) const {
+        int n = level->A.get_nrows();
+        float lambda_max = 1.1f * level->rho, lambda_min = level->rho / 30.0f;
+        float theta = (lambda_max + lambda_min) / 2, delta = (lambda_max - lambda_min) / 2;
+        float sigma = theta / delta, rho_k = 1 / sigma;
+
+        Vector* d = &level->d;
+        residual(level);
+        for (int i = 0; i < n; i++)
+            d->set(level->inv_diag.get(i) * level->r.get(i) / theta, i);
+
+        for (int k = 0; k < degree; k++) {
+            for (int i = 0; i < n; i++) level->x.add(d->get(i), i);
+            if (k == degree - 1) break;
+            residual(level);
+            float rho_new = 1 / (2 * sigma - rho_k);
+            for (int i = 0; i < n; i++)
+                d->set(rho_new * rho_k * d->get(i) + 2 * rho_new / delta * level->inv_diag.get(i) * level->r.get(i), i);
+            rho_k = rho_new;
+        }
+    }
+
+    // metodo para suavizar el nivel antes (pre = true) o despues de la correccion gruesa
+    void smooth(AMGLevel* level, bool pre) const {
+        if (smoother == SMOOTHER_CHEBYSHEV) {
+            chebyshev(level, smoothing_steps + 1);
+            return;
+        }
+        for (int s = 0; s < smoothing_steps; s++) gauss_seidel(level, pre);
+    }
+
+    // ciclo V recursivo a partir del nivel l; x debe estar en cero al entrar
+    void vcycle(int l) {
+        AMGLevel* level = levels[l];
+        int n = level->A.get_nrows();
+
+        if (l == (int)levels.size() - 1) {
+            cholesky_solve(&coarse_factor, n, &level->b, &level->x);
+            return;
+        }
+
+        AMGLevel* coarse = levels[l + 1];
+        smooth(level, true);
+        residual(level);
+        level->R.multiply(&level->r, &coarse->b);
+        coarse->x.init();
+        vcycle(l + 1);
+
+        level->P.multiply(&coarse->x, &level->r);  // r se reutiliza para la correccion P * x_c
+        for (int i = 0; i < n; i++) level->x.add(level->r.get(i), i);
+        smooth(level, false);
+    }
+
+public:
+    // constructor con los parametros del precondicionador
+    AMGPreconditioner(amg_smoother smoother_type = SMOOTHER_GAUSS_SEIDEL, int steps = 1,
+        float theta = 0.08f, int coarse_size = 64, int num_levels = 10)
+        : smoother(smoother_type), smoothing_steps(steps), strength_threshold(theta),
+        max_coarse_size(coarse_size), max_levels(num_levels) {}
+
+    // destructor para liberar la jerarquia
+    ~AMGPreconditioner() {
+        clear();
+    }
+
+    AMGPreconditioner(const AMGPreconditioner&) = delete;
+    AMGPreconditioner& operator=(const AMGPreconditioner&) = delete;
+
+protected:
+    // fase de configuracion: construye la jerarquia a partir de la matriz ensamblada
+    bool build(const SparseMatrix* K) override {
+        clear();
+
+        AMGLevel* fine = new AMGLevel();
+        const int* Kp = K->get_row_ptr();
+        fine->A.set_size(K->get_nrows(), K->get_ncols(), K->get_nnz());
+        for (int i = 0; i <= K->get_nrows(); i++) fine->A.get_row_ptr()[i] = Kp[i];
+        for (int k = 0; k < K->get_nnz(); k++) {
+            fine->A.get_col_idx()[k] = K->get_col_idx()[k];
+            fine->A.get_values()[k] = K->get_values()[k];
+        }
+        prepare_level(fine);
+        levels.push_back(fine);
+
+        std::vector<int> agg;
+        while ((int)levels.size() < max_levels && levels.back()->A.get_nrows() > max_coarse_size) {
+            AMGLevel* level = levels.back();
+            int num_aggregates = aggregate(&level->A, &agg);
+            if (num_aggregates >= level->A.get_nrows()) break;  // la agregacion ya no reduce el problema
+
+            // si un producto falla, el nivel actual queda como el mas grueso
+            if (!build_prolongator(level, agg, num_aggregates)) break;
+            sparse_transpose(&level->P, &level->R);
+
+            AMGLevel* coarse = new AMGLevel();
+            if (!galerkin_product(&level->A, &level->P, &coarse->A)) {
+                delete coarse;
+                break;
+            }
+            prepare_level(coarse);
+            levels.push_back(coarse);
+        }
+
+        // nivel mas grueso: factorizacion de Cholesky densa, con la diagonal multiplicada por (1 + shift) ante una ruptura
+        AMGLevel* coarsest = levels.back();
+        int nc = coarsest->A.get_nrows();
+        Matrix& dense = coarse_factor;
+        dense.set_size(nc, nc);
+        const int* Cp = coarsest->A.get_row_ptr();
+        const int* Cj = coarsest->A.get_col_idx();
+        const float* Cx = coarsest->A.get_values();
+        for (float shift : FACTOR_SHIFTS) {
+            dense.init();
+            for (int r = 0; r < nc; r++)
+                for (int k = Cp[r]; k < Cp[r + 1]; k++) dense.set(Cj[k] == r ? Cx[k] * (1 + shift) : Cx[k], r, Cj[k]);
+            if (!cholesky_factor(&dense, nc)) continue;
+            if (shift > 0)
+                diagnostic_stream(diagnostics) << "Warning: coarsest AMG matrix is not positive definite (diagonal shifted by "
+                    << shift << ")\n";
+            return true;
+        }
+        diagnostic_stream(diagnostics) << "Error: coarsest AMG matrix is not positive definite\n";
+        return false;
+    }
+
+    // fase de aplicacion: z = M^-1 r con un ciclo V
+    void solve(const Vector* r, Vector* z) override {
+        AMGLevel* fine = levels[0];
+        int n = fine->A.get_nrows();
+        for (int i = 0; i < n; i++) fine->b.set(r->get(i), i);
+        fine->x.init();
+        vcycle(0);
+        for (int i = 0; i < n; i++) z->set(fine->x.get(i), i);
+    }
+
+public:
+    const char* get_name() const override { return "amg"; }
+
+    // metodo para obtener la cantidad de niveles de la jerarquia
+    int get_num_levels() const {
+        return (int)levels.size();
+    }
+
+    // metodo para mostrar la jerarquia y la complejidad del operador
+    void report() const override {
+        long long total_nnz = 0;
+        for (size_t l = 0; l < levels.size(); l++) {
+            std::cout << "\t\tLevel " << l << ": " << levels[l]->A.get_nrows() << " rows, "
+                << levels[l]->A.get_nnz() << " nonzeros\n";
+            total_nnz += levels[l]->A.get_nnz();
+        }
+        if (!levels.empty() && levels[0]->A.get_nnz() > 0)
+            std::cout << "\t\tOperator complexity: " << (double)total_nnz / levels[0]->A.get_nnz() << "\n\n";
+    }
+};
+
+#endif //SIMU_PROJEKT_AMG_HPP
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef SIMU_PROJEKT_ARENA_HPP
+#define SIMU_PROJEKT_ARENA_HPP
+
+#include <cstdlib> // for malloc and free
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Typed pool: a single contiguous block holding up to "capacity" objects of type T.
+// Objects are constructed in place one after the other and are never freed individually;
+// the whole block is released at once, so T must be trivially destructible.
+template <class T>
+class Pool {
+    static_assert(std::is_trivially_destructible<T>::value, "Pool objects are released without calling destructors");
+
+private:
+    T* storage;    // contiguous block for the objects
+    int capacity;  // number of objects the block can hold
+    int used;      // number of objects already constructed
+
+public:
+    // default constructor
+    Pool() : storage(nullptr), capacity(0), used(0) {}
+
+    // destructor to free the block
+    ~Pool() {
+        release();
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // method to allocate the block for a given number of objects, discarding any previous one
+    void reserve(int num_objects) {
+        release();
+        capacity = num_objects;
+        if (capacity > 0)
+            storage = (T*)malloc(sizeof(T) * capacity);
+    }
+
+    // method to construct the next object in the block; returns nullptr when the pool is full
+    template <class... Args>
+    T* create(Args&&... args) {
+        if (used >= capacity) return nullptr;
+        return new (storage + used++) T(std::forward<Args>(args)...);
+    }
+
+    // method to release every object in O(1)
+    void release() {
+        if (storage != nullptr) free(storage);
+        storage = nullptr;
+        capacity = 0;
+        used = 0;
+    }
+
+    // method to get the number of objects constructed
+    int get_used() const {
+        return used;
+    }
+
+    // method to get the object stored at a given position
+    T* get(int position) const {
+        return storage + position;
+    }
+};
+
+#endif //SIMU_PROJEKT_ARENA_HPP
\ No newline at end of file
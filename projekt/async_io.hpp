@@ -0,0 +1,218 @@
+#ifndef SIMU_PROJEKT_ASYNC_IO_HPP
+#define SIMU_PROJEKT_ASYNC_IO_HPP
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "thread_pool.hpp"
+
+/*
+  Lector de archivos con doble buffer: un hilo de fondo llena bloques de
+  BLOCK_SIZE bytes mientras el hilo que interpreta el archivo consume el
+  bloque anterior. Los buffers circulan entre dos colas acotadas (vacios y
+  llenos), de modo que nunca hay mas de NUM_BUFFERS bloques en memoria y la
+  lectura del disco queda oculta detras del analisis del texto.
+
+  La interfaz imita a la de std::ifstream para tokens (read_token, read_int,
+  read_float) y lineas (read_line): una conversion fallida deja al lector en
+  estado de error, que se consulta con fail().
+ */
+class AsyncFileReader {
+private:
+    static const size_t BLOCK_SIZE = 1 << 20;  // bytes por bloque
+    static const int NUM_BUFFERS = 2;         // bloques en circulacion (doble buffer)
+
+    std::ifstream file;                       // archivo de entrada
+    std::string buffers[NUM_BUFFERS];         // memoria de los bloques
+    BoundedQueue<std::string*> empty;         // bloques listos para llenar
+    BoundedQueue<std::string*> filled;        // bloques leidos, en orden
+    std::thread worker;                       // hilo de lectura
+    std::string* current;                     // bloque que se esta consumiendo
+    size_t position;                          // proximo caracter de current
+    bool failed;                              // error de conversion o fin de archivo inesperado
+
+    // bucle del hilo de lectura
+    void read_loop() {
+        std::string* block;
+        while (empty.pop(&block)) {
+            block->resize(BLOCK_SIZE);
+            file.read(&(*block)[0], BLOCK_SIZE);
+            block->resize((size_t)file.gcount());
+            if (block->empty() || !filled.push(block)) break;
+            if (!file) break;
+        }
+        filled.close();
+    }
+
+    // metodo para devolver el bloque actual y pasar al siguiente; devuelve false al final del archivo
+    bool next_block() {
+        if (current != nullptr) empty.push(current);
+        current = nullptr;
+        position = 0;
+        return filled.pop(&current);
+    }
+
+    // metodo para obtener el proximo caracter, o EOF al final del archivo
+    int get_char() {
+        if (current == nullptr || position == current->size())
+            if (!next_block()) return EOF;
+        return (unsigned char)(*current)[position++];
+    }
+
+    // metodo para consultar el proximo caracter sin consumirlo
+    int peek_char() {
+        if (current == nullptr || position == current->size())
+            if (!next_block()) return EOF;
+        return (unsigned char)(*current)[position];
+    }
+
+public:
+    AsyncFileReader() : empty(NUM_BUFFERS), filled(NUM_BUFFERS), current(nullptr), position(0), failed(false) {}
+
+    // destructor: detiene el hilo de lectura aunque queden bloques sin consumir
+    ~AsyncFileReader() {
+        close();
+    }
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    // metodo para abrir el archivo y lanzar la lectura de fondo; devuelve false si no se puede abrir
+    bool open(const std::string& filename) {
+        file.open(filename, std::ios::binary);
+        if (!file) return false;
+        for (int i = 0; i < NUM_BUFFERS; i++) empty.push(&buffers[i]);
+        worker = std::thread([this] { read_loop(); });
+        return true;
+    }
+
+    // metodo para detener la lectura y cerrar el archivo
+    void close() {
+        empty.close();
+        filled.close();
+        if (worker.joinable()) worker.join();
+        if (file.is_open()) file.close();
+    }
+
+    // metodo para leer la proxima palabra separada por espacios; devuelve false al final del archivo
+    bool read_token(std::string* token) {
+        token->clear();
+        int c = get_char();
+        while (c != EOF && isspace(c)) c = get_char();
+        while (c != EOF && !isspace(c)) {
+            token->push_back((char)c);
+            c = peek_char();
+            if (c != EOF && !isspace(c)) position++;
+        }
+        if (token->empty()) failed = true;
+        return !token->empty();
+    }
+
+    // metodo para leer el resto de la linea actual (sin el salto de linea); devuelve false al final del archivo
+    bool read_line(std::string* line) {
+        line->clear();
+        int c = get_char();
+        if (c == EOF) {
+            failed = true;
+            return false;
+        }
+        while (c != EOF && c != '\n') {
+            if (c != '\r') line->push_back((char)c);
+            c = get_char();
+        }
+        return true;
+    }
+
+    // metodo para leer un entero
+    bool read_int(int* value) {
+        std::string token;
+        if (!read_token(&token)) return false;
+        char* end;
+        long result = strtol(token.c_str(), &end, 10);
+        if (*end != '\0') {
+            failed = true;
+            return false;
+        }
+        *value = (int)result;
+        return true;
+    }
+
+    // metodo para leer un numero real
+    bool read_float(float* value) {
+        std::string token;
+        if (!read_token(&token)) return false;
+        char* end;
+        float result = strtof(token.c_str(), &end);
+        if (*end != '\0') {
+            failed = true;
+            return false;
+        }
+        *value = result;
+        return true;
+    }
+
+    // metodo que indica si alguna lectura fallo
+    bool fail() const { return failed; }
+};
+
+/*
+  Escritor de archivos en segundo plano: el hilo que produce el texto entrega
+  bloques ya formateados a una cola acotada y un hilo de fondo los escribe en
+  el disco, de modo que el formateo de un bloque se superpone con la escritura
+  del anterior.
+ */
+class AsyncFileWriter {
+private:
+    static const int MAX_PENDING = 4;         // bloques formateados en espera
+
+    std::ofstream file;                       // archivo de salida
+    BoundedQueue<std::string> pending;        // bloques por escribir, en orden
+    std::thread worker;                       // hilo de escritura
+    bool failed;                              // error de escritura (lo modifica solo el hilo de escritura)
+
+    // bucle del hilo de escritura
+    void write_loop() {
+        std::string block;
+        while (pending.pop(&block))
+            if (!failed && !file.write(block.data(), block.size())) failed = true;
+    }
+
+public:
+    AsyncFileWriter() : pending(MAX_PENDING), failed(false) {}
+
+    // destructor: escribe lo pendiente y cierra el archivo
+    ~AsyncFileWriter() {
+        close();
+    }
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // metodo para crear el archivo y lanzar la escritura de fondo; devuelve false si no se puede crear
+    bool open(const std::string& filename) {
+        file.open(filename);
+        if (!file) return false;
+        worker = std::thread([this] { write_loop(); });
+        return true;
+    }
+
+    // metodo para encolar un bloque de texto; espera si hay demasiados bloques pendientes
+    void write(std::string block) {
+        pending.push(std::move(block));
+    }
+
+    // metodo para esperar la escritura de todos los bloques y cerrar el archivo; devuelve false si hubo errores
+    bool close() {
+        pending.close();
+        if (worker.joinable()) worker.join();
+        if (!file.is_open()) return !failed;
+        file.close();
+        return !failed && !file.fail();
+    }
+};
+
+#endif  // SIMU_PROJEKT_ASYNC_IO_HPP
\ No newline at end of file
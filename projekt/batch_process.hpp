@@ -0,0 +1,261 @@
+#ifndef SIMU_PROJEKT_BATCH_PROCESS_HPP
+#define SIMU_PROJEKT_BATCH_PROCESS_HPP
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "input_output.hpp"
+#include "mef_solver.hpp"
+#include "mesh.hpp"
+#include "mesh_reordering.hpp"
+#include "out_of_core.hpp"
+#include "solver_options.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+// Etapas por las que pasa un trabajo del lote
+enum job_stage { JOB_PENDING, JOB_READ_FAILED, JOB_SOLVE_FAILED, JOB_WRITE_FAILED, JOB_DONE };
+
+// Datos de un trabajo del lote: el modelo en memoria y sus tiempos por etapa
+struct BatchJob {
+    std::string filename;     // nombre del modelo, sin la extension .dat
+    Mesh* mesh;               // malla leida (solo existe mientras el trabajo esta en memoria)
+    Vector* T_full;           // temperaturas resultantes
+    FluxField* flux;          // gradiente y flujo de calor (nullptr si no se calculan)
+    OutputFilter* filter;     // nodos y elementos que se escriben (se arma mientras existe la malla)
+    job_stage stage;          // estado final del trabajo
+    int num_nodes;            // cantidad de nodos del modelo
+    int num_elements;         // cantidad de elementos del modelo
+    double read_seconds;      // tiempo de lectura
+    double solve_seconds;     // tiempo de solucion
+    double write_seconds;     // tiempo de escritura
+};
+
+// Metodo para leer el manifiesto: un nombre de modelo por linea, se ignoran lineas vacias y comentarios (#)
+bool read_manifest(const std::string& manifest, std::vector<std::string>* filenames) {
+    std::ifstream file(manifest);
+    if (!file) {
+        std::cerr << "Error opening manifest: " << manifest << "\n";
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        filenames->push_back(line.substr(first, last - first + 1));
+    }
+    return true;
+}
+
+// Metodo para obtener los segundos transcurridos desde un instante dado
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+  Clase que ejecuta un lote de modelos en un solo proceso. Cada trabajo pasa
+  por tres etapas (lectura, solucion, escritura) que se encolan en un pool de
+  hilos compartido; al terminar una etapa se encola la siguiente, de modo que
+  mientras el trabajo i se resuelve se puede leer el i+1 y escribir el i-1.
+  Un semaforo limita la cantidad de trabajos con malla y resultados en memoria.
+ */
+class BatchRunner {
+private:
+    std::vector<BatchJob> jobs;   // trabajos del lote, en el orden del manifiesto
+    ThreadPool pool;              // hilos compartidos por todas las etapas
+    Semaphore slots;              // trabajos permitidos en memoria a la vez
+    std::mutex print_mtx;         // serializa los mensajes de progreso
+    SolverOptions options;        // opciones de solucion comunes a todos los trabajos
+
+    // metodo para liberar la memoria de un trabajo y devolver su permiso
+    void finish_job(BatchJob* job) {
+        delete job->mesh;
+        delete job->T_full;
+        delete job->flux;
+        delete job->filter;
+        job->mesh = nullptr;
+        job->T_full = nullptr;
+        job->flux = nullptr;
+        job->filter = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(print_mtx);
+            std::cout << "\t[" << (job->stage == JOB_DONE ? "ok" : "failed") << "] " << job->filename << "\n";
+        }
+        slots.release();
+    }
+
+    // etapa 1: lectura del archivo .dat
+    void read_stage(BatchJob* job) {
+        if (options.solver == SOLVER_OUT_OF_CORE) {
+            out_of_core_stage(job);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        job->mesh = new Mesh();
+        bool ok = read_input(job->filename, job->mesh);
+        job->read_seconds = seconds_since(start);
+
+        if (!ok) {
+            job->stage = JOB_READ_FAILED;
+            finish_job(job);
+            return;
+        }
+        job->num_nodes = job->mesh->get_quantity(NUM_NODES);
+        job->num_elements = job->mesh->get_quantity(NUM_ELEMENTS);
+        pool.submit([this, job] { solve_stage(job); });
+    }
+
+    // etapa 2: proceso del MEF; la malla se libera apenas se obtienen los resultados
+    void solve_stage(BatchJob* job) {
+        auto start = std::chrono::steady_clock::now();
+        job->T_full = new Vector(job->num_nodes);
+        MeshOrdering ordering;
+        if (options.ordering != ORDER_NONE) reorder_mesh(job->mesh, options, &ordering);
+        bool ok = run_mef(job->mesh, job->T_full, options);
+        if (ok && options.compute_flux) {
+            // el flujo necesita la geometria de la malla, asi que se calcula antes de liberarla
+            job->flux = new FluxField();
+            compute_flux(job->mesh, job->T_full, job->flux, nullptr, &options.conductivity);
+        }
+        if (ok) {
+            job->filter = new OutputFilter();
+            ok = job->filter->build(options.output, job->num_nodes, job->mesh, &ordering.node_order);
+        }
+        if (ok) restore_node_order(ordering, job->T_full, job->flux);
+        delete job->mesh;
+        job->mesh = nullptr;
+        job->solve_seconds = seconds_since(start);
+
+        if (!ok) {
+            job->stage = JOB_SOLVE_FAILED;
+            finish_job(job);
+            return;
+        }
+        pool.submit([this, job] { write_stage(job); });
+    }
+
+    // etapas 1 y 2 fuera de memoria: los elementos se leen durante el ensamblaje, asi que todo cuenta como solucion
+    void out_of_core_stage(BatchJob* job) {
+        auto start = std::chrono::steady_clock::now();
+        job->T_full = new Vector();
+        bool ok = solve_problem_out_of_core(job->filename, job->T_full, options);
+        if (ok) {
+            job->filter = new OutputFilter();
+            ok = job->filter->build(options.output, job->T_full->get_size());
+        }
+        job->solve_seconds = seconds_since(start);
+
+        if (!ok) {
+            job->stage = JOB_SOLVE_FAILED;
+            finish_job(job);
+            return;
+        }
+        job->num_nodes = job->T_full->get_size();
+        pool.submit([this, job] { write_stage(job); });
+    }
+
+    // etapa 3: escritura del archivo .post.res
+    void write_stage(BatchJob* job) {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = write_output(job->filename, job->T_full, false, job->flux, job->filter);
+        job->write_seconds = seconds_since(start);
+        job->stage = ok ? JOB_DONE : JOB_WRITE_FAILED;
+        finish_job(job);
+    }
+
+public:
+    // constructor que recibe los modelos, la cantidad de hilos, el maximo de trabajos en memoria y las opciones de solucion
+    BatchRunner(const std::vector<std::string>& filenames, int num_threads, int max_jobs_in_memory,
+        const SolverOptions& solver_options)
+        : pool(num_threads), slots(max_jobs_in_memory < 1 ? 1 : max_jobs_in_memory), options(solver_options) {
+        options.verbose = false;  // los mensajes de varios trabajos simultaneos se mezclarian
+        options.num_threads = 1;  // el paralelismo viene de resolver varios trabajos a la vez
+        options.pool = nullptr;
+        for (const std::string& name : filenames)
+            jobs.push_back(BatchJob{ name, nullptr, nullptr, nullptr, nullptr, JOB_PENDING, 0, 0, 0, 0, 0 });
+    }
+
+    // metodo que ejecuta todo el lote y bloquea hasta que termine
+    void run() {
+        for (size_t i = 0; i < jobs.size(); i++) {
+            slots.acquire();  // espera a que haya espacio en memoria para otro trabajo
+            BatchJob* job = &jobs[i];
+            pool.submit([this, job] { read_stage(job); });
+        }
+        pool.wait_idle();
+    }
+
+    // metodo para mostrar el resumen del lote
+    void report(double wall_seconds) const {
+        int succeeded = 0;
+        double read_total = 0, solve_total = 0, write_total = 0;
+
+        std::cout << "\nBatch Summary\n**********************\n";
+        std::cout << std::left << std::setw(32) << "Model" << std::right
+            << std::setw(10) << "Nodes" << std::setw(10) << "Elements"
+            << std::setw(10) << "Read[s]" << std::setw(10) << "Solve[s]"
+            << std::setw(10) << "Write[s]" << "  Status\n";
+
+        for (const BatchJob& job : jobs) {
+            const char* status = "pending";
+            switch (job.stage) {
+            case JOB_DONE: status = "ok"; succeeded++; break;
+            case JOB_READ_FAILED: status = "read error"; break;
+            case JOB_SOLVE_FAILED: status = "solve error"; break;
+            case JOB_WRITE_FAILED: status = "write error"; break;
+            default: break;
+            }
+            read_total += job.read_seconds;
+            solve_total += job.solve_seconds;
+            write_total += job.write_seconds;
+
+            std::cout << std::left << std::setw(32) << job.filename << std::right
+                << std::setw(10) << job.num_nodes << std::setw(10) << job.num_elements
+                << std::fixed << std::setprecision(3)
+                << std::setw(10) << job.read_seconds << std::setw(10) << job.solve_seconds
+                << std::setw(10) << job.write_seconds << "  " << status << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+
+        std::cout << "\nJobs: " << succeeded << " of " << jobs.size() << " completed\n";
+        std::cout << std::fixed << std::setprecision(3)
+            << "Stage time (sum over jobs): read " << read_total << " s, solve " << solve_total
+            << " s, write " << write_total << " s\n"
+            << "Wall time: " << wall_seconds << " s\n\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    // metodo que indica si todos los trabajos terminaron correctamente
+    bool all_succeeded() const {
+        for (const BatchJob& job : jobs)
+            if (job.stage != JOB_DONE) return false;
+        return true;
+    }
+};
+
+// Metodo de entrada del modo por lotes
+bool run_batch(const std::string& manifest, int num_threads, int max_jobs_in_memory,
+    const SolverOptions& options) {
+    std::vector<std::string> filenames;
+    if (!read_manifest(manifest, &filenames)) return false;
+
+    std::cout << "Running batch of " << filenames.size() << " models with " << num_threads
+        << " threads and at most " << max_jobs_in_memory << " models in memory...\n\n";
+
+    auto start = std::chrono::steady_clock::now();
+    BatchRunner runner(filenames, num_threads, max_jobs_in_memory, options);
+    runner.run();
+    runner.report(seconds_since(start));
+
+    return runner.all_succeeded();
+}
+
+#endif  // SIMU_PROJEKT_BATCH_PROCESS_HPP
\ No newline at end of file
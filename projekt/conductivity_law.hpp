@@ -0,0 +1,77 @@
+#ifndef SIMU_PROJEKT_CONDUCTIVITY_LAW_HPP
+#define SIMU_PROJEKT_CONDUCTIVITY_LAW_HPP
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "diagnostics.hpp"
+
+/*
+  Conductividad termica dependiente de la temperatura, k(T), dada por una
+  tabla de puntos (T, k) con T creciente. Entre puntos se interpola
+  linealmente y fuera de la tabla se mantiene el valor del extremo, asi que
+  la derivada es constante por tramos y nula fuera de la tabla. Una tabla
+  vacia indica conductividad constante (la del archivo .dat).
+ */
+class ConductivityLaw {
+private:
+    std::vector<float> temperature;   // temperaturas de la tabla, estrictamente crecientes
+    std::vector<float> conductivity;  // conductividad en cada temperatura (> 0)
+
+public:
+    // metodo para leer la tabla: una linea "T k" por punto; se ignoran lineas vacias y comentarios (#)
+    // los errores se escriben en errors (nullptr: se descartan)
+    bool load(const std::string& filename, std::ostream* errors = &std::cerr) {
+        std::ifstream file(filename);
+        if (!file) {
+            diagnostic_stream(errors) << "Error opening conductivity table: " << filename << "\n";
+            return false;
+        }
+
+        std::vector<float> T, k;
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+            std::istringstream values(line);
+            float t, value;
+            if (!(values >> t >> value) || !(value > 0) || (!T.empty() && !(t > T.back()))) {
+                diagnostic_stream(errors) << "Error: invalid conductivity table " << filename << " (expected lines \"T k\" with increasing T and k > 0)\n";
+                return false;
+            }
+            T.push_back(t);
+            k.push_back(value);
+        }
+        if (T.empty()) {
+            diagnostic_stream(errors) << "Error: empty conductivity table " << filename << "\n";
+            return false;
+        }
+        temperature.swap(T);
+        conductivity.swap(k);
+        return true;
+    }
+
+    // metodo para saber si no hay tabla (conductividad constante)
+    bool empty() const { return temperature.empty(); }
+
+    // metodo para obtener la cantidad de puntos de la tabla
+    int get_num_points() const { return (int)temperature.size(); }
+
+    // metodo para evaluar k(T); si derivative no es nullptr recibe dk/dT
+    float evaluate(float T, float* derivative = nullptr) const {
+        size_t upper = std::upper_bound(temperature.begin(), temperature.end(), T) - temperature.begin();
+        if (upper == 0 || upper == temperature.size()) {
+            if (derivative != nullptr) *derivative = 0;
+            return upper == 0 ? conductivity.front() : conductivity.back();
+        }
+        float slope = (conductivity[upper] - conductivity[upper - 1]) / (temperature[upper] - temperature[upper - 1]);
+        if (derivative != nullptr) *derivative = slope;
+        return conductivity[upper - 1] + slope * (T - temperature[upper - 1]);
+    }
+};
+
+#endif  // SIMU_PROJEKT_CONDUCTIVITY_LAW_HPP
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef SIMU_PROJEKT_DIAGNOSTICS_HPP
+#define SIMU_PROJEKT_DIAGNOSTICS_HPP
+
+#include <ostream>
+
+/*
+  Destino de los avisos y errores de la solucion (ver
+  SolverOptions::diagnostics). La linea de comandos los escribe en
+  std::cerr; la biblioteca no muestra mensajes y pasa nullptr, en cuyo caso
+  van a un flujo sin buffer que los descarta sin darles formato. Cada hilo
+  tiene su propio flujo descartado, asi que los hilos del pool pueden
+  escribir sin carreras.
+ */
+inline std::ostream& diagnostic_stream(std::ostream* sink) {
+    static thread_local std::ostream discard(nullptr);
+    return sink != nullptr ? *sink : discard;
+}
+
+#endif  // SIMU_PROJEKT_DIAGNOSTICS_HPP
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef SIMU_PROJEKT_DOF_MAP_HPP
+#define SIMU_PROJEKT_DOF_MAP_HPP
+
+#include <vector>
+
+#include "vector.hpp"
+
+/*
+  Numeracion de grados de libertad: separa los nodos con condicion de
+  Dirichlet (restringidos) de los libres y guarda los mapas entre el vector
+  completo (un valor por nodo) y el vector reducido (un valor por grado de
+  libertad libre). Los libres se numeran en el orden de los nodos, asi que el
+  sistema reducido coincide con el que se obtiene quitando filas y columnas.
+  Todas las consultas son O(1) y no dependen del orden de las condiciones.
+ */
+class DofMap {
+private:
+    int num_free;                      // cantidad de grados de libertad libres
+    std::vector<int> free_index;       // nodo -> grado de libertad libre (-1 si esta restringido)
+    std::vector<int> free_nodes;       // grado de libertad libre -> nodo
+    std::vector<float> fixed_value;    // valor impuesto en cada nodo restringido
+
+public:
+    // constructor por defecto
+    DofMap() : num_free(0) {}
+
+    // metodo para iniciar la numeracion con todos los nodos libres
+    void init(int num_nodes) {
+        free_index.assign(num_nodes, 0);
+        fixed_value.assign(num_nodes, 0);
+        free_nodes.clear();
+        num_free = 0;
+    }
+
+    // metodo para restringir un nodo (indice base 0) con el valor dado
+    void constrain(int node, float value) {
+        free_index[node] = -1;
+        fixed_value[node] = value;
+    }
+
+    // metodo para numerar los nodos libres; se llama una vez despues de todas las restricciones
+    void number() {
+        int num_nodes = (int)free_index.size();
+        free_nodes.clear();
+        num_free = 0;
+        for (int node = 0; node < num_nodes; node++)
+            if (free_index[node] >= 0) {
+                free_index[node] = num_free++;
+                free_nodes.push_back(node);
+            }
+    }
+
+    // metodo para obtener la cantidad de nodos
+    int get_num_nodes() const { return (int)free_index.size(); }
+
+    // metodo para obtener la cantidad de grados de libertad libres
+    int get_num_free() const { return num_free; }
+
+    // metodo que indica si un nodo (base 0) tiene condicion de Dirichlet
+    bool is_constrained(int node) const { return free_index[node] < 0; }
+
+    // metodo para obtener el grado de libertad libre de un nodo (-1 si esta restringido)
+    int get_free_index(int node) const { return free_index[node]; }
+
+    // metodo para obtener el nodo de un grado de libertad libre
+    int get_free_node(int dof) const { return free_nodes[dof]; }
+
+    // metodo para obtener el valor impuesto en un nodo restringido
+    float get_fixed_value(int node) const { return fixed_value[node]; }
+
+    // metodo para copiar los valores de los nodos libres del vector completo al reducido
+    void gather(const Vector* full, Vector* reduced) const {
+        for (int dof = 0; dof < num_free; dof++)
+            reduced->set(full->get(free_nodes[dof]), dof);
+    }
+
+    // metodo para armar el vector completo a partir del reducido y los valores de Dirichlet
+    void scatter(const Vector* reduced, Vector* full) const {
+        int num_nodes = (int)free_index.size();
+        for (int node = 0; node < num_nodes; node++)
+            full->set(free_index[node] >= 0 ? reduced->get(free_index[node]) : fixed_value[node], node);
+    }
+};
+
+#endif  // SIMU_PROJEKT_DOF_MAP_HPP
\ No newline at end of file
@@ -0,0 +1,311 @@
+#ifndef SIMU_PROJEKT_DOMAIN_DECOMPOSITION_HPP
+#define SIMU_PROJEKT_DOMAIN_DECOMPOSITION_HPP
+
+#include <iostream>
+#include <vector>
+
+#include "dof_map.hpp"
+#include "matrix.hpp"
+#include "matrix_operations.hpp"
+#include "mef_process.hpp"
+#include "mesh.hpp"
+#include "partition.hpp"
+#include "skyline.hpp"
+#include "sparse_matrix.hpp"
+#include "sparse_operations.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+// Datos locales de un subdominio; solo los toca el hilo que lo procesa
+struct Subdomain {
+    std::vector<int> nodes;          // nodos libres tocados por los elementos propios
+    SparseMatrix K;                  // matriz de rigidez de Neumann de los elementos propios, numeracion local
+    Vector b;                        // vector de carga de los elementos propios (incluye el levantamiento de Dirichlet)
+    std::vector<int> overlap_nodes;  // nodos libres propios mas un anillo de solapamiento
+    SkylineCholesky A_factor;        // factor de Cholesky en perfil de R_i A R_i^T sobre overlap_nodes
+    bool factored = false;           // false si R_i A R_i^T no resulto definida positiva
+    Vector x_local, y_local;         // vectores de trabajo del producto
+    Vector r_overlap;                // vector de trabajo del precondicionador
+};
+
+/*
+  Solucionador por descomposicion de dominio.
+
+  La malla se divide con RCB en P subdominios. Cada subdominio, en un hilo
+  del pool y con datos locales, calcula las matrices de sus elementos y ensambla:
+    - su matriz de Neumann K_i (solo elementos propios), de modo que el
+      producto global es A x = sum_i R_i^T K_i R_i x y la matriz global nunca
+      se forma;
+    - la matriz de Dirichlet sobre sus nodos propios mas un anillo de
+      solapamiento, A_i = R_i A R_i^T, que se arma en CSR y se factoriza
+      con Cholesky en perfil (reordenada con RCM, ver skyline.hpp); la
+      memoria del factor es la de su envolvente y no la de una matriz densa.
+
+  El sistema reducido (sin nodos de Dirichlet) se resuelve con PCG y el
+  precondicionador de Schwarz aditivo de dos niveles
+    M^-1 = sum_i R_i^T A_i^-1 R_i + Z A_0^-1 Z^T,
+  donde Z tiene una columna constante por subdominio sobre los nodos que le
+  pertenecen (espacio grueso de Nicolaides) y A_0 = Z^T A Z.
+ */
+class DomainDecompositionSolver {
+private:
+    Mesh* M;                               // malla del problema
+    MeshPartition partition;               // division en subdominios
+    NodeElementGraph graph;                // adyacencia nodo -> elementos
+    const DofMap* dofs;                    // numeracion de grados de libertad de la malla
+    int num_free;                          // cantidad de grados de libertad libres
+    std::vector<Subdomain*> subdomains;    // datos locales de cada subdominio
+    ThreadPool* pool;                      // hilos que procesan los subdominios (nullptr: sin hilos)
+    Matrix coarse_factor;                  // factor de Cholesky de A_0
+    mutable Vector coarse_rhs;             // vector de trabajo del nivel grueso
+
+    // metodo que calcula K^e y b^e y los ensambla en la numeracion local dada (-1 = fuera del subdominio)
+    void add_element(int e, const std::vector<int>& local_index, bool with_load,
+        std::vector<int>* rows, std::vector<int>* cols, std::vector<float>* vals, Vector* b) const {
+        Matrix Ke;
+        Vector be;
+        create_local_K(&Ke, e, M, false);
+        if (with_load) create_local_b(&be, e, M, false);
+
+        int idx[MAX_ELEMENT_NODES];
+        int nn = get_element_node_indices(M, e, idx);
+        for (int a = 0; a < nn; a++) {
+            int row = local_index[idx[a]];
+            if (row < 0) continue;
+            if (with_load) b->add(be.get(a), row);
+            for (int c = 0; c < nn; c++) {
+                if (dofs->get_free_index(idx[c]) < 0) {
+                    // columna de Dirichlet: pasa al lado derecho
+                    if (with_load) b->add(-Ke.get(a, c) * dofs->get_fixed_value(idx[c]), row);
+                    continue;
+                }
+                int col = local_index[idx[c]];
+                if (col < 0) continue;
+                rows->push_back(row);
+                cols->push_back(col);
+                vals->push_back(Ke.get(a, c));
+            }
+        }
+    }
+
+    // configuracion de un subdominio; se ejecuta en un hilo del pool
+    void setup_subdomain(int p) {
+        Subdomain* sub = subdomains[p];
+        int num_nodes = M->get_quantity(NUM_NODES);
+        std::vector<int> local_index(num_nodes, -1);
+        std::vector<int> rows, cols;
+        std::vector<float> vals;
+
+        // matriz de Neumann y carga de los elementos propios
+        for (int node : partition.part_nodes[p])
+            if (dofs->get_free_index(node) >= 0) {
+                local_index[node] = (int)sub->nodes.size();
+                sub->nodes.push_back(node);
+            }
+        int n_local = (int)sub->nodes.size();
+        sub->b.set_size(n_local);
+        sub->b.init();
+        for (int e : partition.part_elements[p])
+            add_element(e, local_index, true, &rows, &cols, &vals, &sub->b);
+        sparse_from_triplets(n_local, n_local, rows, cols, vals, &sub->K);
+        for (int node : sub->nodes) local_index[node] = -1;
+
+        // subdominio extendido: nodos propios mas los nodos de sus elementos vecinos
+        for (int node = 0; node < num_nodes; node++) {
+            if (partition.node_owner[node] != p || dofs->get_free_index(node) < 0) continue;
+            for (int k = graph.start[node]; k < graph.start[node + 1]; k++) {
+                int idx[MAX_ELEMENT_NODES];
+                int nn = get_element_node_indices(M, graph.elements[k], idx);
+                for (int a = 0; a < nn; a++)
+                    if (dofs->get_free_index(idx[a]) >= 0 && local_index[idx[a]] < 0) {
+                        local_index[idx[a]] = (int)sub->overlap_nodes.size();
+                        sub->overlap_nodes.push_back(idx[a]);
+                    }
+            }
+        }
+
+        // A_i = R_i A R_i^T: todos los elementos que tocan el subdominio extendido
+        int n_overlap = (int)sub->overlap_nodes.size();
+        std::vector<char> element_used(M->get_quantity(NUM_ELEMENTS), 0);
+        rows.clear();
+        cols.clear();
+        vals.clear();
+        for (int node : sub->overlap_nodes)
+            for (int k = graph.start[node]; k < graph.start[node + 1]; k++) {
+                int e = graph.elements[k];
+                if (element_used[e]) continue;
+                element_used[e] = 1;
+                add_element(e, local_index, false, &rows, &cols, &vals, nullptr);
+            }
+
+        SparseMatrix A_local;
+        sparse_from_triplets(n_overlap, n_overlap, rows, cols, vals, &A_local);
+        sub->factored = sub->A_factor.factor(&A_local);
+
+        sub->x_local.set_size(n_local);
+        sub->y_local.set_size(n_local);
+        sub->r_overlap.set_size(n_overlap);
+    }
+
+    // metodo para construir el espacio grueso A_0 = Z^T A Z; devuelve false si no es definida positiva
+    bool setup_coarse(std::ostream* diagnostics) {
+        int P = partition.num_parts;
+        Vector z(num_free), w(num_free);
+        coarse_factor.set_size(P, P);
+        coarse_rhs.set_size(P);
+
+        std::vector<int> owner_of_free(num_free);
+        for (int node = 0; node < dofs->get_num_nodes(); node++)
+            if (dofs->get_free_index(node) >= 0) owner_of_free[dofs->get_free_index(node)] = partition.node_owner[node];
+
+        for (int j = 0; j < P; j++) {
+            for (int i = 0; i < num_free; i++) z.set(owner_of_free[i] == j ? 1.0f : 0.0f, i);
+            multiply(&z, &w);
+            for (int i = 0; i < P; i++) coarse_factor.set(0, i, j);
+            for (int i = 0; i < num_free; i++) coarse_factor.add(w.get(i), owner_of_free[i], j);
+        }
+        for (int j = 0; j < P; j++)
+            if (coarse_factor.get(j, j) <= 0) coarse_factor.set(1, j, j);  // subdominio sin nodos libres propios
+        if (!cholesky_factor(&coarse_factor, P)) {
+            diagnostic_stream(diagnostics) << "Error: coarse space matrix is not positive definite\n";
+            return false;
+        }
+        return true;
+    }
+
+public:
+    // constructor que recibe la malla, la cantidad de subdominios y los hilos que los procesan
+    DomainDecompositionSolver(Mesh* mesh, int num_parts, ThreadPool* threads)
+        : M(mesh), dofs(mesh->get_dof_map()), num_free(0), pool(threads) {
+        partition_mesh_rcb(M, num_parts, &partition);
+    }
+
+    // destructor para liberar los subdominios
+    ~DomainDecompositionSolver() {
+        for (Subdomain* sub : subdomains) delete sub;
+    }
+
+    DomainDecompositionSolver(const DomainDecompositionSolver&) = delete;
+    DomainDecompositionSolver& operator=(const DomainDecompositionSolver&) = delete;
+
+    // fase de configuracion: ensamblaje local en paralelo y espacio grueso; devuelve false si falla alguna
+    // factorizacion, con el motivo en diagnostics
+    bool setup(bool verbose, std::ostream* diagnostics) {
+        if (verbose) report_partition(&partition);
+
+        num_free = dofs->get_num_free();
+
+        build_node_element_graph(M, &graph);
+
+        for (int p = 0; p < partition.num_parts; p++) subdomains.push_back(new Subdomain());
+        run_threads(partition.num_parts, pool, [this](int p) { setup_subdomain(p); });
+        for (int p = 0; p < partition.num_parts; p++)
+            if (!subdomains[p]->factored) {
+                diagnostic_stream(diagnostics) << "Error: subdomain " << p << " matrix is not positive definite\n";
+                return false;
+            }
+
+        return setup_coarse(diagnostics);
+    }
+
+    // metodo para obtener la cantidad de grados de libertad libres
+    int get_nrows() const {
+        return num_free;
+    }
+
+    // producto y = A x, acumulando las contribuciones de los subdominios
+    void multiply(const Vector* x, Vector* y) const {
+        run_threads(partition.num_parts, pool, [this, x](int p) {
+            Subdomain* sub = subdomains[p];
+            for (size_t i = 0; i < sub->nodes.size(); i++)
+                sub->x_local.set(x->get(dofs->get_free_index(sub->nodes[i])), (int)i);
+            sub->K.multiply(&sub->x_local, &sub->y_local);
+        });
+
+        y->init();
+        for (Subdomain* sub : subdomains)
+            for (size_t i = 0; i < sub->nodes.size(); i++)
+                y->add(sub->y_local.get((int)i), dofs->get_free_index(sub->nodes[i]));
+    }
+
+    // precondicionador de Schwarz aditivo de dos niveles: z = M^-1 r
+    void apply(const Vector* r, Vector* z) {
+        // el bloque 0 es la correccion gruesa, que se resuelve mientras se resuelven los subdominios
+        int P = partition.num_parts;
+        run_threads(P + 1, pool, [this, r, P](int block) {
+            if (block == 0) {
+                coarse_rhs.init();
+                for (int node = 0; node < dofs->get_num_nodes(); node++)
+                    if (dofs->get_free_index(node) >= 0) coarse_rhs.add(r->get(dofs->get_free_index(node)), partition.node_owner[node]);
+                cholesky_solve(&coarse_factor, P, &coarse_rhs, &coarse_rhs);
+                return;
+            }
+            Subdomain* sub = subdomains[block - 1];
+            int n = (int)sub->overlap_nodes.size();
+            for (int i = 0; i < n; i++)
+                sub->r_overlap.set(r->get(dofs->get_free_index(sub->overlap_nodes[i])), i);
+            sub->A_factor.solve(&sub->r_overlap, &sub->r_overlap);
+        });
+
+        for (int node = 0; node < dofs->get_num_nodes(); node++)
+            if (dofs->get_free_index(node) >= 0) z->set(coarse_rhs.get(partition.node_owner[node]), dofs->get_free_index(node));
+        for (Subdomain* sub : subdomains) {
+            int n_overlap = (int)sub->overlap_nodes.size();
+            for (int i = 0; i < n_overlap; i++)
+                z->add(sub->r_overlap.get(i), dofs->get_free_index(sub->overlap_nodes[i]));
+        }
+    }
+
+    // metodo para armar el vector de carga reducido (elementos, Neumann y levantamiento de Dirichlet)
+    void build_rhs(Vector* b) const {
+        b->set_size(num_free);
+        b->init();
+        for (Subdomain* sub : subdomains)
+            for (size_t i = 0; i < sub->nodes.size(); i++)
+                b->add(sub->b.get((int)i), dofs->get_free_index(sub->nodes[i]));
+
+        for (int c = 0; c < M->get_quantity(NUM_NEUMANN); c++) {
+            Condition* cond = M->get_neumann_condition(c);
+            int row = dofs->get_free_index(cond->get_node()->get_ID() - 1);
+            if (row >= 0) b->add(cond->get_value(), row);
+        }
+    }
+
+    // metodo para combinar la solucion reducida con los valores de Dirichlet
+    void expand(const Vector* T, Vector* T_full) const {
+        dofs->scatter(T, T_full);
+    }
+};
+
+/*
+  Funcin que ejecuta el proceso completo del MEF por descomposicin de
+  dominio: los subdominios se ensamblan en los hilos de options.pool y el
+  sistema se resuelve con PCG y el precondicionador de Schwarz aditivo.
+  Las iteraciones y el residuo quedan en report. Devuelve false si alguna
+  factorizacin local o la del espacio grueso falla, o si PCG no converge
+  (en ese caso T_full recibe la ltima iteracin).
+ */
+bool solve_problem_domain_decomposition(Mesh* M, Vector* T_full, const SolverOptions& options,
+    SolveReport* report = nullptr) {
+    if (options.verbose) std::cout << "Partitioning mesh and assembling subdomains...\n\n";
+    DomainDecompositionSolver dd(M, options.num_parts, options.pool);
+    if (!dd.setup(options.verbose, options.diagnostics)) return false;
+
+    Vector b, T;
+    dd.build_rhs(&b);
+    T.set_size(b.get_size());
+    T.init();
+
+    if (options.verbose) std::cout << "Solving global system...\n\n";
+    double residual;
+    int iterations = pcg_solve(&dd, &b, &T, &dd, options.tolerance, options.max_iterations, &residual);
+    if (options.verbose)
+        std::cout << "\tPCG + Schwarz: " << iterations << " iteraciones, residuo relativo " << residual << "\n\n";
+    bool converged = check_convergence(iterations, residual, options, report);
+
+    if (options.verbose) std::cout << "Preparing results...\n\n";
+    dd.expand(&T, T_full);
+    return converged;
+}
+
+#endif  // SIMU_PROJEKT_DOMAIN_DECOMPOSITION_HPP
\ No newline at end of file
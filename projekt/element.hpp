@@ -1,25 +1,31 @@
 #ifndef SIMU_PROJEKT_ELEMENT_HPP
 #define SIMU_PROJEKT_ELEMENT_HPP
 
+#include "element_traits.hpp"
 #include "node.hpp"
 
 // definicion de la clase Element que representa un elemento de la malla
 class Element {
 private:
-    int ID;     // identificador del elemento
-    Node* node1;  // primer nodo del elemento
-    Node* node2;  // segundo nodo del elemento
-    Node* node3;  // tercer nodo del elemento
-    Node* node4;  // cuarto nodo del elemento
+    int ID;                            // identificador del elemento
+    element_type type;                 // familia del elemento (Tet4, Tet10, Hex8)
+    int num_nodes;                     // cantidad de nodos del elemento
+    Node* nodes[MAX_ELEMENT_NODES];    // nodos del elemento, en el orden de la familia
 
 public:  // metodos publicos
-    // constructor que inicializa el elemento con un identificador y tres nodos
-    Element(int identifier, Node* first_node, Node* second_node, Node* third_node, Node* fourth_node) {
-        ID = identifier;
-        node1 = first_node;
-        node2 = second_node;
-        node3 = third_node;
-        node4 = fourth_node;
+    // constructor que inicializa un tetraedro lineal con un identificador y cuatro nodos
+    Element(int identifier, Node* first_node, Node* second_node, Node* third_node, Node* fourth_node)
+        : ID(identifier), type(ELEMENT_TET4), num_nodes(4), nodes() {
+        nodes[0] = first_node;
+        nodes[1] = second_node;
+        nodes[2] = third_node;
+        nodes[3] = fourth_node;
+    }
+
+    // constructor que inicializa un elemento de cualquier familia con sus nodos
+    Element(int identifier, element_type element_family, Node* const* element_nodes)
+        : ID(identifier), type(element_family), num_nodes(element_num_nodes(element_family)), nodes() {
+        for (int a = 0; a < num_nodes; a++) nodes[a] = element_nodes[a];
     }
 
     // metodo para establecer el identificador del elemento
@@ -28,29 +34,41 @@ public:  // metodos publicos
     // metodo para obtener el identificador del elemento
     int get_ID() { return ID; }
 
+    // metodo para obtener la familia del elemento
+    element_type get_type() const { return type; }
+
+    // metodo para obtener la cantidad de nodos del elemento
+    int get_num_nodes() const { return num_nodes; }
+
+    // metodo para establecer el nodo a (base 0) del elemento
+    void set_node(int a, Node* node) { nodes[a] = node; }
+
+    // metodo para obtener el nodo a (base 0) del elemento
+    Node* get_node(int a) { return nodes[a]; }
+
     // metodo para establecer el primer nodo del elemento
-    void set_node1(Node* node) { node1 = node; }
+    void set_node1(Node* node) { nodes[0] = node; }
 
     // metodo para obtener el primer nodo del elemento
-    Node* get_node1() { return node1; }
+    Node* get_node1() { return nodes[0]; }
 
     // metodo para establecer el segundo nodo del elemento
-    void set_node2(Node* node) { node2 = node; }
+    void set_node2(Node* node) { nodes[1] = node; }
 
     // metodo para obtener el segundo nodo del elemento
-    Node* get_node2() { return node2; }
+    Node* get_node2() { return nodes[1]; }
 
     // metodo para establecer el tercer nodo del elemento
-    void set_node3(Node* node) { node3 = node; }
+    void set_node3(Node* node) { nodes[2] = node; }
 
     // metodo para obtener el tercer nodo del elemento
-    Node* get_node3() { return node3; }
+    Node* get_node3() { return nodes[2]; }
 
     // metodo para establecer el cuarto nodo del elemento
-    void set_node4(Node* node) { node4 = node; }
+    void set_node4(Node* node) { nodes[3] = node; }
 
     // metodo para obtener el cuarto nodo del elemento
-    Node* get_node4() { return node4; }
+    Node* get_node4() { return nodes[3]; }
 };
 
 #endif  // SIMU_PROJEKT_ELEMENT_HPP
\ No newline at end of file
@@ -0,0 +1,169 @@
+#ifndef SIMU_PROJEKT_ELEMENT_GEOMETRY_HPP
+#define SIMU_PROJEKT_ELEMENT_GEOMETRY_HPP
+
+#include <vector>
+
+#include "element_traits.hpp"
+#include "matrix.hpp"
+
+/*
+  Geometria precalculada de los elementos, guardada en formato SoA (un
+  arreglo por magnitud) para recorrerla de forma contigua. Admite mezclas de
+  familias: los datos de cada elemento ocupan tantos valores como nodos
+  tiene, y node_start indica donde empiezan.
+
+  Para cada elemento se guardan, por unidad de conductividad y de fuente, la
+  matriz de rigidez local y el vector de carga integrados con la cuadratura
+  de su familia (ver ElementKernel), los gradientes de las funciones de forma
+  en el centro, el volumen y el determinante del jacobiano. Asi
+
+    K^e = k * stiffness      b^e = Q * load
+
+  Un elemento con volumen nulo (relativo al tamano de sus aristas) o
+  invertido se marca como degenerado: no aporta rigidez ni carga, en lugar
+  de sustituir el volumen por un valor arbitrario.
+ */
+class ElementGeometry {
+private:
+    int num_elements;                    // cantidad de elementos
+    int num_degenerate;                  // cantidad de elementos degenerados
+    std::vector<char> type;              // familia de cada elemento
+    std::vector<int> node_start;         // inicio de los nodos de cada elemento (num_elements + 1 entradas)
+    std::vector<int> stiffness_start;    // inicio de la matriz local de cada elemento
+    std::vector<int> nodes;              // indice (base 0) de los nodos de cada elemento
+    std::vector<float> stiffness;        // matriz de rigidez local por unidad de k (fila mayor)
+    std::vector<float> load;             // vector de carga local por unidad de Q
+    std::vector<float> gradients;        // gradientes en el centro, tres valores por nodo
+    std::vector<float> jacobian;         // determinante del jacobiano en el centro (con signo)
+    std::vector<float> volume;           // volumen del elemento
+    std::vector<char> degenerate;        // 1 si el elemento es degenerado
+
+public:
+    // constructor por defecto
+    ElementGeometry() : num_elements(0), num_degenerate(0) {}
+
+    /*
+      Metodo para vaciar la geometria y reservar el espacio de num_elements
+      elementos, suponiendo que son de la familia expected. Los datos por
+      elemento de tamano fijo quedan dimensionados; los de tamano variable
+      (nodos, matriz local, carga y gradientes) solo se reservan.
+     */
+    void init(int elements, element_type expected = ELEMENT_TET4) {
+        size_t nn = element_num_nodes(expected);
+        num_elements = 0;
+        num_degenerate = 0;
+        type.assign(elements, 0);
+        node_start.assign(elements + 1, 0);
+        stiffness_start.assign(elements + 1, 0);
+        jacobian.assign(elements, 0);
+        volume.assign(elements, 0);
+        degenerate.assign(elements, 0);
+        nodes.clear();
+        stiffness.clear();
+        load.clear();
+        gradients.clear();
+        nodes.reserve(elements * nn);
+        stiffness.reserve(elements * nn * nn);
+        load.reserve(elements * nn);
+        gradients.reserve(3 * elements * nn);
+    }
+
+    /*
+      Metodo que indica si un elemento de la familia dada entra en el espacio
+      reservado. Si no entra, append() reubica los arreglos, por lo que no
+      debe haber llamadas a compute() en curso.
+     */
+    bool fits(element_type element_family) const {
+        size_t nn = element_num_nodes(element_family);
+        return nodes.size() + nn <= nodes.capacity() && stiffness.size() + nn * nn <= stiffness.capacity()
+            && gradients.size() + 3 * nn <= gradients.capacity();
+    }
+
+    // metodo para registrar la familia y los nodos del proximo elemento; devuelve su indice
+    int append(element_type element_family, const int* node_index) {
+        int e = num_elements++;
+        int nn = element_num_nodes(element_family);
+        type[e] = (char)element_family;
+        nodes.insert(nodes.end(), node_index, node_index + nn);
+        node_start[e + 1] = node_start[e] + nn;
+        stiffness_start[e + 1] = stiffness_start[e] + nn * nn;
+        stiffness.resize(stiffness_start[e + 1]);
+        load.resize(node_start[e + 1]);
+        gradients.resize(3 * node_start[e + 1]);
+        return e;
+    }
+
+    // metodo para integrar el elemento e, ya registrado; elementos distintos pueden calcularse en paralelo
+    void compute(int e, const float* x, const float* y, const float* z) {
+        bool ok = compute_element(get_type(e), x, y, z, &stiffness[stiffness_start[e]], &load[node_start[e]],
+            &gradients[3 * node_start[e]], &volume[e], &jacobian[e]);
+
+        degenerate[e] = ok ? 0 : 1;
+        if (!ok) {
+            volume[e] = 0;
+            for (int i = stiffness_start[e]; i < stiffness_start[e + 1]; i++) stiffness[i] = 0;
+            for (int i = node_start[e]; i < node_start[e + 1]; i++) load[i] = 0;
+            for (int i = 3 * node_start[e]; i < 3 * node_start[e + 1]; i++) gradients[i] = 0;
+        }
+    }
+
+    // metodo para cerrar la construccion una vez calculados todos los elementos; devuelve la cantidad de degenerados
+    int finish() {
+        num_degenerate = 0;
+        for (int e = 0; e < num_elements; e++) num_degenerate += degenerate[e];
+        return num_degenerate;
+    }
+
+    // metodo para obtener la cantidad de elementos
+    int get_num_elements() const { return num_elements; }
+
+    // metodo para obtener la cantidad de elementos degenerados
+    int get_num_degenerate() const { return num_degenerate; }
+
+    // metodo para obtener la familia del elemento e
+    element_type get_type(int e) const { return (element_type)type[e]; }
+
+    // metodo para obtener la cantidad de nodos del elemento e
+    int get_num_nodes(int e) const { return node_start[e + 1] - node_start[e]; }
+
+    // metodo para obtener el indice (base 0) del nodo a del elemento e
+    int get_node(int e, int a) const { return nodes[node_start[e] + a]; }
+
+    // metodo para obtener el gradiente en el centro de la funcion de forma a del elemento e
+    void get_gradient(int e, int a, float* g) const {
+        const float* source = &gradients[3 * (node_start[e] + a)];
+        g[0] = source[0];
+        g[1] = source[1];
+        g[2] = source[2];
+    }
+
+    // metodo para obtener el determinante del jacobiano del elemento e
+    float get_jacobian(int e) const { return jacobian[e]; }
+
+    // metodo para obtener el volumen del elemento e
+    float get_volume(int e) const { return volume[e]; }
+
+    // metodo que indica si el elemento e es degenerado
+    bool is_degenerate(int e) const { return degenerate[e] != 0; }
+
+    // metodo para obtener el termino K^e[a][b] / k del elemento e
+    float stiffness_entry(int e, int a, int b) const {
+        return stiffness[stiffness_start[e] + a * get_num_nodes(e) + b];
+    }
+
+    // metodo para calcular la matriz de rigidez local K^e con conductividad k
+    void local_stiffness(int e, float k, Matrix* K) const {
+        int nn = get_num_nodes(e);
+        const float* source = &stiffness[stiffness_start[e]];
+        for (int a = 0; a < nn; a++)
+            for (int b = 0; b < nn; b++)
+                K->set(k * source[a * nn + b], a, b);
+    }
+
+    // metodo para obtener la entrada a del vector de carga local b^e con fuente Q
+    float local_load(int e, int a, float Q) const {
+        return Q * load[node_start[e] + a];
+    }
+};
+
+#endif  // SIMU_PROJEKT_ELEMENT_GEOMETRY_HPP
\ No newline at end of file
@@ -0,0 +1,233 @@
+#ifndef SIMU_PROJEKT_ELEMENT_TRAITS_HPP
+#define SIMU_PROJEKT_ELEMENT_TRAITS_HPP
+
+#include <cmath>
+
+// Familias de elementos soportadas
+enum element_type { ELEMENT_TET4, ELEMENT_TET10, ELEMENT_HEX8 };
+
+const int MAX_ELEMENT_NODES = 10;  // nodos del elemento mas grande (Tet10)
+
+/*
+  Rasgos de cada familia de elementos: cantidad de nodos, puntos y pesos de
+  cuadratura y funciones de forma en coordenadas naturales, todo constexpr.
+  El orden de los nodos sigue la convencion de GiD:
+
+    Tet4:  vertices 1-4
+    Tet10: vertices 1-4 y nodos medios de las aristas 1-2, 2-3, 3-1, 1-4, 2-4, 3-4
+    Hex8:  cara inferior 1-4 y cara superior 5-8, en sentido antihorario
+ */
+template <element_type Type>
+struct ElementTraits;
+
+// Tetraedro lineal: gradientes constantes, un punto de cuadratura es exacto
+template <>
+struct ElementTraits<ELEMENT_TET4> {
+    static constexpr int num_nodes = 4;
+    static constexpr int num_points = 1;
+    static constexpr float points[num_points][3] = { { 0.25f, 0.25f, 0.25f } };
+    static constexpr float weights[num_points] = { 1.0f / 6 };
+    static constexpr float center[3] = { 0.25f, 0.25f, 0.25f };
+
+    // funciones de forma N y sus derivadas dN respecto de (xi, eta, zeta)
+    static constexpr void shape(const float* xi, float* N, float (*dN)[3]) {
+        N[0] = 1 - xi[0] - xi[1] - xi[2];
+        N[1] = xi[0];
+        N[2] = xi[1];
+        N[3] = xi[2];
+        float d[4][3] = { { -1, -1, -1 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+        for (int a = 0; a < 4; a++)
+            for (int k = 0; k < 3; k++) dN[a][k] = d[a][k];
+    }
+};
+
+// Tetraedro cuadratico: cuatro puntos de cuadratura (exacta para grado 2)
+template <>
+struct ElementTraits<ELEMENT_TET10> {
+    static constexpr int num_nodes = 10;
+    static constexpr int num_points = 4;
+    static constexpr float points[num_points][3] = {
+        { 0.1381966011250105f, 0.1381966011250105f, 0.1381966011250105f },
+        { 0.5854101966249685f, 0.1381966011250105f, 0.1381966011250105f },
+        { 0.1381966011250105f, 0.5854101966249685f, 0.1381966011250105f },
+        { 0.1381966011250105f, 0.1381966011250105f, 0.5854101966249685f } };
+    static constexpr float weights[num_points] = { 1.0f / 24, 1.0f / 24, 1.0f / 24, 1.0f / 24 };
+    static constexpr float center[3] = { 0.25f, 0.25f, 0.25f };
+
+    static constexpr void shape(const float* xi, float* N, float (*dN)[3]) {
+        // coordenadas baricentricas y sus derivadas
+        float L[4] = { 1 - xi[0] - xi[1] - xi[2], xi[0], xi[1], xi[2] };
+        float dL[4][3] = { { -1, -1, -1 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+        int edges[6][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 }, { 0, 3 }, { 1, 3 }, { 2, 3 } };
+
+        for (int a = 0; a < 4; a++) {  // vertices: L (2L - 1)
+            N[a] = L[a] * (2 * L[a] - 1);
+            for (int k = 0; k < 3; k++) dN[a][k] = (4 * L[a] - 1) * dL[a][k];
+        }
+        for (int m = 0; m < 6; m++) {  // nodos medios: 4 Li Lj
+            int i = edges[m][0], j = edges[m][1];
+            N[4 + m] = 4 * L[i] * L[j];
+            for (int k = 0; k < 3; k++) dN[4 + m][k] = 4 * (L[j] * dL[i][k] + L[i] * dL[j][k]);
+        }
+    }
+};
+
+// Hexaedro trilineal: cuadratura de Gauss 2 x 2 x 2
+template <>
+struct ElementTraits<ELEMENT_HEX8> {
+    static constexpr int num_nodes = 8;
+    static constexpr int num_points = 8;
+    static constexpr float g = 0.5773502691896258f;  // 1 / sqrt(3)
+    static constexpr float points[num_points][3] = {
+        { -g, -g, -g }, { g, -g, -g }, { g, g, -g }, { -g, g, -g },
+        { -g, -g, g }, { g, -g, g }, { g, g, g }, { -g, g, g } };
+    static constexpr float weights[num_points] = { 1, 1, 1, 1, 1, 1, 1, 1 };
+    static constexpr float center[3] = { 0, 0, 0 };
+
+    static constexpr void shape(const float* xi, float* N, float (*dN)[3]) {
+        float corners[8][3] = { { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+            { -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 } };
+        for (int a = 0; a < 8; a++) {
+            float u = 1 + corners[a][0] * xi[0], v = 1 + corners[a][1] * xi[1], w = 1 + corners[a][2] * xi[2];
+            N[a] = u * v * w / 8;
+            dN[a][0] = corners[a][0] * v * w / 8;
+            dN[a][1] = corners[a][1] * u * w / 8;
+            dN[a][2] = corners[a][2] * u * v / 8;
+        }
+    }
+};
+
+// Valores de las funciones de forma evaluados en tiempo de compilacion en cada punto de cuadratura y en el centro
+template <element_type Type>
+struct ReferenceTables {
+    static constexpr int NN = ElementTraits<Type>::num_nodes;
+    static constexpr int NQ = ElementTraits<Type>::num_points;
+    float N[NQ][NN];         // funciones de forma en cada punto
+    float dN[NQ][NN][3];     // derivadas en coordenadas naturales en cada punto
+    float center_N[NN];      // funciones de forma en el centro
+    float center_dN[NN][3];  // derivadas en el centro
+};
+
+template <element_type Type>
+constexpr ReferenceTables<Type> make_reference_tables() {
+    ReferenceTables<Type> tables{};
+    for (int q = 0; q < ElementTraits<Type>::num_points; q++)
+        ElementTraits<Type>::shape(ElementTraits<Type>::points[q], tables.N[q], tables.dN[q]);
+    ElementTraits<Type>::shape(ElementTraits<Type>::center, tables.center_N, tables.center_dN);
+    return tables;
+}
+
+/*
+  Nucleo local de cada familia. Todas las dimensiones son constantes de
+  compilacion, asi que los bucles sobre nodos y puntos de cuadratura se
+  desenrollan por tipo de elemento. A partir de las coordenadas de los nodos
+  calcula, por unidad de conductividad y de fuente:
+
+    K[a][b] = sum_q w_q |J_q| grad N_a . grad N_b
+    load[a] = sum_q w_q |J_q| N_a
+
+  ademas de los gradientes en el centro del elemento, el volumen y el
+  determinante del jacobiano en el centro. Devuelve false si el elemento es
+  degenerado (jacobiano nulo o de signo variable en algun punto).
+ */
+template <element_type Type>
+struct ElementKernel {
+    static constexpr int NN = ElementTraits<Type>::num_nodes;
+    static constexpr int NQ = ElementTraits<Type>::num_points;
+    static constexpr ReferenceTables<Type> tables = make_reference_tables<Type>();
+
+    // gradientes fisicos grad[a] = J^-T dN[a]; devuelve det J
+    static float physical_gradients(const float (*dN)[3], const float* x, const float* y, const float* z, float (*grad)[3]) {
+        float J[3][3] = {};  // J[i][d] = d x_i / d xi_d
+        for (int a = 0; a < NN; a++)
+            for (int d = 0; d < 3; d++) {
+                J[0][d] += dN[a][d] * x[a];
+                J[1][d] += dN[a][d] * y[a];
+                J[2][d] += dN[a][d] * z[a];
+            }
+        float det = J[0][0] * (J[1][1] * J[2][2] - J[1][2] * J[2][1])
+            - J[0][1] * (J[1][0] * J[2][2] - J[1][2] * J[2][0])
+            + J[0][2] * (J[1][0] * J[2][1] - J[1][1] * J[2][0]);
+        if (det == 0) return 0;
+
+        // inversa por cofactores: inv[d][i] = d xi_d / d x_i
+        float inv[3][3] = {
+            { (J[1][1] * J[2][2] - J[1][2] * J[2][1]) / det, (J[0][2] * J[2][1] - J[0][1] * J[2][2]) / det, (J[0][1] * J[1][2] - J[0][2] * J[1][1]) / det },
+            { (J[1][2] * J[2][0] - J[1][0] * J[2][2]) / det, (J[0][0] * J[2][2] - J[0][2] * J[2][0]) / det, (J[0][2] * J[1][0] - J[0][0] * J[1][2]) / det },
+            { (J[1][0] * J[2][1] - J[1][1] * J[2][0]) / det, (J[0][1] * J[2][0] - J[0][0] * J[2][1]) / det, (J[0][0] * J[1][1] - J[0][1] * J[1][0]) / det } };
+        for (int a = 0; a < NN; a++)
+            for (int i = 0; i < 3; i++)
+                grad[a][i] = dN[a][0] * inv[0][i] + dN[a][1] * inv[1][i] + dN[a][2] * inv[2][i];
+        return det;
+    }
+
+    static bool compute(const float* x, const float* y, const float* z, float* K, float* load,
+        float* center_gradients, float* volume, float* jacobian) {
+        // tamano del elemento para decidir si un jacobiano es despreciable
+        float h2 = 0;
+        for (int a = 0; a < NN; a++)
+            for (int b = a + 1; b < NN; b++) {
+                float dx = x[b] - x[a], dy = y[b] - y[a], dz = z[b] - z[a];
+                h2 = std::fmax(h2, dx * dx + dy * dy + dz * dz);
+            }
+        float threshold = 1e-7f * h2 * std::sqrt(h2);
+
+        for (int i = 0; i < NN * NN; i++) K[i] = 0;
+        for (int a = 0; a < NN; a++) load[a] = 0;
+        *volume = 0;
+
+        float grad[NN][3];
+        float first_sign = 0;
+        for (int q = 0; q < NQ; q++) {
+            float det = physical_gradients(tables.dN[q], x, y, z, grad);
+            if (!(std::abs(det) > threshold) || det * first_sign < 0) return false;
+            first_sign = det;
+
+            float w = ElementTraits<Type>::weights[q] * std::abs(det);
+            *volume += w;
+            for (int a = 0; a < NN; a++) {
+                load[a] += w * tables.N[q][a];
+                for (int b = a; b < NN; b++)
+                    K[a * NN + b] += w * (grad[a][0] * grad[b][0] + grad[a][1] * grad[b][1] + grad[a][2] * grad[b][2]);
+            }
+        }
+        for (int a = 0; a < NN; a++)
+            for (int b = 0; b < a; b++) K[a * NN + b] = K[b * NN + a];
+
+        *jacobian = physical_gradients(tables.center_dN, x, y, z, grad);
+        for (int a = 0; a < NN; a++)
+            for (int i = 0; i < 3; i++) center_gradients[3 * a + i] = grad[a][i];
+        return true;
+    }
+};
+
+// funcion para obtener la cantidad de nodos de un tipo de elemento
+inline int element_num_nodes(element_type type) {
+    switch (type) {
+    case ELEMENT_TET10: return ElementTraits<ELEMENT_TET10>::num_nodes;
+    case ELEMENT_HEX8: return ElementTraits<ELEMENT_HEX8>::num_nodes;
+    default: return ElementTraits<ELEMENT_TET4>::num_nodes;
+    }
+}
+
+// funcion para integrar un elemento de cualquier familia con su nucleo (ver ElementKernel::compute)
+inline bool compute_element(element_type type, const float* x, const float* y, const float* z, float* K,
+    float* load, float* center_gradients, float* volume, float* jacobian) {
+    switch (type) {
+    case ELEMENT_TET10: return ElementKernel<ELEMENT_TET10>::compute(x, y, z, K, load, center_gradients, volume, jacobian);
+    case ELEMENT_HEX8: return ElementKernel<ELEMENT_HEX8>::compute(x, y, z, K, load, center_gradients, volume, jacobian);
+    default: return ElementKernel<ELEMENT_TET4>::compute(x, y, z, K, load, center_gradients, volume, jacobian);
+    }
+}
+
+// funcion para identificar el tipo de elemento por su cantidad de nodos; devuelve false si no corresponde a ninguno
+inline bool element_type_from_num_nodes(int num_nodes, element_type* type) {
+    switch (num_nodes) {
+    case ElementTraits<ELEMENT_TET4>::num_nodes: *type = ELEMENT_TET4; return true;
+    case ElementTraits<ELEMENT_TET10>::num_nodes: *type = ELEMENT_TET10; return true;
+    case ElementTraits<ELEMENT_HEX8>::num_nodes: *type = ELEMENT_HEX8; return true;
+    default: return false;
+    }
+}
+
+#endif  // SIMU_PROJEKT_ELEMENT_TRAITS_HPP
\ No newline at end of file
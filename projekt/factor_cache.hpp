@@ -0,0 +1,120 @@
+#ifndef SIMU_PROJEKT_FACTOR_CACHE_HPP
+#define SIMU_PROJEKT_FACTOR_CACHE_HPP
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "matrix_free.hpp"
+#include "mesh.hpp"
+#include "skyline.hpp"
+#include "solver_options.hpp"
+#include "sparse_assembly.hpp"
+
+// Acumulador de la clave de factorizacion (FNV-1a de 64 bits sobre palabras de 32 bits)
+struct FactorKeyHash {
+    unsigned long long value = 14695981039346656037ULL;
+
+    void add(unsigned int word) {
+        value ^= word;
+        value *= 1099511628211ULL;
+    }
+
+    void add_float(float number) {
+        unsigned int word;
+        memcpy(&word, &number, sizeof(word));
+        add(word);
+    }
+};
+
+/*
+  Funcion para calcular la clave del sistema que se factoriza: la matriz K
+  reducida depende solo de la conectividad (familia y nodos de cada
+  elemento), de las coordenadas, de la conductividad y de cuales nodos
+  tienen condicion de Dirichlet. Los valores de Dirichlet, la fuente Q y
+  las condiciones de Neumann solo cambian el lado derecho, por lo que no
+  forman parte de la clave y un mismo factor sirve para todos ellos.
+ */
+unsigned long long factorization_key(Mesh* M) {
+    const ElementGeometry* geometry = M->get_geometry();
+    const DofMap* dofs = M->get_dof_map();
+    FactorKeyHash hash;
+
+    hash.add(SKYLINE_FILE_VERSION);
+    hash.add_float(M->get_problem_data(THERMAL_CONDUCTIVITY));
+    int num_nodes = M->get_quantity(NUM_NODES);
+    hash.add((unsigned int)num_nodes);
+    for (int i = 0; i < num_nodes; i++) {
+        Node* node = M->get_node(i);
+        hash.add_float(node->get_x_coordinate());
+        hash.add_float(node->get_y_coordinate());
+        hash.add_float(node->get_z_coordinate());
+        hash.add(dofs->is_constrained(i) ? 1u : 0u);
+    }
+    hash.add((unsigned int)geometry->get_num_elements());
+    for (int e = 0; e < geometry->get_num_elements(); e++) {
+        hash.add((unsigned int)geometry->get_type(e));
+        for (int a = 0; a < geometry->get_num_nodes(e); a++) hash.add((unsigned int)geometry->get_node(e, a));
+    }
+    return hash.value;
+}
+
+// Funcion para obtener el archivo de la cache para una clave: skyline-<clave>.factor en options.scratch_directory
+std::string factor_cache_path(unsigned long long key, const SolverOptions& options) {
+    char name[64];
+    snprintf(name, sizeof(name), "skyline-%016llx.factor", key);
+    return options.scratch_directory.empty() ? std::string(name) : options.scratch_directory + "/" + name;
+}
+
+/*
+  Funcion que resuelve el problema con Cholesky en perfil usando la cache de
+  factorizaciones: si existe un archivo con la clave de la malla, el factor
+  se proyecta en memoria y no se ensambla ni se factoriza K; en otro caso se
+  ensambla, se factoriza y se guarda el factor para las proximas
+  ejecuciones. En ambos casos el lado derecho se arma elemento por
+  elemento (ver MatrixFreeOperator::build_rhs). Devuelve false si K no es
+  simetrica definida positiva.
+ */
+bool solve_problem_skyline_cached(Mesh* M, Vector* T_full, const SolverOptions& options) {
+    bool verbose = options.verbose;
+    const DofMap* dofs = M->get_dof_map();
+    unsigned long long key = factorization_key(M);
+    std::string path = factor_cache_path(key, options);
+    SkylineCholesky cholesky;
+
+    if (cholesky.load(path, key)) {
+        if (verbose) std::cout << "Factorizacion recuperada de " << path << " (" << cholesky.get_profile_size()
+            << " entradas)\n\n";
+    }
+    else {
+        SparseMatrix K;
+        Vector assembled_b;
+        if (verbose) std::cout << "Assembling sparse global system and applying Dirichlet Boundary Conditions...\n\n";
+        if (options.assembly == ASSEMBLY_SCATTER)
+            assemble_sparse_scatter(M, &K, &assembled_b, options.pool);
+        else
+            assemble_sparse_triplets(M, &K, &assembled_b, options.pool);
+
+        if (verbose) std::cout << "\tFactorizando la matriz global K (Cholesky en perfil, RCM)...\n\n";
+        if (!cholesky.factor(&K)) {
+            diagnostic_stream(options.diagnostics) << "Error: the global matrix K is not symmetric positive definite\n";
+            return false;
+        }
+        if (!cholesky.save(path, key))
+            diagnostic_stream(options.diagnostics) << "Warning: the factorization could not be saved to " << path << "\n";
+        else if (verbose)
+            std::cout << "\tFactorizacion guardada en " << path << "\n\n";
+    }
+
+    if (verbose) std::cout << "Building right-hand side...\n\n";
+    Vector b(dofs->get_num_free()), T(dofs->get_num_free());
+    MatrixFreeOperator(M).build_rhs(M, &b);
+
+    if (verbose) std::cout << "Solving global system...\n\n";
+    cholesky.solve(&b, &T);
+    dofs->scatter(&T, T_full);
+    return true;
+}
+
+#endif  // SIMU_PROJEKT_FACTOR_CACHE_HPP
\ No newline at end of file
@@ -0,0 +1,111 @@
+#ifndef SIMU_PROJEKT_FLUX_POSTPROCESS_HPP
+#define SIMU_PROJEKT_FLUX_POSTPROCESS_HPP
+
+#include <cmath>
+#include <vector>
+
+#include "conductivity_law.hpp"
+#include "matrix_operations.hpp"
+#include "mesh.hpp"
+#include "partition.hpp"
+#include "vector.hpp"
+
+// Gradientes de temperatura y flujo de calor q = -k grad(T), por elemento y promediados en los nodos
+struct FluxField {
+    std::vector<int> element_id;          // identificador de cada elemento (el del archivo de entrada)
+    std::vector<char> element_family;     // familia de cada elemento (element_type)
+    std::vector<float> element_gradient;  // grad(T) en el centro de cada elemento (3 por elemento)
+    std::vector<float> element_flux;      // q en el centro de cada elemento (3 por elemento)
+    std::vector<float> nodal_gradient;    // promedio de grad(T) en cada nodo, ponderado por volumen (3 por nodo)
+    std::vector<float> nodal_flux;        // promedio de q en cada nodo, ponderado por volumen (3 por nodo)
+};
+
+/*
+  Funcion para calcular el flujo de calor a partir de las temperaturas
+  nodales. El gradiente de cada elemento es grad(T) = sum_a T_a grad(N_a),
+  con los gradientes de las funciones de forma en el centro que ya guarda
+  la geometria precalculada (los mismos de la matriz de rigidez). El valor
+  nodal es el promedio de los elementos que contienen al nodo, ponderado
+  por su volumen, de modo que los elementos degenerados no aportan.
+
+  Con una tabla k(T) (law no nula ni vacia) cada elemento usa k en su
+  temperatura media y el flujo nodal es el promedio de los flujos de los
+  elementos.
+
+  Ambas pasadas se reparten entre los hilos del pool sin conflictos: la de
+  elementos escribe solo en sus elementos y la de nodos recorre la
+  adyacencia nodo -> elementos y escribe solo en sus nodos. La acumulacion
+  de los gradientes es escalar: cada elemento suma pocos vectores de tres
+  componentes, tomados de nodos dispersos. Solo el producto final
+  q = -k grad(T) de cada bloque recorre un arreglo contiguo que el
+  compilador puede vectorizar.
+ */
+void compute_flux(Mesh* M, const Vector* T_full, FluxField* flux, ThreadPool* pool = nullptr, const ConductivityLaw* law = nullptr) {
+    const ElementGeometry* geometry = M->get_geometry();
+    int num_elements = geometry->get_num_elements();
+    int num_nodes = M->get_quantity(NUM_NODES);
+    float k = M->get_problem_data(THERMAL_CONDUCTIVITY);
+    const float* T = T_full->get_data();
+    if (law != nullptr && law->empty()) law = nullptr;
+
+    flux->element_id.resize(num_elements);
+    flux->element_family.resize(num_elements);
+    flux->element_gradient.assign(3 * (size_t)num_elements, 0.0f);
+    flux->element_flux.resize(3 * (size_t)num_elements);
+    flux->nodal_gradient.resize(3 * (size_t)num_nodes);
+    flux->nodal_flux.resize(3 * (size_t)num_nodes);
+
+    run_row_blocks(num_elements, pool, 1024, [&](int begin, int end) {
+        for (int e = begin; e < end; e++) {
+            flux->element_id[e] = M->get_element(e)->get_ID();
+            flux->element_family[e] = (char)geometry->get_type(e);
+            float* gradient = &flux->element_gradient[3 * (size_t)e];
+            int nn = geometry->get_num_nodes(e);
+            float mean = 0;
+            for (int a = 0; a < nn; a++) {
+                float g[3];
+                geometry->get_gradient(e, a, g);
+                float value = T[geometry->get_node(e, a)];
+                for (int d = 0; d < 3; d++) gradient[d] += value * g[d];
+                mean += value;
+            }
+            if (law != nullptr) {
+                float ke = law->evaluate(mean / nn);
+                for (int d = 0; d < 3; d++) flux->element_flux[3 * (size_t)e + d] = -ke * gradient[d];
+            }
+        }
+        if (law != nullptr) return;
+        float* gradient = &flux->element_gradient[3 * (size_t)begin];
+        float* q = &flux->element_flux[3 * (size_t)begin];
+        for (int i = 0; i < 3 * (end - begin); i++) q[i] = -k * gradient[i];
+    });
+
+    NodeElementGraph graph;
+    build_node_element_graph(M, &graph);
+    run_row_blocks(num_nodes, pool, 1024, [&](int begin, int end) {
+        for (int node = begin; node < end; node++) {
+            double sum[3] = { 0, 0, 0 }, sum_q[3] = { 0, 0, 0 }, weight = 0;
+            for (int j = graph.start[node]; j < graph.start[node + 1]; j++) {
+                int e = graph.elements[j];
+                double volume = std::fabs(geometry->get_volume(e));
+                const float* gradient = &flux->element_gradient[3 * (size_t)e];
+                const float* q = &flux->element_flux[3 * (size_t)e];
+                for (int d = 0; d < 3; d++) {
+                    sum[d] += volume * gradient[d];
+                    sum_q[d] += volume * q[d];
+                }
+                weight += volume;
+            }
+            for (int d = 0; d < 3; d++) {
+                flux->nodal_gradient[3 * (size_t)node + d] = weight > 0 ? (float)(sum[d] / weight) : 0.0f;
+                if (law != nullptr) flux->nodal_flux[3 * (size_t)node + d] = weight > 0 ? (float)(sum_q[d] / weight) : 0.0f;
+            }
+        }
+        if (law != nullptr) return;
+        float* gradient = &flux->nodal_gradient[3 * (size_t)begin];
+        float* q = &flux->nodal_flux[3 * (size_t)begin];
+        for (int i = 0; i < 3 * (end - begin); i++) q[i] = -k * gradient[i];
+    });
+}
+
+#endif  // SIMU_PROJEKT_FLUX_POSTPROCESS_HPP
\ No newline at end of file
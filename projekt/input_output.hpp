@@ -1,109 +1,382 @@
 #ifndef SIMU_PROJEKT_INPUT_OUTPUT_HPP
 #define SIMU_PROJEKT_INPUT_OUTPUT_HPP
 
-#include <fstream>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
+#include "async_io.hpp"
+#include "flux_postprocess.hpp"
 #include "mesh.hpp"
+#include "output_filter.hpp"
+#include "thread_pool.hpp"
 #include "vector.hpp"
 
-// Metodo para leer los datos de entrada desde un archivo y poblar el objeto Mesh
-void read_input(const std::string& filename, Mesh* M) {
+const int ELEMENT_CHUNK = 4096;  // elementos por tarea de calculo de geometria durante la lectura
+const int RESULT_CHUNK = 8192;   // lineas por bloque de escritura de resultados
+
+// Metodo para avanzar en el archivo hasta la etiqueta de seccion indicada (Coordinates, Elements, ...)
+bool seek_section(AsyncFileReader& dat_file, const std::string& section) {
+    std::string line;
+    while (dat_file.read_token(&line))
+        if (line == section) return true;
+    return false;
+}
+
+// Metodo para leer la proxima linea no vacia de la seccion Elements: el identificador del elemento seguido
+// de los identificadores de sus nodos. Devuelve la cantidad de enteros leidos (0 al final del archivo)
+int read_element_line(AsyncFileReader& dat_file, long* values) {
     std::string line;
+    int count = 0;
+    while (count == 0 && dat_file.read_line(&line)) {
+        const char* cursor = line.c_str();
+        char* end;
+        while (count < MAX_ELEMENT_NODES + 2) {
+            long value = strtol(cursor, &end, 10);
+            if (end == cursor) break;
+            values[count++] = value;
+            cursor = end;
+        }
+    }
+    return count;
+}
+
+/*
+  Metodo para leer los datos de entrada desde un archivo y poblar el objeto Mesh.
+  Devuelve false si el archivo no existe o si alguna seccion esta incompleta.
+
+  La lectura funciona como una cadena de etapas: un hilo de fondo lee el
+  archivo con doble buffer (AsyncFileReader), este hilo interpreta el texto y,
+  cada ELEMENT_CHUNK elementos, entrega el bloque a los hilos del pool, que
+  calculan su geometria mientras se siguen leyendo los siguientes. La
+  cantidad de bloques en vuelo esta acotada, asi que una lectura lenta no
+  acumula trabajo y un calculo lento frena a la lectura.
+ */
+bool read_input(const std::string& filename, Mesh* M, ThreadPool* pool = nullptr) {
     float k, Q, T_bar, T_hat;
     int num_nodes, num_elements, num_dirichlet, num_neumann;
-    std::ifstream dat_file(filename + ".dat");  // abrir archivo de datos en modo lectura
+    AsyncFileReader dat_file;
 
-    if (!dat_file) {
+    if (!dat_file.open(filename + ".dat")) {  // abrir archivo de datos en modo lectura
         std::cerr << "Error opening file: " << filename << ".dat\n";
-        return;
+        return false;
     }
 
     // Leer los datos desde archivo
-    dat_file >> k >> Q >> T_bar >> T_hat >> num_nodes >> num_elements >> num_dirichlet >> num_neumann;
+    if (!(dat_file.read_float(&k) && dat_file.read_float(&Q) && dat_file.read_float(&T_bar) && dat_file.read_float(&T_hat)
+        && dat_file.read_int(&num_nodes) && dat_file.read_int(&num_elements)
+        && dat_file.read_int(&num_dirichlet) && dat_file.read_int(&num_neumann))) {
+        std::cerr << "Error reading header of file: " << filename << ".dat\n";
+        return false;
+    }
 
     M->set_problem_data(k, Q);  // Establecer los datos del problema
     M->set_quantities(num_nodes, num_elements, num_dirichlet, num_neumann);  // Establecer las cantidades
     M->init_arrays();  // Inicializar los arreglos
 
-    dat_file >> line;
+    if (!seek_section(dat_file, "Coordinates")) {
+        std::cerr << "Error: Coordinates section not found in " << filename << ".dat\n";
+        return false;
+    }
 
     // Insertar nodos en el arreglo de nodos
     for (int i = 0; i < num_nodes; i++) {
-        int id;
-        float x, y, z;
-        dat_file >> id >> x >> y >> z;
-        M->insert_node(new Node(id, x, y, z), i);
+        int id = 0;
+        float x = 0, y = 0, z = 0;
+        dat_file.read_int(&id);
+        dat_file.read_float(&x);
+        dat_file.read_float(&y);
+        dat_file.read_float(&z);
+        M->insert_node(M->create_node(id, x, y, z), i);
+    }
+
+    if (!seek_section(dat_file, "Elements")) {
+        std::cerr << "Error: Elements section not found in " << filename << ".dat\n";
+        return false;
     }
 
-    dat_file >> line;
+    // Etapa de calculo: los hilos del pool integran los bloques de elementos ya
+    // leidos. Al salir (tambien por error) se espera a los bloques en vuelo
+    // antes de destruir el semaforo que usan
+    Semaphore in_flight(2 * (parallel_width(pool) - 1));
+    struct ChunkGuard {
+        ThreadPool* pool;
+        ~ChunkGuard() { if (pool) pool->wait_idle(); }
+    } chunk_guard = { pool };
+    auto submit_chunk = [M, pool, &in_flight](int first, int last) {
+        if (!pool) {
+            M->compute_geometry(first, last);
+            return;
+        }
+        in_flight.acquire();
+        pool->submit([M, &in_flight, first, last] {
+            M->compute_geometry(first, last);
+            in_flight.release();
+        });
+    };
 
-    // Insertar elementos en el arreglo de elementos
+    // Insertar elementos en el arreglo de elementos; la familia de cada uno se
+    // deduce de la cantidad de nodos de su linea (4: Tet4, 10: Tet10, 8: Hex8)
+    std::string line;
+    dat_file.read_line(&line);  // resto de la linea de la etiqueta
+    int chunk_start = 0;
     for (int i = 0; i < num_elements; i++) {
-        int id, node1_id, node2_id, node3_id, node4_id;
-        dat_file >> id >> node1_id >> node2_id >> node3_id >> node4_id;
+        long values[MAX_ELEMENT_NODES + 2];
+        int count = read_element_line(dat_file, values);
 
-        // Ensure nodes are initialized before using them
-        Node* node1 = M->get_node(node1_id - 1);
-        Node* node2 = M->get_node(node2_id - 1);
-        Node* node3 = M->get_node(node3_id - 1);
-        Node* node4 = M->get_node(node4_id - 1);
+        element_type type;
+        if (count == 0 || !element_type_from_num_nodes(count - 1, &type)) {
+            std::cerr << "Error: element line " << i + 1 << " in " << filename
+                << ".dat must have 4 (Tet4), 10 (Tet10) or 8 (Hex8) nodes\n";
+            return false;
+        }
 
-        if (node1 && node2 && node3 && node4) {
-            M->insert_element(new Element(id, node1, node2, node3, node4), i);
+        // Ensure nodes are initialized before using them
+        Node* element_nodes[MAX_ELEMENT_NODES];
+        for (int a = 0; a < count - 1; a++) {
+            element_nodes[a] = M->get_node((int)values[a + 1] - 1);
+            if (element_nodes[a] == nullptr) {
+                std::cerr << "Error: One or more nodes for element " << values[0] << " are not initialized\n";
+                return false;
+            }
         }
-        else {
-            std::cerr << "Error: One or more nodes for element " << id << " are not initialized\n";
+        M->insert_element(M->create_element((int)values[0], type, element_nodes), i);
+
+        // Registrar el elemento en la geometria; si hay que agrandar los arreglos
+        // se espera a que terminen los bloques en vuelo, que escriben en ellos
+        if (i == 0) M->begin_geometry(type);
+        if (!M->geometry_fits(i) && pool) pool->wait_idle();
+        M->register_element_geometry(i);
+        if (i + 1 - chunk_start == ELEMENT_CHUNK) {
+            submit_chunk(chunk_start, i + 1);
+            chunk_start = i + 1;
         }
     }
+    if (num_elements == 0) M->begin_geometry(ELEMENT_TET4);
+    if (chunk_start < num_elements) submit_chunk(chunk_start, num_elements);
 
-    dat_file >> line;
+    if (!seek_section(dat_file, "Dirichlet")) {
+        std::cerr << "Error: Dirichlet section not found in " << filename << ".dat\n";
+        return false;
+    }
 
     // Insertar condiciones de Dirichlet en el arreglo de condiciones de Dirichlet
     for (int i = 0; i < num_dirichlet; i++) {
-        int id;
-        dat_file >> id;
-        M->insert_dirichlet_condition(new Condition(M->get_node(id - 1), T_bar), i);
+        int id = 0;
+        dat_file.read_int(&id);
+        M->insert_dirichlet_condition(M->create_condition(M->get_node(id - 1), T_bar), i);
     }
 
-    dat_file >> line;
+    if (!seek_section(dat_file, "Neumann")) {
+        std::cerr << "Error: Neumann section not found in " << filename << ".dat\n";
+        return false;
+    }
 
     // Insertar condiciones de Neumann en el arreglo de condiciones de Neumann
     for (int i = 0; i < num_neumann; i++) {
-        int id;
-        dat_file >> id;
-        M->insert_neumann_condition(new Condition(M->get_node(id - 1), T_hat), i);
+        int id = 0;
+        dat_file.read_int(&id);
+        M->insert_neumann_condition(M->create_condition(M->get_node(id - 1), T_hat), i);
+    }
+
+    if (dat_file.fail()) {
+        std::cerr << "Error: Unexpected end of file in " << filename << ".dat\n";
+        return false;
     }
 
+    M->build_dof_map();  // Numerar los grados de libertad libres
+    if (pool) pool->wait_idle();  // Esperar la geometria de los ultimos bloques
+    int degenerate = M->end_geometry();
+    if (degenerate > 0)
+        std::cerr << "Warning: " << degenerate << " degenerate elements (zero volume) in " << filename
+        << ".dat, they will not contribute to the system\n";
+
     dat_file.close();  // Cerrar archivo
+    return true;
 }
 
-// Metodo para escribir los resultados en un archivo de salida
-void write_output(const std::string& filename, Vector* T) {
+/*
+  Metodo para escribir la malla en el formato de postproceso de GiD
+  (filename.post.msh). Se usa cuando la malla de los resultados no es la del
+  archivo de entrada (refinamiento adaptativo). GiD admite un solo tipo de
+  elemento por bloque MESH, por lo que se escribe un bloque por familia; las
+  coordenadas van en el primero.
+ */
+bool write_mesh(const std::string& filename, Mesh* M, bool verbose = true) {
+    std::string full_filename = filename + ".post.msh";
+    AsyncFileWriter msh_file;
+
+    if (!msh_file.open(full_filename)) {
+        std::cerr << "Error opening file: " << full_filename << "\n";
+        return false;
+    }
+
+    const element_type families[] = { ELEMENT_TET4, ELEMENT_TET10, ELEMENT_HEX8 };
+    const char* const names[] = { "Tet4", "Tet10", "Hex8" };
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    bool coordinates_written = false;
+    std::ostringstream block;
+
+    for (element_type family : families) {
+        int count = 0;
+        for (int e = 0; e < num_elements; e++) count += M->get_element(e)->get_type() == family;
+        if (count == 0) continue;
+
+        block << "MESH \"" << names[family] << "\" dimension 3 ElemType "
+            << (family == ELEMENT_HEX8 ? "Hexahedra" : "Tetrahedra") << " Nnode " << element_num_nodes(family) << "\n";
+        block << "Coordinates\n";
+        if (!coordinates_written) {
+            for (int i = 0; i < M->get_quantity(NUM_NODES); i++) {
+                Node* node = M->get_node(i);
+                block << i + 1 << " " << node->get_x_coordinate() << " " << node->get_y_coordinate() << " "
+                    << node->get_z_coordinate() << "\n";
+                if ((i + 1) % RESULT_CHUNK == 0) {
+                    msh_file.write(block.str());
+                    block.str("");
+                }
+            }
+            coordinates_written = true;
+        }
+        block << "End Coordinates\n";
+
+        block << "Elements\n";
+        for (int e = 0, written = 0; e < num_elements; e++) {
+            Element* element = M->get_element(e);
+            if (element->get_type() != family) continue;
+            block << element->get_ID();
+            for (int a = 0; a < element->get_num_nodes(); a++) block << " " << element->get_node(a)->get_ID();
+            block << "\n";
+            if (++written % RESULT_CHUNK == 0) {
+                msh_file.write(block.str());
+                block.str("");
+            }
+        }
+        block << "End Elements\n";
+    }
+
+    msh_file.write(block.str());
+    if (!msh_file.close()) {
+        std::cerr << "Error writing file: " << full_filename << "\n";
+        return false;
+    }
+
+    if (verbose) std::cout << "File written to: " << full_filename << "\n";
+    return true;
+}
+
+// Metodo para escribir un resultado vectorial (3 componentes por entidad); select(i) da el identificador de la
+// entidad i, o 0 si no se escribe
+template <typename Select>
+void write_vector_result(AsyncFileWriter& res_file, std::ostringstream& block, const std::string& header,
+    const std::vector<float>& values, Select select) {
+    block << header;
+    block << "Values\n";
+    for (size_t i = 0, written = 0; i < values.size() / 3; i++) {
+        int id = select(i);
+        if (id == 0) continue;
+        block << id << "     " << values[3 * i] << " " << values[3 * i + 1] << " " << values[3 * i + 2] << "\n";
+        if (++written % RESULT_CHUNK == 0) {
+            res_file.write(block.str());
+            block.str("");
+        }
+    }
+    block << "End values\n";
+}
+
+/*
+  Metodo para escribir los resultados en un archivo de salida. Si se pasa
+  flux, despues de la temperatura se escriben el gradiente y el flujo de
+  calor promediados en los nodos y, por elemento, en el centro de cada
+  elemento (un punto de Gauss por familia de elementos). Si se pasa filter
+  solo se escriben los nodos y elementos que elige, con su precision; la
+  seleccion se consulta al recorrer los resultados, asi que el tamano y el
+  tiempo de escritura son proporcionales a lo que se escribe.
+ */
+bool write_output(const std::string& filename, Vector* T, bool verbose = true, const FluxField* flux = nullptr,
+    const OutputFilter* filter = nullptr) {
     std::string full_filename = filename + ".post.res";
-    std::ofstream res_file(full_filename);  // Abrir archivo de resultados en modo escritura
+    AsyncFileWriter res_file;  // El texto se formatea aqui y un hilo de fondo lo escribe
 
-    if (!res_file) {
+    if (!res_file.open(full_filename)) {  // Abrir archivo de resultados en modo escritura
         std::cerr << "Error opening file: " << full_filename << "\n";
-        return;
+        return false;
     }
 
-    res_file << "GiD Post Results File 1.0\n";  // Escribir encabezado del archivo de resultados
+    std::ostringstream block;
+    block << "GiD Post Results File 1.0\n";  // Escribir encabezado del archivo de resultados
 
     int n = T->get_size();
+    OutputFilter everything;  // sin filtro se escribe todo
+    if (filter == nullptr) filter = &everything;
+    int selected = 0;  // entidades elegidas recorridas, para el diezmado
+
+    block << R"(Result "Temperature" "Load Case 1" )" << 1 << " Scalar OnNodes\n";
+    block << "ComponentNames \"T\"\n";  // Nombre genrico de la variable
+    block << "Values\n";
+    block.precision(filter->get_temperature_precision());
+
+    for (int i = 0, written = 0; i < n; i++) {
+        if (!filter->write_node(i, &selected)) continue;
+        block << i + 1 << "     " << T->get(i) << "\n";
+        if (++written % RESULT_CHUNK == 0) {
+            res_file.write(block.str());
+            block.str("");
+        }
+    }
+
+    block << "End values\n";
 
-    res_file << R"(Result "Temperature" "Load Case 1" )" << 1 << R"( Scalar OnNodes\n)";
-    res_file << "ComponentNames \"T\"\n";  // Nombre genrico de la variable
-    res_file << "Values\n";
+    if (flux != nullptr) {
+        block.precision(filter->get_flux_precision());
+        auto node_id = [filter, &selected](size_t i) { return filter->write_node((int)i, &selected) ? (int)i + 1 : 0; };
+        selected = 0;
+        write_vector_result(res_file, block, "Result \"Temperature Gradient\" \"Load Case 1\" 1 Vector OnNodes\n"
+            "ComponentNames \"dT/dx\" \"dT/dy\" \"dT/dz\"\n", flux->nodal_gradient, node_id);
+        selected = 0;
+        write_vector_result(res_file, block, "Result \"Heat Flux\" \"Load Case 1\" 1 Vector OnNodes\n"
+            "ComponentNames \"qx\" \"qy\" \"qz\"\n", flux->nodal_flux, node_id);
 
-    for (int i = 0; i < n; i++)
-        res_file << i + 1 << "     " << T->get(i) << "\n";
+        // resultados por elemento: un conjunto de puntos de Gauss (el centro) por cada familia presente
+        const element_type families[] = { ELEMENT_TET4, ELEMENT_TET10, ELEMENT_HEX8 };
+        const char* const names[] = { "Tet4", "Tet10", "Hex8" };
+        int present = 0;
+        for (element_type family : families)
+            present += std::count(flux->element_family.begin(), flux->element_family.end(), (char)family) > 0;
+        for (element_type family : families) {
+            auto element_id = [flux, filter, family, &selected](size_t e) {
+                if (flux->element_family[e] != (char)family) return 0;
+                return filter->write_element((int)e, &selected) ? flux->element_id[e] : 0;
+            };
+            bool any = false;  // el primer elemento elegido de la familia siempre se escribe
+            for (size_t e = 0; e < flux->element_id.size() && !any; e++)
+                any = flux->element_family[e] == (char)family && filter->keep_element((int)e);
+            if (!any) continue;
 
-    res_file << "End values\n";
-    res_file.close();  // Cerrar el archivo
+            std::string gauss = std::string(names[family]) + " center";
+            std::string suffix = present > 1 ? std::string(" ") + names[family] : std::string();
+            block << "GaussPoints \"" << gauss << "\" ElemType " << (family == ELEMENT_HEX8 ? "Hexahedra" : "Tetrahedra")
+                << "\nNumber Of Gauss Points: 1\nNatural Coordinates: Internal\nEnd GaussPoints\n";
+            selected = 0;
+            write_vector_result(res_file, block, "Result \"Element Temperature Gradient" + suffix
+                + "\" \"Load Case 1\" 1 Vector OnGaussPoints \"" + gauss + "\"\n"
+                + "ComponentNames \"dT/dx\" \"dT/dy\" \"dT/dz\"\n", flux->element_gradient, element_id);
+            selected = 0;
+            write_vector_result(res_file, block, "Result \"Element Heat Flux" + suffix
+                + "\" \"Load Case 1\" 1 Vector OnGaussPoints \"" + gauss + "\"\n"
+                + "ComponentNames \"qx\" \"qy\" \"qz\"\n", flux->element_flux, element_id);
+        }
+    }
+    res_file.write(block.str());
+    if (!res_file.close()) {  // Cerrar el archivo
+        std::cerr << "Error writing file: " << full_filename << "\n";
+        return false;
+    }
 
     // Print the location of the file
-    std::cout << "File written to: " << full_filename << "\n";
+    if (verbose) std::cout << "File written to: " << full_filename << "\n";
+    return true;
 }
 
 #endif  // SIMU_PROJEKT_INPUT_OUTPUT_HPP
\ No newline at end of file
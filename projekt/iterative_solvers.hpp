@@ -0,0 +1,180 @@
+#ifndef SIMU_PROJEKT_ITERATIVE_SOLVERS_HPP
+#define SIMU_PROJEKT_ITERATIVE_SOLVERS_HPP
+
+#include <cmath>
+
+#include "amg.hpp"
+#include "preconditioners.hpp"
+#include "sparse_matrix.hpp"
+#include "vector.hpp"
+
+// funcion para calcular el producto punto de dos vectores (acumulando en doble precision)
+double dot_product(const Vector* u, const Vector* v) {
+    double acc = 0;
+    int n = u->get_size();
+    for (int i = 0; i < n; i++) acc += (double)u->get(i) * v->get(i);
+    return acc;
+}
+
+// Precondicionador de Jacobi: z = D^-1 r
+class JacobiPreconditioner : public Preconditioner {
+private:
+    Vector inv_diag;  // inversa de la diagonal de A
+
+protected:
+    // fase de configuracion: guarda la inversa de la diagonal
+    bool build(const SparseMatrix* A) override {
+        int n = A->get_nrows();
+        inv_diag.set_size(n);
+        for (int i = 0; i < n; i++) {
+            float d = A->get_diagonal(i);
+            inv_diag.set((d != 0) ? 1 / d : 1, i);
+        }
+        return true;
+    }
+
+    // fase de aplicacion
+    void solve(const Vector* r, Vector* z) override {
+        int n = inv_diag.get_size();
+        for (int i = 0; i < n; i++) z->set(inv_diag.get(i) * r->get(i), i);
+    }
+
+public:
+    using Preconditioner::setup;
+
+    const char* get_name() const override { return "jacobi"; }
+
+    // fase de configuracion a partir de la diagonal ya calculada (operadores sin matriz)
+    void setup(const Vector* diagonal) {
+        int n = diagonal->get_size();
+        inv_diag.set_size(n);
+        for (int i = 0; i < n; i++) {
+            float d = diagonal->get(i);
+            inv_diag.set((d != 0) ? 1 / d : 1, i);
+        }
+    }
+};
+
+/*
+  Gradiente conjugado precondicionado para A x = b con A simetrica y definida
+  positiva. x entra con la aproximacion inicial y sale con la solucion.
+
+  Operator es cualquier tipo con get_nrows() y multiply(x, y) que calcule
+  y = A x (SparseMatrix o un operador distribuido); Preconditioner es
+  cualquier tipo con apply(r, z) que calcule z = M^-1 r.
+
+  Se detiene cuando ||r|| <= tolerance * ||b|| o al llegar a max_iterations.
+  Devuelve la cantidad de iteraciones realizadas; el residuo relativo final
+  queda en relative_residual.
+ */
+template <class Operator, class Preconditioner>
+int pcg_solve(const Operator* A, const Vector* b, Vector* x, Preconditioner* M,
+    float tolerance, int max_iterations, double* relative_residual) {
+    int n = A->get_nrows();
+    Vector r(n), z(n), p(n), q(n);
+
+    A->multiply(x, &q);
+    for (int i = 0; i < n; i++) r.set(b->get(i) - q.get(i), i);
+
+    double b_norm = std::sqrt(dot_product(b, b));
+    if (b_norm == 0) b_norm = 1;
+    double r_norm = std::sqrt(dot_product(&r, &r));
+    *relative_residual = r_norm / b_norm;
+    if (*relative_residual <= tolerance) return 0;
+
+    int it = 0;
+    double rz = 0;
+    while (it < max_iterations) {
+        M->apply(&r, &z);
+
+        double rz_new = dot_product(&r, &z);
+        if (it == 0)
+            for (int i = 0; i < n; i++) p.set(z.get(i), i);
+        else {
+            float beta = (float)(rz_new / rz);
+            for (int i = 0; i < n; i++) p.set(z.get(i) + beta * p.get(i), i);
+        }
+        rz = rz_new;
+
+        A->multiply(&p, &q);
+        double pq = dot_product(&p, &q);
+        if (pq <= 0) break;  // la matriz no es definida positiva en esta direccion
+        float alpha = (float)(rz / pq);
+        for (int i = 0; i < n; i++) {
+            x->add(alpha * p.get(i), i);
+            r.add(-alpha * q.get(i), i);
+        }
+        it++;
+
+        r_norm = std::sqrt(dot_product(&r, &r));
+        *relative_residual = r_norm / b_norm;
+        if (*relative_residual <= tolerance) break;
+    }
+    return it;
+}
+
+/*
+  BiCGStab precondicionado por la derecha para A x = b con A no simetrica
+  (por ejemplo, el jacobiano de Newton del problema no lineal). Recibe los
+  mismos argumentos que pcg_solve, con el mismo criterio de parada, y hace
+  dos productos y dos aplicaciones del precondicionador por iteracion.
+ */
+template <class Operator, class Preconditioner>
+int bicgstab_solve(const Operator* A, const Vector* b, Vector* x, Preconditioner* M,
+    float tolerance, int max_iterations, double* relative_residual) {
+    int n = A->get_nrows();
+    Vector r(n), r0(n), p(n), v(n), s(n), t(n), p_hat(n), s_hat(n);
+
+    A->multiply(x, &v);
+    for (int i = 0; i < n; i++) r.set(b->get(i) - v.get(i), i);
+    for (int i = 0; i < n; i++) r0.set(r.get(i), i);
+
+    double b_norm = std::sqrt(dot_product(b, b));
+    if (b_norm == 0) b_norm = 1;
+    *relative_residual = std::sqrt(dot_product(&r, &r)) / b_norm;
+    if (*relative_residual <= tolerance) return 0;
+
+    int it = 0;
+    double rho = 1, alpha = 1, omega = 1;
+    while (it < max_iterations) {
+        double rho_new = dot_product(&r0, &r);
+        if (rho_new == 0) break;  // r es ortogonal a r0: el metodo no puede continuar
+        if (it == 0)
+            for (int i = 0; i < n; i++) p.set(r.get(i), i);
+        else {
+            float beta = (float)((rho_new / rho) * (alpha / omega));
+            for (int i = 0; i < n; i++) p.set(r.get(i) + beta * (p.get(i) - (float)omega * v.get(i)), i);
+        }
+        rho = rho_new;
+
+        M->apply(&p, &p_hat);
+        A->multiply(&p_hat, &v);
+        double r0v = dot_product(&r0, &v);
+        if (r0v == 0) break;
+        alpha = rho / r0v;
+        for (int i = 0; i < n; i++) s.set(r.get(i) - (float)alpha * v.get(i), i);
+        it++;
+
+        double s_norm = std::sqrt(dot_product(&s, &s));
+        if (s_norm / b_norm <= tolerance) {
+            for (int i = 0; i < n; i++) x->add((float)alpha * p_hat.get(i), i);
+            *relative_residual = s_norm / b_norm;
+            break;
+        }
+
+        M->apply(&s, &s_hat);
+        A->multiply(&s_hat, &t);
+        double tt = dot_product(&t, &t);
+        omega = tt > 0 ? dot_product(&t, &s) / tt : 0;
+        for (int i = 0; i < n; i++) {
+            x->add((float)alpha * p_hat.get(i) + (float)omega * s_hat.get(i), i);
+            r.set(s.get(i) - (float)omega * t.get(i), i);
+        }
+
+        *relative_residual = std::sqrt(dot_product(&r, &r)) / b_norm;
+        if (*relative_residual <= tolerance || omega == 0) break;
+    }
+    return it;
+}
+
+#endif //SIMU_PROJEKT_ITERATIVE_SOLVERS_HPP
\ No newline at end of file
@@ -0,0 +1,113 @@
+#ifndef SIMU_PROJEKT_MAPPED_FILE_HPP
+#define SIMU_PROJEKT_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Archivo de solo lectura proyectado en memoria: el sistema operativo carga y descarta sus paginas segun el uso
+class MappedFile {
+private:
+    const void* data;   // inicio de la proyeccion (nullptr si no hay archivo abierto)
+    size_t size;        // bytes del archivo
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int descriptor;
+#endif
+
+public:
+#ifdef _WIN32
+    MappedFile() : data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) {}
+#else
+    MappedFile() : data(nullptr), size(0), descriptor(-1) {}
+#endif
+
+    // destructor: libera la proyeccion
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // metodo para proyectar el archivo completo; devuelve false si no se puede abrir o proyectar
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            close();
+            return false;
+        }
+        size = (size_t)file_size.QuadPart;
+        if (size == 0) return true;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            close();
+            return false;
+        }
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) return false;
+        struct stat info;
+        if (fstat(descriptor, &info) != 0) {
+            close();
+            return false;
+        }
+        size = (size_t)info.st_size;
+        if (size == 0) return true;
+        void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+        data = address == MAP_FAILED ? nullptr : address;
+#endif
+        if (data == nullptr) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // metodo para liberar la proyeccion y cerrar el archivo
+    void close() {
+#ifdef _WIN32
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr) munmap(const_cast<void*>(data), size);
+        if (descriptor >= 0) ::close(descriptor);
+        descriptor = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    // metodo para obtener el contenido del archivo
+    const void* get_data() const { return data; }
+
+    // metodo para obtener el tamano del archivo en bytes
+    size_t get_size() const { return size; }
+};
+
+#endif  // SIMU_PROJEKT_MAPPED_FILE_HPP
\ No newline at end of file
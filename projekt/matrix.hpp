@@ -3,52 +3,132 @@
 
 #include <iostream>
 #include <cstdlib> // for malloc and free
+#include <cstring> // for memmove
+
+#include "vector.hpp"
+
+// Non-owning view of a dense row-major block: row r starts at data + r * stride
+class MatrixView {
+private:
+    float* data;      // first value of the block
+    int nrows, ncols; // dimensions of the block
+    int stride;       // distance between the starts of consecutive rows
+
+public:
+    // constructor from a pointer, the dimensions and the row stride
+    MatrixView(float* values = nullptr, int rows = 0, int cols = 0, int row_stride = 0)
+        : data(values), nrows(rows), ncols(cols), stride(row_stride) {}
+
+    // method to get the number of rows in the view
+    int get_nrows() const { return nrows; }
+
+    // method to get the number of columns in the view
+    int get_ncols() const { return ncols; }
+
+    // method to get the distance between consecutive rows
+    int get_stride() const { return stride; }
+
+    // method to set the value of an element
+    void set(float value, int row, int col) const { data[row * stride + col] = value; }
+
+    // method to add a value to an element
+    void add(float value, int row, int col) const { data[row * stride + col] += value; }
+
+    // method to get the value of an element
+    float get(int row, int col) const { return data[row * stride + col]; }
+
+    // method to get direct access to the contiguous values of a row
+    float* get_row(int row) const { return data + row * stride; }
+
+    // method to set every element to zero
+    void init() const {
+        for (int r = 0; r < nrows; r++)
+            for (int c = 0; c < ncols; c++)
+                data[r * stride + c] = 0;
+    }
+
+    // method to get a view of a rows x cols sub-block starting at (row, col)
+    MatrixView block(int row, int col, int rows, int cols) const {
+        return MatrixView(data + row * stride + col, rows, cols, stride);
+    }
+
+    // method to get a view of a row
+    VectorView row(int r) const { return VectorView(data + r * stride, ncols, 1); }
+
+    // method to get a view of a column
+    VectorView column(int c) const { return VectorView(data + c, nrows, stride); }
+};
 
 class Matrix {
 private:
     int nrows, ncols; // number of rows and columns in the matrix
-    float** data;     // double pointer to store matrix data
+    int capacity;     // number of values the allocated buffer can hold
+    float* data;      // contiguous row-major storage, row r starts at data + r * ncols
 
     // method to create the matrix data structure
     void create() {
-        data = (float**)malloc(sizeof(float*) * nrows); // allocate memory for rows
-        for (int r = 0; r < nrows; r++)
-            data[r] = (float*)malloc(sizeof(float) * ncols); // allocate memory for columns
+        capacity = nrows * ncols;
+        data = (float*)malloc(sizeof(float) * (capacity > 0 ? capacity : 1)); // allocate memory for all values
     }
 
 public:
     // default constructor
-    Matrix() : nrows(0), ncols(0), data(nullptr) {}
+    Matrix() : nrows(0), ncols(0), capacity(0), data(nullptr) {}
 
     // constructor to initialize matrix with given number of rows and columns
-    Matrix(int rows, int cols) : nrows(rows), ncols(cols), data(nullptr) {
+    Matrix(int rows, int cols) : nrows(rows), ncols(cols), capacity(0), data(nullptr) {
         create(); // create the data structure
     }
 
+    // move constructor: takes the buffer of the other matrix, which is left empty
+    Matrix(Matrix&& other) noexcept : nrows(other.nrows), ncols(other.ncols), capacity(other.capacity), data(other.data) {
+        other.nrows = 0;
+        other.ncols = 0;
+        other.capacity = 0;
+        other.data = nullptr;
+    }
+
+    // move assignment: releases the current buffer and takes the one of the other matrix
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            if (data != nullptr) free(data);
+            nrows = other.nrows;
+            ncols = other.ncols;
+            capacity = other.capacity;
+            data = other.data;
+            other.nrows = 0;
+            other.ncols = 0;
+            other.capacity = 0;
+            other.data = nullptr;
+        }
+        return *this;
+    }
+
+    // copies would share the buffer and free it twice
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
+
     // destructor to free allocated memory
     ~Matrix() {
-        if (data != nullptr) {
-            for (int r = 0; r < nrows; r++)
-                if (data[r] != nullptr)
-                    free(data[r]); // free memory for each row
-            free(data); // free memory for row pointers
-        }
+        if (data != nullptr)
+            free(data);
     }
 
     // method to initialize the matrix with zeros
     void init() {
-        for (int r = 0; r < nrows; r++)
-            for (int c = 0; c < ncols; c++)
-                data[r][c] = 0; // set each element to zero
+        for (int i = 0; i < nrows * ncols; i++)
+            data[i] = 0; // set each element to zero
     }
 
-    // method to set the size of the matrix and create the data structure
+    // method to set the size of the matrix; the current buffer is reused when it is large enough
     void set_size(int rows, int cols) {
-        if (data != nullptr) {
-            for (int r = 0; r < nrows; r++)
-                free(data[r]);
-            free(data);
+        if (data != nullptr && rows * cols <= capacity) {
+            nrows = rows;
+            ncols = cols;
+            return;
         }
+        if (data != nullptr)
+            free(data);
         nrows = rows;
         ncols = cols;
         create();
@@ -66,54 +146,64 @@ public:
 
     // method to set the value of an element in the matrix
     void set(float value, int row, int col) {
-        data[row][col] = value;
+        data[row * ncols + col] = value;
     }
 
     // method to add a value to an element in the matrix
     void add(float value, int row, int col) {
-        data[row][col] += value;
+        data[row * ncols + col] += value;
     }
 
     // method to get the value of an element in the matrix
     float get(int row, int col) const {
-        return data[row][col];
+        return data[row * ncols + col];
+    }
+
+    // method to get direct access to the contiguous values of a row
+    float* get_row(int row) {
+        return data + row * ncols;
+    }
+
+    // method to get read-only access to the contiguous values of a row
+    const float* get_row(int row) const {
+        return data + row * ncols;
+    }
+
+    // method to get a view of the whole matrix
+    MatrixView view() {
+        return MatrixView(data, nrows, ncols, ncols);
+    }
+
+    // method to get a view of a rows x cols sub-block starting at (row, col)
+    MatrixView block(int row, int col, int rows, int cols) {
+        return MatrixView(data + row * ncols + col, rows, cols, ncols);
+    }
+
+    // method to get a view of a row
+    VectorView row_view(int row) {
+        return VectorView(data + row * ncols, ncols, 1);
+    }
+
+    // method to get a view of a column
+    VectorView column_view(int col) {
+        return VectorView(data + col, nrows, ncols);
     }
 
     // method to remove a row from the matrix
     void remove_row(int row) {
-        int neo_index = 0;
-        auto** neo_data = (float**)malloc(sizeof(float*) * (nrows - 1));
-        for (int i = 0; i < nrows; i++)
-            if (i != row) {
-                neo_data[neo_index] = data[i];
-                neo_index++;
-            }
-        free(data[row]);
-        free(data);
-        data = neo_data;
+        memmove(data + row * ncols, data + (row + 1) * ncols, sizeof(float) * (nrows - row - 1) * ncols);
         nrows--;
     }
 
-    // method to remove a column from the matrix
+    // method to remove a column from the matrix, compacting the rows in place
     void remove_column(int col) {
         int neo_index = 0;
-        auto** neo_data = (float**)malloc(sizeof(float*) * nrows);
         for (int r = 0; r < nrows; r++)
-            neo_data[r] = (float*)malloc(sizeof(float) * (ncols - 1));
-
-        for (int r = 0; r < nrows; r++) {
             for (int c = 0; c < ncols; c++)
                 if (c != col) {
-                    neo_data[r][neo_index] = data[r][c];
+                    data[neo_index] = data[r * ncols + c];
                     neo_index++;
                 }
-            neo_index = 0;
-        }
-
-        for (int r = 0; r < nrows; r++)
-            free(data[r]);
-        free(data);
-        data = neo_data;
         ncols--;
     }
 
@@ -121,16 +211,16 @@ public:
     void clone(Matrix* other) const {
         for (int r = 0; r < nrows; r++)
             for (int c = 0; c < ncols; c++)
-                other->set(data[r][c], r, c);
+                other->set(get(r, c), r, c);
     }
 
     // method to display the matrix
     void show() const {
         std::cout << "[ ";
         for (int r = 0; r < nrows; r++) {
-            std::cout << "[ " << data[r][0];
+            std::cout << "[ " << get(r, 0);
             for (int c = 1; c < ncols; c++) {
-                std::cout << ", " << data[r][c];
+                std::cout << ", " << get(r, c);
             }
             std::cout << " ] ";
         }
@@ -138,4 +228,4 @@ public:
     }
 };
 
-#endif //SIMU_PROJEKT_MATRIX_HPP
+#endif //SIMU_PROJEKT_MATRIX_HPP
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef SIMU_PROJEKT_MATRIX_FREE_HPP
+#define SIMU_PROJEKT_MATRIX_FREE_HPP
+
+#include "dof_map.hpp"
+#include "element_geometry.hpp"
+#include "mesh.hpp"
+#include "vector.hpp"
+
+/*
+  Operador de rigidez sin matriz ensamblada: y = K x se calcula elemento por
+  elemento con los gradientes y volumenes de la geometria precalculada, sobre
+  los grados de libertad libres de la DofMap. Solo guarda punteros a la malla,
+  asi que su memoria no depende del numero de entradas de K.
+ */
+class MatrixFreeOperator {
+private:
+    const ElementGeometry* geometry;  // geometria precalculada de la malla
+    const DofMap* dofs;               // numeracion de grados de libertad
+    float k;                          // conductividad termica
+
+public:
+    // constructor que recibe la malla (con la geometria y la DofMap ya construidas)
+    MatrixFreeOperator(const Mesh* M)
+        : geometry(M->get_geometry()), dofs(M->get_dof_map()), k(M->get_problem_data(THERMAL_CONDUCTIVITY)) {}
+
+    // metodo para obtener la cantidad de filas (grados de libertad libres)
+    int get_nrows() const { return dofs->get_num_free(); }
+
+    // metodo para calcular y = K x
+    void multiply(const Vector* x, Vector* y) const {
+        y->init();
+        int num_elements = geometry->get_num_elements();
+        for (int e = 0; e < num_elements; e++) {
+            if (geometry->is_degenerate(e)) continue;
+            int nn = geometry->get_num_nodes(e);
+            int index[MAX_ELEMENT_NODES];
+            float xe[MAX_ELEMENT_NODES];
+            for (int a = 0; a < nn; a++) {
+                index[a] = dofs->get_free_index(geometry->get_node(e, a));
+                xe[a] = index[a] >= 0 ? x->get(index[a]) : 0;
+            }
+            for (int a = 0; a < nn; a++) {
+                if (index[a] < 0) continue;
+                float acc = 0;
+                for (int b = 0; b < nn; b++) acc += geometry->stiffness_entry(e, a, b) * xe[b];
+                y->add(k * acc, index[a]);
+            }
+        }
+    }
+
+    // metodo para obtener la diagonal de K (para el precondicionador de Jacobi)
+    void get_diagonal(Vector* d) const {
+        d->init();
+        for (int e = 0; e < geometry->get_num_elements(); e++)
+            for (int a = 0; a < geometry->get_num_nodes(e); a++) {
+                int row = dofs->get_free_index(geometry->get_node(e, a));
+                if (row >= 0) d->add(k * geometry->stiffness_entry(e, a, a), row);
+            }
+    }
+
+    // metodo para armar el lado derecho: carga de los elementos, columnas de Dirichlet y condiciones de Neumann
+    void build_rhs(const Mesh* M, Vector* b) const {
+        b->init();
+        float Q = M->get_problem_data(HEAT_SOURCE);
+        for (int e = 0; e < geometry->get_num_elements(); e++) {
+            int nn = geometry->get_num_nodes(e);
+            for (int a = 0; a < nn; a++) {
+                int row = dofs->get_free_index(geometry->get_node(e, a));
+                if (row < 0) continue;
+                b->add(geometry->local_load(e, a, Q), row);
+                for (int c = 0; c < nn; c++) {
+                    int node = geometry->get_node(e, c);
+                    if (dofs->is_constrained(node))
+                        b->add(-k * geometry->stiffness_entry(e, a, c) * dofs->get_fixed_value(node), row);
+                }
+            }
+        }
+        for (int c = 0; c < M->get_quantity(NUM_NEUMANN); c++) {
+            Condition* cond = M->get_neumann_condition(c);
+            int row = dofs->get_free_index(cond->get_node()->get_ID() - 1);
+            if (row >= 0) b->add(cond->get_value(), row);
+        }
+    }
+};
+
+#endif  // SIMU_PROJEKT_MATRIX_FREE_HPP
\ No newline at end of file
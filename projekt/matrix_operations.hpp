@@ -1,11 +1,21 @@
 #ifndef SIMU_PROJEKT_MATRIX_OPERATIONS_HPP
 #define SIMU_PROJEKT_MATRIX_OPERATIONS_HPP
 
+#include <algorithm> // incluir std::min
 #include <cmath>  // incluir biblioteca matemtica estndar
 #include <iostream> // incluir biblioteca para entrada y salida estndar
+#include <vector> // incluir la clase vector
+
+// los microncleos vectoriales requieren AVX2 con FMA (MSVC los habilita juntos con /arch:AVX2)
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define SIMU_PROJEKT_USE_AVX2
+#include <immintrin.h>
+#endif
 
 #include "vector.hpp" // incluir la definicin de la clase Vector
 #include "matrix.hpp" // incluir la definicin de la clase Matrix
+#include "workspace.hpp" // incluir la memoria auxiliar reutilizable
+#include "thread_pool.hpp" // incluir el pool de hilos que reparte las filas
 
 // mtodo para multiplicar un escalar por una matriz
 void product_scalar_by_matrix(float scalar, Matrix* M, int n, int m, Matrix* R) {
@@ -15,144 +25,490 @@ void product_scalar_by_matrix(float scalar, Matrix* M, int n, int m, Matrix* R)
             R->set(scalar * M->get(r, c), r, c);
 }
 
-// mtodo para multiplicar una matriz por un vector
-void product_matrix_by_vector(Matrix* M, Vector* V, int n, int m, Vector* R) {
-    for (int r = 0; r < n; r++) { // recorrer cada fila de la matriz
-        float acc = 0; // acumulador para el producto escalar de la fila y el vector
-        for (int c = 0; c < m; c++) // recorrer cada columna de la matriz
-            acc += M->get(r, c) * V->get(c); // suma el producto del elemento de la matriz y el correspondiente elemento del vector al acumulador
-        R->set(acc, r); // asigna el acumulador en el vector resultado
+// funcin para repartir las filas [0, n) entre los hilos del pool (nullptr: sin hilos) en tramos mltiplos de 'granularity'
+template<class Work>
+void run_row_blocks(int n, ThreadPool* pool, int granularity, Work work) {
+    int blocks = (n + granularity - 1) / granularity;
+    int parts = std::min(parallel_width(pool), blocks);
+    if (parts <= 1) {
+        work(0, n);
+        return;
     }
+    pool->run_blocks(parts, [&work, n, blocks, parts, granularity](int t) {
+        int begin = std::min(n, (int)((long long)blocks * t / parts) * granularity);
+        int end = std::min(n, (int)((long long)blocks * (t + 1) / parts) * granularity);
+        work(begin, end);
+    });
 }
 
-// funcin para multiplicar una matriz por otra matriz
-void product_matrix_by_matrix(Matrix* A, Matrix* B, Matrix* R) {
-    int n = A->get_nrows(), m = A->get_ncols(), p = B->get_nrows(), q = B->get_ncols(); // obtener las dimensiones de las matrices
-    if (m == p) { // verificar que el nmero de columnas de A sea igual al nmero de filas de B
-        R->set_size(n, q); // establecer el tamao de la matriz resultado
-        R->init(); // inicializar la matriz resultado con ceros
+/*
+  Producto matriz-vector: se procesan cuatro filas por pasada para leer el
+  vector una sola vez por grupo; con AVX2 cada fila acumula en un registro de
+  8 floats con FMA y se reduce al final.
+ */
+void gemv_rows(MatrixView M, const float* x, int m, float* y, int row_begin, int row_end) {
+    int r = row_begin;
+    for (; r + 4 <= row_end; r += 4) {
+        const float* a0 = M.get_row(r);
+        const float* a1 = M.get_row(r + 1);
+        const float* a2 = M.get_row(r + 2);
+        const float* a3 = M.get_row(r + 3);
+        float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        int c = 0;
+#ifdef SIMU_PROJEKT_USE_AVX2
+        __m256 v0 = _mm256_setzero_ps(), v1 = _mm256_setzero_ps(), v2 = _mm256_setzero_ps(), v3 = _mm256_setzero_ps();
+        for (; c + 8 <= m; c += 8) {
+            __m256 xv = _mm256_loadu_ps(x + c);
+            v0 = _mm256_fmadd_ps(_mm256_loadu_ps(a0 + c), xv, v0);
+            v1 = _mm256_fmadd_ps(_mm256_loadu_ps(a1 + c), xv, v1);
+            v2 = _mm256_fmadd_ps(_mm256_loadu_ps(a2 + c), xv, v2);
+            v3 = _mm256_fmadd_ps(_mm256_loadu_ps(a3 + c), xv, v3);
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, v0); for (int l = 0; l < 8; l++) s0 += lanes[l];
+        _mm256_storeu_ps(lanes, v1); for (int l = 0; l < 8; l++) s1 += lanes[l];
+        _mm256_storeu_ps(lanes, v2); for (int l = 0; l < 8; l++) s2 += lanes[l];
+        _mm256_storeu_ps(lanes, v3); for (int l = 0; l < 8; l++) s3 += lanes[l];
+#endif
+        for (; c < m; c++) {
+            s0 += a0[c] * x[c];
+            s1 += a1[c] * x[c];
+            s2 += a2[c] * x[c];
+            s3 += a3[c] * x[c];
+        }
+        y[r] = s0;
+        y[r + 1] = s1;
+        y[r + 2] = s2;
+        y[r + 3] = s3;
+    }
+    for (; r < row_end; r++) { // filas restantes
+        const float* a = M.get_row(r);
+        float acc = 0;
+        for (int c = 0; c < m; c++) acc += a[c] * x[c];
+        y[r] = acc;
+    }
+}
+
+// mtodo para multiplicar una matriz por un vector; con pool reparte las filas entre sus hilos
+void product_matrix_by_vector(Matrix* M, Vector* V, int n, int m, Vector* R, ThreadPool* pool = nullptr) {
+    MatrixView view = M->view();
+    const float* x = V->get_data();
+    float* y = R->get_data();
+    run_row_blocks(n, pool, 4, [view, x, m, y](int begin, int end) {
+        gemv_rows(view, x, m, y, begin, end);
+    });
+}
+
+/*
+  Producto matriz-matriz por bloques empaquetados: para cada bloque de B
+  (GEMM_KC x GEMM_NC) y cada tramo de GEMM_MC filas de A se copian los
+  operandos a memoria contigua (empaquetado) en el orden en que los lee el
+  microncleo: A en paneles de GEMM_MR filas y B en paneles de GEMM_NR
+  columnas, ambos recorridos por k. As el microncleo lee sus operandos en
+  secuencia, sin saltos entre filas, el bloque de B queda en L2 y el de A en
+  L1, y cada tesela de 4 x 16 de R se acumula en registros. Los paneles
+  incompletos de los bordes se rellenan con ceros.
+ */
+const int GEMM_MC = 64;   // filas de A por bloque
+const int GEMM_KC = 128;  // profundidad del bloque (columnas de A y filas de B)
+const int GEMM_NC = 256;  // columnas de B por bloque
+const int GEMM_MR = 4;    // filas de la tesela del microncleo
+const int GEMM_NR = 16;   // columnas de la tesela del microncleo
 
-        for (int r = 0; r < n; r++) // recorrer cada fila de la matriz A
-            for (int c = 0; c < q; c++) // recorrer cada columna de la matriz B
-                for (int i = 0; i < m; i++)
-                    R->add(A->get(r, i) * B->get(i, c), r, c);
+// funcin para empaquetar X[row0..row0+rows)[k0..k0+kc) en paneles de 'width' filas: out[(p * kc + k) * width + r] = X[row0 + p * width + r][k0 + k]
+void pack_row_panels(MatrixView X, int row0, int rows, int k0, int kc, int width, float* out) {
+    for (int p = 0; p < rows; p += width) {
+        int pr = std::min(width, rows - p);
+        for (int r = 0; r < width; r++) {
+            if (r < pr) {
+                const float* x = X.get_row(row0 + p + r) + k0;
+                for (int k = 0; k < kc; k++) out[k * width + r] = x[k];
+            }
+            else
+                for (int k = 0; k < kc; k++) out[k * width + r] = 0;
+        }
+        out += (size_t)kc * width;
     }
-    else {
-        // si las dimensiones no son compatibles, muestra un mensaje de error y termina el programa
-        std::cout << "Incompatibilidad de dimensiones al multiplicar matrices.\n\nAbortando...\n";
-        exit(EXIT_FAILURE);
+}
+
+// funcin para empaquetar X[k0..k0+kc)[col0..col0+cols) en paneles de 'width' columnas: out[(p * kc + k) * width + c] = X[k0 + k][col0 + p * width + c]
+void pack_column_panels(MatrixView X, int k0, int kc, int col0, int cols, int width, float* out) {
+    for (int p = 0; p < cols; p += width) {
+        int pc = std::min(width, cols - p);
+        for (int k = 0; k < kc; k++) {
+            const float* x = X.get_row(k0 + k) + col0 + p;
+            float* o = out + (size_t)k * width;
+            for (int c = 0; c < pc; c++) o[c] = x[c];
+            for (int c = pc; c < width; c++) o[c] = 0;
+        }
+        out += (size_t)kc * width;
     }
 }
 
-float determinant(Matrix* M); // declaracin de la funcin para calcular el determinante de una matriz
+// microncleo: C[0..GEMM_MR)[0..GEMM_NR) += alpha * Ap * Bp, con Ap y Bp paneles empaquetados de profundidad kc y C con filas separadas por ldc
+void gemm_micro(int kc, const float* Ap, const float* Bp, float alpha, float* C, int ldc) {
+#ifdef SIMU_PROJEKT_USE_AVX2
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    for (int k = 0; k < kc; k++, Ap += GEMM_MR, Bp += GEMM_NR) {
+        __m256 b0 = _mm256_loadu_ps(Bp);
+        __m256 b1 = _mm256_loadu_ps(Bp + 8);
+        __m256 a = _mm256_broadcast_ss(Ap);
+        c00 = _mm256_fmadd_ps(a, b0, c00);
+        c01 = _mm256_fmadd_ps(a, b1, c01);
+        a = _mm256_broadcast_ss(Ap + 1);
+        c10 = _mm256_fmadd_ps(a, b0, c10);
+        c11 = _mm256_fmadd_ps(a, b1, c11);
+        a = _mm256_broadcast_ss(Ap + 2);
+        c20 = _mm256_fmadd_ps(a, b0, c20);
+        c21 = _mm256_fmadd_ps(a, b1, c21);
+        a = _mm256_broadcast_ss(Ap + 3);
+        c30 = _mm256_fmadd_ps(a, b0, c30);
+        c31 = _mm256_fmadd_ps(a, b1, c31);
+    }
+    __m256 scale = _mm256_set1_ps(alpha);
+    float* r0 = C;
+    float* r1 = C + ldc;
+    float* r2 = C + 2 * ldc;
+    float* r3 = C + 3 * ldc;
+    _mm256_storeu_ps(r0, _mm256_fmadd_ps(scale, c00, _mm256_loadu_ps(r0)));
+    _mm256_storeu_ps(r0 + 8, _mm256_fmadd_ps(scale, c01, _mm256_loadu_ps(r0 + 8)));
+    _mm256_storeu_ps(r1, _mm256_fmadd_ps(scale, c10, _mm256_loadu_ps(r1)));
+    _mm256_storeu_ps(r1 + 8, _mm256_fmadd_ps(scale, c11, _mm256_loadu_ps(r1 + 8)));
+    _mm256_storeu_ps(r2, _mm256_fmadd_ps(scale, c20, _mm256_loadu_ps(r2)));
+    _mm256_storeu_ps(r2 + 8, _mm256_fmadd_ps(scale, c21, _mm256_loadu_ps(r2 + 8)));
+    _mm256_storeu_ps(r3, _mm256_fmadd_ps(scale, c30, _mm256_loadu_ps(r3)));
+    _mm256_storeu_ps(r3 + 8, _mm256_fmadd_ps(scale, c31, _mm256_loadu_ps(r3 + 8)));
+#else
+    // versin escalar: el acumulador local de ancho fijo permite autovectorizar el bucle interno
+    float acc[GEMM_MR][GEMM_NR] = {};
+    for (int k = 0; k < kc; k++, Ap += GEMM_MR, Bp += GEMM_NR)
+        for (int r = 0; r < GEMM_MR; r++)
+            for (int c = 0; c < GEMM_NR; c++)
+                acc[r][c] += Ap[r] * Bp[c];
+    for (int r = 0; r < GEMM_MR; r++)
+        for (int c = 0; c < GEMM_NR; c++)
+            C[r * ldc + c] += alpha * acc[r][c];
+#endif
+}
 
-float determinant_auxiliar(Matrix* M) {
-    int n = M->get_ncols();
-    float acc = 0;
+// microncleo para teselas incompletas (bordes): solo se actualizan las primeras mr filas y nr columnas de C
+void gemm_micro_edge(int kc, const float* Ap, const float* Bp, float alpha, float* C, int ldc, int mr, int nr) {
+    float tile[GEMM_MR * GEMM_NR] = {};
+    gemm_micro(kc, Ap, Bp, alpha, tile, GEMM_NR);
+    for (int r = 0; r < mr; r++)
+        for (int c = 0; c < nr; c++)
+            C[r * ldc + c] += tile[r * GEMM_NR + c];
+}
 
-    for (int c = 0; c < n; c++) {
-        Matrix clon(n, n);
-        M->clone(&clon);
-        clon.remove_row(0);
-        clon.remove_column(c);
-        acc += pow(-1, c) * M->get(0, c) * determinant(&clon);
+// funcin para acumular en las filas [row_begin, row_end) de R el producto A * B por bloques empaquetados; el espacio de empaquetado sale de workspace
+void gemm_rows(MatrixView A, MatrixView B, MatrixView R, int row_begin, int row_end, Workspace* workspace) {
+    int m = A.get_ncols(), q = B.get_ncols();
+    workspace->reset();
+    float* packed_B = workspace->get_vector(GEMM_KC * GEMM_NC).get_data();
+    float* packed_A = workspace->get_vector(GEMM_MC * GEMM_KC).get_data();
+    for (int jc = 0; jc < q; jc += GEMM_NC) {
+        int nc = std::min(GEMM_NC, q - jc);
+        for (int pc = 0; pc < m; pc += GEMM_KC) {
+            int kc = std::min(GEMM_KC, m - pc);
+            pack_column_panels(B, pc, kc, jc, nc, GEMM_NR, packed_B);
+            for (int ic = row_begin; ic < row_end; ic += GEMM_MC) {
+                int mc = std::min(GEMM_MC, row_end - ic);
+                pack_row_panels(A, ic, mc, pc, kc, GEMM_MR, packed_A);
+                for (int j = 0; j < nc; j += GEMM_NR) {
+                    const float* Bp = packed_B + (size_t)j * kc;
+                    for (int i = 0; i < mc; i += GEMM_MR) {
+                        const float* Ap = packed_A + (size_t)i * kc;
+                        float* C = R.get_row(ic + i) + jc + j;
+                        if (i + GEMM_MR <= mc && j + GEMM_NR <= nc)
+                            gemm_micro(kc, Ap, Bp, 1, C, R.get_stride());
+                        else
+                            gemm_micro_edge(kc, Ap, Bp, 1, C, R.get_stride(), std::min(GEMM_MR, mc - i), std::min(GEMM_NR, nc - j));
+                    }
+                }
+            }
+        }
     }
+}
 
-    return acc;
+// funcin para calcular R = A * B sobre vistas (bloques de otras matrices); R debe tener el tamao del producto
+void product_matrix_by_matrix(MatrixView A, MatrixView B, MatrixView R, ThreadPool* pool = nullptr) {
+    R.init();
+    run_row_blocks(A.get_nrows(), pool, GEMM_MC, [A, B, R](int begin, int end) {
+        Workspace workspace; // espacio de empaquetado de cada hilo, reutilizado en todos sus bloques
+        gemm_rows(A, B, R, begin, end, &workspace);
+    });
 }
 
+// funcin para multiplicar una matriz por otra matriz; con pool reparte las filas de R entre sus hilos
+// devuelve false (sin tocar R) si el nmero de columnas de A no es igual al nmero de filas de B
+bool product_matrix_by_matrix(Matrix* A, Matrix* B, Matrix* R, ThreadPool* pool = nullptr) {
+    int n = A->get_nrows(), m = A->get_ncols(), p = B->get_nrows(), q = B->get_ncols(); // obtener las dimensiones de las matrices
+    if (m != p) return false;
+    R->set_size(n, q); // establecer el tamao de la matriz resultado
+    R->init(); // inicializar la matriz resultado con ceros
+
+    product_matrix_by_matrix(A->view(), B->view(), R->view(), pool);
+    return true;
+}
+
+/*
+  Factorizacin LU con pivoteo parcial: P * A = L * U. Se factoriza una sola vez
+  en O(n^3) y despus el determinante, la solucin de sistemas y la inversa se
+  obtienen de los factores sin volver a reservar memoria en cada paso.
+  El resultado queda en el lugar: U en el tringulo superior de A y L (con
+  diagonal unitaria implcita) debajo de la diagonal. pivots[k] es la fila que
+  se intercambi con la fila k en el paso k.
+ */
+
+// factorizacin LU en el lugar; devuelve false si la matriz es singular
+bool lu_factor(Matrix* A, int n, int* pivots) {
+    bool regular = true;
+    for (int k = 0; k < n; k++) {
+        // buscar el pivote de mayor magnitud en la columna k
+        int p = k;
+        float max = std::abs(A->get(k, k));
+        for (int i = k + 1; i < n; i++)
+            if (std::abs(A->get(i, k)) > max) {
+                max = std::abs(A->get(i, k));
+                p = i;
+            }
+        pivots[k] = p;
+        if (max == 0) { // columna nula: no hay nada que eliminar
+            regular = false;
+            continue;
+        }
+        if (p != k)
+            for (int c = 0; c < n; c++) { // intercambiar filas k y p
+                float aux = A->get(k, c);
+                A->set(A->get(p, c), k, c);
+                A->set(aux, p, c);
+            }
+
+        float pivot = A->get(k, k);
+        for (int i = k + 1; i < n; i++) {
+            float l = A->get(i, k) / pivot;
+            A->set(l, i, k);
+            for (int c = k + 1; c < n; c++)
+                A->add(-l * A->get(k, c), i, c);
+        }
+    }
+    return regular;
+}
+
+// determinante a partir de los factores: producto de la diagonal de U con el signo de la permutacin
+float lu_determinant(const Matrix* LU, int n, const int* pivots) {
+    float det = 1;
+    for (int k = 0; k < n; k++) {
+        det *= LU->get(k, k);
+        if (pivots[k] != k) det = -det;
+    }
+    return det;
+}
+
+// resolver A * x = b con los factores de lu_factor(); x puede ser el mismo vector que b
+void lu_solve(const Matrix* LU, int n, const int* pivots, const Vector* b, Vector* x) {
+    if (x != b)
+        for (int i = 0; i < n; i++) x->set(b->get(i), i);
+    for (int k = 0; k < n; k++) // aplicar la permutacin: x = P * b
+        if (pivots[k] != k) {
+            float aux = x->get(k);
+            x->set(x->get(pivots[k]), k);
+            x->set(aux, pivots[k]);
+        }
+    for (int i = 0; i < n; i++) { // sustitucin hacia adelante: L * y = P * b
+        float acum = x->get(i);
+        for (int k = 0; k < i; k++)
+            acum -= LU->get(i, k) * x->get(k);
+        x->set(acum, i);
+    }
+    for (int i = n - 1; i >= 0; i--) { // sustitucin hacia atrs: U * x = y
+        float acum = x->get(i);
+        for (int k = i + 1; k < n; k++)
+            acum -= LU->get(i, k) * x->get(k);
+        x->set(acum / LU->get(i, i), i);
+    }
+}
+
+// calcular la inversa columna por columna a partir de los factores de lu_factor()
+void lu_inverse(const Matrix* LU, int n, const int* pivots, Matrix* X) {
+    Vector column(n); // nica memoria auxiliar, reutilizada para todas las columnas
+    for (int c = 0; c < n; c++) {
+        column.init();
+        column.set(1, c);
+        lu_solve(LU, n, pivots, &column, &column);
+        for (int r = 0; r < n; r++)
+            X->set(column.get(r), r, c);
+    }
+}
+
+// determinante con frmula cerrada hasta 3x3 y factorizacin LU para matrices mayores
 float determinant(Matrix* M) {
     float ans;
     switch (M->get_ncols()) {
     case 1: ans = M->get(0, 0); break;
     case 2: ans = M->get(0, 0) * M->get(1, 1) - M->get(0, 1) * M->get(1, 0); break;
     case 3: ans = M->get(0, 0) * M->get(1, 1) * M->get(2, 2) - M->get(0, 0) * M->get(1, 2) * M->get(2, 1) - M->get(0, 1) * M->get(1, 0) * M->get(2, 2) + M->get(0, 1) * M->get(1, 2) * M->get(2, 0) + M->get(0, 2) * M->get(1, 0) * M->get(2, 1) - M->get(0, 2) * M->get(1, 1) * M->get(2, 0); break;
-    default: ans = determinant_auxiliar(M);
+    default: {
+        int n = M->get_ncols();
+        Matrix LU(n, n);
+        int* pivots = (int*)malloc(sizeof(int) * n);
+        M->clone(&LU);
+        ans = lu_factor(&LU, n, pivots) ? lu_determinant(&LU, n, pivots) : 0;
+        free(pivots);
+    }
     }
     return ans;
 }
 
-float get_minor(Matrix* M, int n, int r, int c) {
-    Matrix clon(n, n);
-    M->clone(&clon);
-
-    clon.remove_row(r);
-    clon.remove_column(c);
-
-    return determinant(&clon);
-}
-
-void conjugate_matrix(Matrix* M, int n, Matrix* C) {
-    for (int r = 0; r < n; r++)
-        for (int c = 0; c < n; c++)
-            C->set(pow(-1, r + c) * get_minor(M, n, r, c), r, c);
-}
-
 void transpose(Matrix* M, int n, int m, Matrix* T) {
     for (int r = 0; r < n; r++)
         for (int c = 0; c < m; c++)
             T->set(M->get(r, c), c, r);
 }
 
-// calculando inversa utilizando el mtodo de Cholesky
-void calculate_inverse(Matrix* A, int n, Matrix* X) {
-    Matrix L(n, n), Y(n, n);
-    float acum;
+/*
+  Factorizacin de Cholesky por bloques (right-looking) en el lugar: el
+  tringulo inferior de A se reemplaza por L, con A = L * L^T. En cada paso
+  se factoriza el bloque diagonal, se resuelve el panel que est debajo
+  (L21 = A21 * L11^-T) y se actualiza la submatriz restante con el panel,
+  A22 -= L21 * L21^T, que es donde se concentra el trabajo. El panel se
+  empaqueta una vez (como operando izquierdo en paneles de GEMM_MR filas y
+  como derecho en paneles de GEMM_NR filas) y la actualizacin recorre solo
+  las teselas del tringulo inferior con el microncleo de GEMM; las que
+  cortan la diagonal se calculan aparte y se suman solo debajo de ella.
+  Con un pool, el panel y la actualizacin se reparten por bloques de
+  CHOLESKY_NB filas que los hilos toman a medida que terminan (los de
+  abajo, con ms teselas, primero). El espacio de empaquetado sale de
+  workspace, que se puede conservar entre llamadas.
+  Devuelve false si A no es definida positiva. El tringulo superior no se usa.
+ */
+const int CHOLESKY_NB = 64; // ancho del panel
 
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (i == j) {
-                acum = 0;
-                for (int k = 0; k < j; k++) {
-                    acum += pow(L.get(j, k), 2);
-                }
-                float rad = A->get(j, j) - acum;
-                L.set(((rad <= 0) ? 0.000001 : sqrt(rad)), j, j);
-            }
-            else {
-                if (i > j) {
-                    acum = 0;
-                    for (int k = 0; k < j; k++) {
-                        acum += L.get(i, k) * L.get(j, k);
-                    }
-                    L.set((1 / L.get(j, j)) * (A->get(i, j) - acum), i, j);
-                }
-                else {
-                    L.set(0, i, j);
-                }
+// funcin para calcular el producto escalar de dos tramos contiguos de filas
+float dot_row_segment(const float* a, const float* b, int len) {
+    float acc = 0;
+    int p = 0;
+#ifdef SIMU_PROJEKT_USE_AVX2
+    __m256 v = _mm256_setzero_ps();
+    for (; p + 8 <= len; p += 8)
+        v = _mm256_fmadd_ps(_mm256_loadu_ps(a + p), _mm256_loadu_ps(b + p), v);
+    float lanes[8];
+    _mm256_storeu_ps(lanes, v);
+    for (int l = 0; l < 8; l++) acc += lanes[l];
+#endif
+    for (; p < len; p++)
+        acc += a[p] * b[p];
+    return acc;
+}
+
+bool cholesky_factor(MatrixView A, ThreadPool* pool = nullptr, Workspace* workspace = nullptr) {
+    int n = A.get_nrows();
+    Workspace local;
+    if (workspace == nullptr) workspace = &local;
+    workspace->reset();
+    size_t panel_size = (size_t)(n + GEMM_NR - 1) / GEMM_NR * GEMM_NR * CHOLESKY_NB;
+    float* left = workspace->get_vector((int)panel_size).get_data();  // L21 en paneles de GEMM_MR filas
+    float* right = workspace->get_vector((int)panel_size).get_data(); // L21 en paneles de GEMM_NR filas (L21^T por columnas)
+
+    for (int k = 0; k < n; k += CHOLESKY_NB) {
+        int kb = std::min(CHOLESKY_NB, n - k);
+
+        // bloque diagonal: Cholesky sin bloques, solo con columnas del panel
+        for (int j = k; j < k + kb; j++) {
+            float* row_j = A.get_row(j);
+            float d = row_j[j] - dot_row_segment(row_j + k, row_j + k, j - k);
+            if (!(d > 0)) return false; // tambin rechaza NaN
+            d = std::sqrt(d);
+            row_j[j] = d;
+            for (int i = j + 1; i < k + kb; i++) {
+                float* row_i = A.get_row(i);
+                row_i[j] = (row_i[j] - dot_row_segment(row_i + k, row_j + k, j - k)) / d;
             }
         }
-    }
 
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (i == j) {
-                Y.set(1 / L.get(i, i), i, i);
+        // panel: L21 = A21 * L11^-T, fila por fila, y empaquetado de cada bloque de filas
+        int rest = k + kb, m = n - rest;
+        int num_blocks = (m + CHOLESKY_NB - 1) / CHOLESKY_NB;
+        run_threads(num_blocks, pool, [A, k, kb, rest, m, left, right](int block) {
+            int begin = block * CHOLESKY_NB, end = std::min(m, begin + CHOLESKY_NB);
+            for (int i = rest + begin; i < rest + end; i++) {
+                float* row_i = A.get_row(i);
+                for (int j = k; j < k + kb; j++) {
+                    const float* row_j = A.get_row(j);
+                    row_i[j] = (row_i[j] - dot_row_segment(row_i + k, row_j + k, j - k)) / row_j[j];
+                }
             }
-            else {
-                if (i > j) {
-                    acum = 0;
-                    for (int k = j; k < i; k++) {
-                        acum += L.get(i, k) * Y.get(k, j);
+            pack_row_panels(A, rest + begin, end - begin, k, kb, GEMM_MR, left + (size_t)begin * kb);
+            pack_row_panels(A, rest + begin, end - begin, k, kb, GEMM_NR, right + (size_t)begin * kb);
+        });
+
+        // actualizacin de la submatriz restante: A22 -= L21 * L21^T, solo las teselas del tringulo inferior
+        int stride = A.get_stride();
+        run_threads(num_blocks, pool, [A, kb, rest, m, num_blocks, left, right, stride](int block) {
+            int begin = (num_blocks - 1 - block) * CHOLESKY_NB, end = std::min(m, begin + CHOLESKY_NB);
+            for (int i = begin; i < end; i += GEMM_MR) {
+                int mr = std::min(GEMM_MR, end - i);
+                const float* Ap = left + (size_t)i * kb;
+                float* row = A.get_row(rest + i) + rest;
+                for (int j = 0; j < i + mr; j += GEMM_NR) {
+                    const float* Bp = right + (size_t)j * kb;
+                    if (mr == GEMM_MR && j + GEMM_NR <= i + 1) { // tesela completa debajo de la diagonal
+                        gemm_micro(kb, Ap, Bp, -1, row + j, stride);
+                        continue;
                     }
-                    Y.set(-(1 / L.get(i, i)) * acum, i, j);
-                }
-                else {
-                    Y.set(0, i, j);
+                    float tile[GEMM_MR * GEMM_NR] = {};
+                    gemm_micro(kb, Ap, Bp, -1, tile, GEMM_NR);
+                    for (int r = 0; r < mr; r++)
+                        for (int c = 0; c < GEMM_NR && j + c <= i + r; c++)
+                            row[r * stride + j + c] += tile[r * GEMM_NR + c];
                 }
             }
-        }
+        });
     }
+    return true;
+}
 
-    for (int i = n - 1; i >= 0; i--) {
-        for (int j = 0; j < n; j++) {
-            acum = 0;
-            for (int k = i + 1; k < n; k++) {
-                acum += L.get(k, i) * X->get(k, j);
-            }
-            X->set((1 / L.get(i, i)) * (Y.get(i, j) - acum), i, j);
+// factorizacin de Cholesky del bloque n x n superior izquierdo de A
+bool cholesky_factor(Matrix* A, int n, ThreadPool* pool = nullptr, Workspace* workspace = nullptr) {
+    return cholesky_factor(A->block(0, 0, n, n), pool, workspace);
+}
+
+/*
+  Resolver L * L^T * x = b en el lugar con el factor de cholesky_factor(); xv
+  tiene b al entrar. La sustitucin hacia adelante avanza por bloques de
+  CHOLESKY_NB filas: el aporte de las incgnitas ya resueltas se resta con el
+  producto matriz-vector de cuatro filas por pasada (gemv_rows) y luego se
+  resuelve el tringulo del bloque.
+ */
+void cholesky_solve(MatrixView L, float* xv) {
+    int n = L.get_nrows();
+    float solved_part[CHOLESKY_NB];
+    for (int i0 = 0; i0 < n; i0 += CHOLESKY_NB) { // sustitucin hacia adelante: L * y = b
+        int rows = std::min(CHOLESKY_NB, n - i0);
+        gemv_rows(L.block(i0, 0, rows, i0), xv, i0, solved_part, 0, rows);
+        for (int i = i0; i < i0 + rows; i++) {
+            const float* row = L.get_row(i);
+            xv[i] = (xv[i] - solved_part[i - i0] - dot_row_segment(row + i0, xv + i0, i - i0)) / row[i];
         }
     }
+    for (int i = n - 1; i >= 0; i--) { // sustitucin hacia atrs por columnas de L^T: L^T * x = y
+        const float* row = L.get_row(i);
+        xv[i] /= row[i];
+        float xi = xv[i];
+        for (int k = 0; k < i; k++)
+            xv[k] -= row[k] * xi;
+    }
+}
+
+// resolver L * L^T * x = b con el factor de cholesky_factor(); x puede ser el mismo vector que b
+void cholesky_solve(Matrix* L, int n, const Vector* b, Vector* x) {
+    float* xv = x->get_data();
+    if (x != b)
+        for (int i = 0; i < n; i++) xv[i] = b->get(i);
+    cholesky_solve(L->block(0, 0, n, n), xv);
 }
 
-#endif //SIMU_PROJEKT_MATRIX_OPERATIONS_HPP
+#endif //SIMU_PROJEKT_MATRIX_OPERATIONS_HPP
\ No newline at end of file
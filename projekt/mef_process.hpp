@@ -1,185 +1,58 @@
 #ifndef SIMU_PROJEKT_MEF_PROCESS_HPP
 #define SIMU_PROJEKT_MEF_PROCESS_HPP
 
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <memory>
 
 #include "mesh.hpp"
 #include "matrix.hpp"
 #include "matrix_operations.hpp"
-
-/*
-  El volumen V del tetraedro definido por los vrtices (x1, y1, z1), (x2, y2, z2), (x3, y3, z3) y (x4, y4, z4) se puede calcular utilizando el mtodo del determinante. La frmula est dada por:
-
-  V = (1/6) * | (x2 - x1)(y3 - y1)(z4 - z1) + (y2 - y1)(z3 - z1)(x4 - x1) + (z2 - z1)(x3 - x1)(y4 - y1)
-               - (z2 - z1)(y3 - y1)(x4 - x1) - (x2 - x1)(z3 - z1)(y4 - y1) - (y2 - y1)(x3 - x1)(z4 - z1) |
-
-  Basado en la frmula anterior, se construye la siguiente funcin para calcular el determinante de una matriz formada por las diferencias de las coordenadas de los vrtices
- */
-float calculate_local_volume(float x1, float y1, float z1, float x2, float y2,
-    float z2, float x3, float y3, float z3, float x4,
-    float y4, float z4) {
-    float A = std::abs((x2 - x1) * (y3 - y1) * (z4 - z1) +
-        (y2 - y1) * (z3 - z1) * (x4 - x1) +
-        (z2 - z1) * (x3 - x1) * (y4 - y1) -
-        (z2 - z1) * (y3 - y1) * (x4 - x1) -
-        (x2 - x1) * (z3 - z1) * (y4 - y1) -
-        (y2 - y1) * (x3 - x1) * (z4 - z1)) /
-        6;
-    return ((A == 0) ? 0.000001 : A);
-}
-
-/*
-  Ecuaciones de transformacin
-
-  Expresando las coordenadas (x, y, z) en trminos de  coordenadas (?, ?, ?):
-
-  x(?, ?, ?) = (x2 - x1)? + (x3 - x1)? + (x4 - x1)? + x1
-  y(?, ?, ?) = (y2 - y1)? + (y3 - y1)? + (y4 - y1)? + y1
-  z(?, ?, ?) = (z2 - z1)? + (z3 - z1)? + (z4 - z1)? + z1
-
-  Matriz jacobiana J:
-
-  La matriz jacobiana J se construye como:
-  J = [ ?x/??  ?x/??  ?x/?? ]
-      [ ?y/??  ?y/??  ?y/?? ]
-      [ ?z/??  ?z/??  ?z/?? ]
-
-  En este contexto, las derivadas parciales son
-  J = [ x2 - x1  x3 - x1  x4 - x1 ]
-      [ y2 - y1  y3 - y1  y4 - y1 ]
-      [ z2 - z1  z3 - z1  z4 - z1 ]
-
-  Basado en el anlisis previo, se construye la siguiente funcin para calcular el determinante del jacobiano de una matriz para un elemento tetradrico 3D.
- */
-float calculate_local_jacobian(float x1, float y1, float z1, float x2, float y2,
-    float z2, float x3, float y3, float z3, float x4,
-    float y4, float z4) {
-    float J =
-        (x2 - x1) * (y3 - y1) * (z4 - z1) + (x3 - x1) * (y4 - y1) * (z2 - z1) +
-        (x4 - x1) * (y2 - y1) * (z3 - z1) - (x4 - x1) * (y3 - y1) * (z2 - z1) -
-        (x3 - x1) * (y2 - y1) * (z4 - z1) - (x2 - x1) * (y4 - y1) * (z3 - z1);
-    return ((J == 0) ? 0.000001 : J);
-}
-
-/*
-  La matriz B para un elemento tetradrico se define como:
-
-  B = [ -1  1  0  0 ]
-      [ -1  0  1  0 ]
-      [ -1  0  0  1 ]
-
-  Basado en la definicin anterior, se construye la siguiente funcin para
-  calcular la matriz B para un elemento tetradrico 3D
- */
-void calculate_B(Matrix* B) {
-    B->set(-1, 0, 0);  // B[0][0] = -1
-    B->set(1, 0, 1);   // B[0][1] = 1
-    B->set(0, 0, 2);   // B[0][2] = 0
-    B->set(0, 0, 3);   // B[0][3] = 0
-
-    B->set(-1, 1, 0);  // B[1][0] = -1
-    B->set(0, 1, 1);   // B[1][1] = 0
-    B->set(1, 1, 2);   // B[1][2] = 1
-    B->set(0, 1, 3);   // B[1][3] = 0
-
-    B->set(-1, 2, 0);  // B[2][0] = -1
-    B->set(0, 2, 1);   // B[2][1] = 0
-    B->set(0, 2, 2);   // B[2][2] = 0
-    B->set(1, 2, 3);   // B[2][3] = 1
-}
-
-/*
- La matriz A^e para un elemento tetradrico se define por los siguientes
- elementos:
-
- A^e = [ (y3 - y1) * (z4 - z1) - (y4 - y1) * (z3 - z1)   (x4 - x1) * (z3 - z1) -
- (x3 - x1) * (z4 - z1)   (x3 - x1) * (y4 - y1) - (x4 - x1) * (y3 - y1) ] [ (y4 -
- y1) * (z2 - z1) - (y2 - y1) * (z4 - z1)   (x2 - x1) * (z4 - z1) - (x4 - x1) *
- (z2 - z1)   (x4 - x1) * (y2 - y1) - (x2 - x1) * (y4 - y1) ] [ (y2 - y1) * (z3 -
- z1) - (y3 - y1) * (z2 - z1)   (x3 - x1) * (z2 - z1) - (x2 - x1) * (z3 - z1) (x2
- - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1) ]
-
- Por lo cual, se construye la siguiente funcin para calcular la matriz A^e para
- un elemento tetradrico 3D
- */
-void calculate_local_A(Matrix* A, float x1, float y1, float z1, float x2,
-    float y2, float z2, float x3, float y3, float z3,
-    float x4, float y4, float z4) {
-    A->set((y3 - y1) * (z4 - z1) - (y4 - y1) * (z3 - z1), 0, 0);  // A[0][0]
-    A->set((x4 - x1) * (z3 - z1) - (x3 - x1) * (z4 - z1), 0, 1);  // A[0][1]
-    A->set((x3 - x1) * (y4 - y1) - (x4 - x1) * (y3 - y1), 0, 2);  // A[0][2]
-
-    A->set((y4 - y1) * (z2 - z1) - (y2 - y1) * (z4 - z1), 1, 0);  // A[1][0]
-    A->set((x2 - x1) * (z4 - z1) - (x4 - x1) * (z2 - z1), 1, 1);  // A[1][1]
-    A->set((x4 - x1) * (y2 - y1) - (x2 - x1) * (y4 - y1), 1, 2);  // A[1][2]
-
-    A->set((y2 - y1) * (z3 - z1) - (y3 - y1) * (z2 - z1), 2, 0);  // A[2][0]
-    A->set((x3 - x1) * (z2 - z1) - (x2 - x1) * (z3 - z1), 2, 1);  // A[2][1]
-    A->set((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1), 2, 2);  // A[2][2]
-}
+#include "sparse_matrix.hpp"
+#include "symmetric_sparse_matrix.hpp"
+#include "sparse_assembly.hpp"
+#include "amg.hpp"
+#include "skyline.hpp"
+#include "factor_cache.hpp"
+#include "iterative_solvers.hpp"
+#include "preconditioners.hpp"
+#include "matrix_free.hpp"
+#include "solver_options.hpp"
 
 /*
   La matriz de rigidez K^e se define por:
 
-  K^e = (k * V^e / J^e * J^e) * B^T * (A^e)^T * A^e * B
+  K^e = (k * V^e / J^e * J^e) * B^T * A^e * (A^e)^T * B
 
-  Por lo que la funcin para crear la matriz de rigidez local K^e para un
-  elemento tetradrico 3D se implementa de la siguiente forma
+  que es k * V^e * G^T * G con G = (A^e)^T * B / J^e = J^-1 * B, la matriz de
+  gradientes de las funciones de forma. Para Tet10 y Hex8 la misma integral se evala con
+  la cuadratura de su familia (ver ElementTraits). La matriz de cada elemento
+  se integra una sola vez al leer la malla (ver ElementGeometry), por lo que
+  aqu solo se escala por k. K^e tiene una fila por nodo del elemento.
  */
-void create_local_K(Matrix* K, int element_id, Mesh* M) {
-    K->set_size(4, 4);
+void create_local_K(Matrix* K, int element_id, Mesh* M, bool verbose = true) {
+    const ElementGeometry* geometry = M->get_geometry();
+    int nn = geometry->get_num_nodes(element_id);
+    K->set_size(nn, nn);
 
     float k = M->get_problem_data(THERMAL_CONDUCTIVITY);
 
-    float x1 = M->get_element(element_id)->get_node1()->get_x_coordinate();
-    float y1 = M->get_element(element_id)->get_node1()->get_y_coordinate();
-    float z1 = M->get_element(element_id)->get_node1()->get_z_coordinate();
-
-    float x2 = M->get_element(element_id)->get_node2()->get_x_coordinate();
-    float y2 = M->get_element(element_id)->get_node2()->get_y_coordinate();
-    float z2 = M->get_element(element_id)->get_node2()->get_z_coordinate();
-
-    float x3 = M->get_element(element_id)->get_node3()->get_x_coordinate();
-    float y3 = M->get_element(element_id)->get_node3()->get_y_coordinate();
-    float z3 = M->get_element(element_id)->get_node3()->get_z_coordinate();
-
-    float x4 = M->get_element(element_id)->get_node4()->get_x_coordinate();
-    float y4 = M->get_element(element_id)->get_node4()->get_y_coordinate();
-    float z4 = M->get_element(element_id)->get_node4()->get_z_coordinate();
-
-    float Volume =
-        calculate_local_volume(x1, y1, z1, x2, y2, z2, x3, y3, z3, x4, y4, z4);
-    float J = calculate_local_jacobian(x1, y1, z1, x2, y2, z2, x3, y3, z3, x4,
-        y4, z4);
-
-    std::cout << "\t\tVolumen para el elemento " << element_id + 1 << ": "
-        << Volume << "\n";
-    std::cout << "\t\tJacobiano para el elemento " << element_id + 1 << ": "
-        << J << "\n";
-
-    Matrix B(3, 4), A(3, 3);
-    calculate_B(&B);
-    calculate_local_A(&A, x1, y1, z1, x2, y2, z2, x3, y3, z3, x4, y4, z4);
-
-    B.show();
-    A.show();
-
-    Matrix Bt(4, 3), At(3, 3);
-    transpose(&B, 3, 4, &Bt);
-    transpose(&A, 3, 3, &At);
-
-    Matrix res1, res2, res3;
-    product_matrix_by_matrix(&A, &B, &res1);      // A * B
-    product_matrix_by_matrix(&At, &res1, &res2);  // (A^T) * (A * B)
-    product_matrix_by_matrix(&Bt, &res2, &res3);  // B^T * (A^T * (A * B))
-    product_scalar_by_matrix(k * Volume / (J * J), &res3, 4, 4,
-        K);  // k * V^e / (J^e * J^e) * res3
-
-    std::cout << "\t\tMatriz local creada para el elemento " << element_id + 1
-        << ": ";
-    K->show();
-    std::cout << "\n";
+    if (verbose) {
+        std::cout << "\t\tVolumen para el elemento " << element_id + 1 << ": "
+            << geometry->get_volume(element_id) << "\n";
+        std::cout << "\t\tJacobiano para el elemento " << element_id + 1 << ": "
+            << geometry->get_jacobian(element_id) << "\n";
+    }
+
+    geometry->local_stiffness(element_id, k, K);
+
+    if (verbose) {
+        std::cout << "\t\tMatriz local creada para el elemento " << element_id + 1
+            << ": ";
+        K->show();
+        std::cout << "\n";
+    }
 }
 
 /*
@@ -188,41 +61,27 @@ void create_local_K(Matrix* K, int element_id, Mesh* M) {
 
   El vector de carga b^e se define por:
 
-  b^e = (Q * J^e / 24) * [1 1 1 1]
+  b^e = (Q * |J^e| / 24) * [1 1 1 1]
+
+  y en general b^e_a = Q * integral de N_a sobre el elemento. Se usa el valor
+  absoluto del jacobiano para que los elementos con los nodos en orden
+  inverso no aporten carga negativa.
  */
-void create_local_b(Vector* b, int element_id, Mesh* M) {
-    b->set_size(4);
+void create_local_b(Vector* b, int element_id, Mesh* M, bool verbose = true) {
+    const ElementGeometry* geometry = M->get_geometry();
+    int nn = geometry->get_num_nodes(element_id);
+    b->set_size(nn);
 
     float Q = M->get_problem_data(HEAT_SOURCE);
-
-    float x1 = M->get_element(element_id)->get_node1()->get_x_coordinate();
-    float y1 = M->get_element(element_id)->get_node1()->get_y_coordinate();
-    float z1 = M->get_element(element_id)->get_node1()->get_z_coordinate();
-
-    float x2 = M->get_element(element_id)->get_node2()->get_x_coordinate();
-    float y2 = M->get_element(element_id)->get_node2()->get_y_coordinate();
-    float z2 = M->get_element(element_id)->get_node2()->get_z_coordinate();
-
-    float x3 = M->get_element(element_id)->get_node3()->get_x_coordinate();
-    float y3 = M->get_element(element_id)->get_node3()->get_y_coordinate();
-    float z3 = M->get_element(element_id)->get_node3()->get_z_coordinate();
-
-    float x4 = M->get_element(element_id)->get_node4()->get_x_coordinate();
-    float y4 = M->get_element(element_id)->get_node4()->get_y_coordinate();
-    float z4 = M->get_element(element_id)->get_node4()->get_z_coordinate();
-
-    float J = calculate_local_jacobian(x1, y1, z1, x2, y2, z2, x3, y3, z3, x4,
-        y4, z4);
-
-    b->set(Q * J / 24, 0);
-    b->set(Q * J / 24, 1);
-    b->set(Q * J / 24, 2);
-    b->set(Q * J / 24, 3);
-
-    std::cout << "\t\tVector local creado para el elemento " << element_id + 1
-        << ": ";
-    b->show();
-    std::cout << "\n";
+    for (int a = 0; a < nn; a++)
+        b->set(geometry->local_load(element_id, a, Q), a);
+
+    if (verbose) {
+        std::cout << "\t\tVector local creado para el elemento " << element_id + 1
+            << ": ";
+        b->show();
+        std::cout << "\n";
+    }
 }
 
 /*
@@ -231,100 +90,102 @@ void create_local_b(Vector* b, int element_id, Mesh* M) {
   funciones para crear la matriz de rigidez local (K^e) y el vector de carga
   local (b^e) para cada elemento.
  */
-void create_local_systems(Matrix* Ks, Vector* bs, int num_elements, Mesh* M) {
+void create_local_systems(Matrix* Ks, Vector* bs, int num_elements, Mesh* M,
+    bool verbose = true) {
     for (int e = 0; e < num_elements; e++) {
-        std::cout << "\tCreating local system for Element " << e + 1
-            << "...\n\n";
+        if (verbose)
+            std::cout << "\tCreating local system for Element " << e + 1
+                << "...\n\n";
         create_local_K(&Ks[e], e,
-            M);  // crear matriz de rigidez local para el elemento e
+            M, verbose);  // crear matriz de rigidez local para el elemento e
         create_local_b(&bs[e], e,
-            M);  // crear vector de carga local para el elemento e
+            M, verbose);  // crear vector de carga local para el elemento e
     }
 }
 
 /*
   Funcin para ensamblar la matriz de rigidez K a partir de las matrices
-  locales
+  locales. Los ndices corresponden a grados de libertad libres; un ndice
+  negativo (nodo con condicin de Dirichlet) indica que esa fila y esa
+  columna no se ensamblan. Hay un ndice por nodo del elemento.
  */
-void assembly_K(Matrix* K, Matrix* local_K, int index1, int index2, int index3,
-    int index4) {
-    K->add(local_K->get(0, 0), index1,
-        index1);  // sumar local_K[0][0] a K[index1][index1]
-    K->add(local_K->get(0, 1), index1,
-        index2);  // sumar local_K[0][1] a K[index1][index2]
-    K->add(local_K->get(0, 2), index1,
-        index3);  // sumar local_K[0][2] a K[index1][index3]
-    K->add(local_K->get(0, 3), index1,
-        index4);  // sumar local_K[0][3] a K[index1][index4]
-
-    K->add(local_K->get(1, 0), index2,
-        index1);  // sumar local_K[1][0] a K[index2][index1]
-    K->add(local_K->get(1, 1), index2,
-        index2);  // sumar local_K[1][1] a K[index2][index2]
-    K->add(local_K->get(1, 2), index2,
-        index3);  // sumar local_K[1][2] a K[index2][index3]
-    K->add(local_K->get(1, 3), index2,
-        index4);  // sumar local_K[1][3] a K[index2][index4]
-
-    K->add(local_K->get(2, 0), index3,
-        index1);  // sumar local_K[2][0] a K[index3][index1]
-    K->add(local_K->get(2, 1), index3,
-        index2);  // sumar local_K[2][1] a K[index3][index2]
-    K->add(local_K->get(2, 2), index3,
-        index3);  // sumar local_K[2][2] a K[index3][index3]
-    K->add(local_K->get(2, 3), index3,
-        index4);  // sumar local_K[2][3] a K[index3][index4]
-
-    K->add(local_K->get(3, 0), index4,
-        index1);  // sumar local_K[3][0] a K[index4][index1]
-    K->add(local_K->get(3, 1), index4,
-        index2);  // sumar local_K[3][1] a K[index4][index2]
-    K->add(local_K->get(3, 2), index4,
-        index3);  // sumar local_K[3][2] a K[index4][index3]
-    K->add(local_K->get(3, 3), index4,
-        index4);  // sumar local_K[3][3] a K[index4][index4]
+void assembly_K(Matrix* K, Matrix* local_K, const int* index) {
+    int n = local_K->get_nrows();
+
+    for (int r = 0; r < n; r++) {
+        if (index[r] < 0) continue;
+        for (int c = 0; c < n; c++)
+            if (index[c] >= 0)
+                K->add(local_K->get(r, c), index[r], index[c]);  // sumar local_K[r][c] a K[index_r][index_c]
+    }
 }
 
 /*
   Funcin para ensamblar el vector de carga b a partir de los vectores de carga
-  locales.
+  locales. Los ndices negativos se omiten.
  */
-void assembly_b(Vector* b, Vector* local_b, int index1, int index2, int index3,
-    int index4) {
-    b->add(local_b->get(0), index1);  // sumar local_b[0] a b[index1]
-    b->add(local_b->get(1), index2);  // sumar local_b[1] a b[index2]
-    b->add(local_b->get(2), index3);  // sumar local_b[2] a b[index3]
-    b->add(local_b->get(3), index4);  // sumar local_b[3] a b[index4]
+void assembly_b(Vector* b, Vector* local_b, const int* index) {
+    for (int a = 0; a < local_b->get_size(); a++)
+        if (index[a] >= 0) b->add(local_b->get(a), index[a]);  // sumar local_b[a] a b[index_a]
+}
+
+/*
+  Funcin para pasar al lado derecho las columnas de K^e que corresponden a
+  nodos con condicin de Dirichlet: b[i] -= K^e[r][c] * T_c para cada fila
+  libre r y cada columna restringida c del elemento.
+ */
+void add_dirichlet_columns_to_RHS(Vector* b, Matrix* local_K, const int* nodes,
+    const int* index, const DofMap* dofs) {
+    int n = local_K->get_nrows();
+    for (int c = 0; c < n; c++) {
+        if (index[c] >= 0) continue;
+        float T_bar = dofs->get_fixed_value(nodes[c]);
+        for (int r = 0; r < n; r++)
+            if (index[r] >= 0)
+                b->add(-T_bar * local_K->get(r, c), index[r]);
+    }
 }
 
 /*
   Funcin para ensamblar la matriz global de rigidez K y el vector de carga
   global b a partir de las matrices de rigidez locales y los vectores de carga
   locales.
+
+  El ensamblaje se hace directamente sobre el sistema reducido de la
+  numeracin de la malla (DofMap): K y b tienen una fila por grado de libertad
+  libre, las filas de los nodos con condicin de Dirichlet no se ensamblan y
+  sus columnas se pasan al lado derecho, por lo que las condiciones de
+  Dirichlet quedan aplicadas en la misma pasada lineal sobre los elementos.
  */
 void assembly(Matrix* K, Vector* b, Matrix* Ks, Vector* bs, int num_elements,
-    Mesh* M) {
+    Mesh* M, bool verbose = true) {
+    const DofMap* dofs = M->get_dof_map();
     K->init();  // inicializar la matriz global de rigidez
     b->init();  // inicializar el vector de carga global
 
     for (int e = 0; e < num_elements; e++) {
-        std::cout << "\tEnsamblando para el elemento " << e + 1 << "...\n\n";
-
-        int index1 = M->get_element(e)->get_node1()->get_ID() - 1;
-        int index2 = M->get_element(e)->get_node2()->get_ID() - 1;
-        int index3 = M->get_element(e)->get_node3()->get_ID() - 1;
-        int index4 = M->get_element(e)->get_node4()->get_ID() - 1;
+        if (verbose)
+            std::cout << "\tEnsamblando para el elemento " << e + 1 << "...\n\n";
+
+        Element* element = M->get_element(e);
+        int nodes[MAX_ELEMENT_NODES], index[MAX_ELEMENT_NODES];
+        for (int a = 0; a < element->get_num_nodes(); a++) {
+            nodes[a] = element->get_node(a)->get_ID() - 1;
+            index[a] = dofs->get_free_index(nodes[a]);
+        }
 
-        assembly_K(K, &Ks[e], index1, index2, index3, index4);
-        assembly_b(b, &bs[e], index1, index2, index3, index4);
+        assembly_K(K, &Ks[e], index);
+        assembly_b(b, &bs[e], index);
+        add_dirichlet_columns_to_RHS(b, &Ks[e], nodes, index, dofs);
     }
 }
 
 /*
   Funcin para aplicar las condiciones de contorno de Neumann al vector de
-  carga global b.
+  carga reducido b. Las condiciones sobre nodos con Dirichlet no tienen efecto.
  */
-void apply_neumann_boundary_conditions(Vector* b, Mesh* M) {
+void apply_neumann_boundary_conditions(Vector* b, Mesh* M, bool verbose = true) {
+    const DofMap* dofs = M->get_dof_map();
     int num_conditions = M->get_quantity(
         NUM_NEUMANN);  // obtener la cantidad de condiciones de Neumann
 
@@ -332,93 +193,276 @@ void apply_neumann_boundary_conditions(Vector* b, Mesh* M) {
         Condition* cond =
             M->get_neumann_condition(c);  // obtener la condicin de Neumann
 
-        int index = cond->get_node()->get_ID() -
-            1;  // obtener el ndice global del nodo
-        b->add(cond->get_value(),
-            index);  // sumar el valor de la condicin de Neumann al vector
+        int index = dofs->get_free_index(cond->get_node()->get_ID() -
+            1);  // obtener el grado de libertad del nodo
+        if (index >= 0)
+            b->add(cond->get_value(),
+                index);  // sumar el valor de la condicin de Neumann al vector
         // de carga global b
     }
-    std::cout << "\t\t";
-    b->show();
-    std::cout << "\n";
+    if (verbose) {
+        std::cout << "\t\t";
+        b->show();
+        std::cout << "\n";
+    }
 }
 
 /*
-  Funcin para aadir una columna al RHS
+  Funcin para resolver el sistema de ecuaciones K T = b por Cholesky: K se
+  factoriza en el lugar (su tringulo inferior queda reemplazado por L) y
+  luego se hacen las sustituciones hacia adelante y hacia atrs. Devuelve
+  false (con el motivo en diagnostics) si K no es simtrica definida positiva.
  */
-void add_column_to_RHS(Matrix* K, Vector* b, int col, float T_bar) {
-    for (int r = 0; r < K->get_nrows(); r++) {
-        float value = K->get(r, col);
-        b->add(-T_bar * value, r);
+bool solve_system(Matrix* K, Vector* b, Vector* T, bool verbose = true, ThreadPool* pool = nullptr,
+    std::ostream* diagnostics = &std::cerr) {
+    int n = K->get_nrows();
+
+    if (verbose) std::cout << "\tFactorizando la matriz global K (Cholesky)...\n\n";
+    if (!cholesky_factor(K, n, pool)) {
+        diagnostic_stream(diagnostics) << "Error: the global matrix K is not symmetric positive definite\n";
+        return false;
     }
+
+    if (verbose) std::cout << "\tEjecutando sustituciones...\n\n";
+    cholesky_solve(K, n, b, T);
+    return true;
 }
 
 /*
-  Funcin para aplicar las condiciones de contorno de Dirichlet a la matriz
-  global de rigidez K y al vector de carga global b. Las condiciones de
-  contorno de Dirichlet se aplican eliminando las filas y columnas
-  correspondientes en la matriz de rigidez global K y ajustando el vector de
-  carga global b en consecuencia.
+  Funcin para crear el precondicionador elegido en options.preconditioner;
+  por defecto, AMG con SOLVER_PCG_AMG y Jacobi en otro caso. Los que
+  resuelven sistemas triangulares usan los hilos de options.pool; sus
+  avisos van a options.diagnostics.
  */
-void apply_dirichlet_boundary_conditions(Matrix* K, Vector* b, Mesh* M) {
-    int num_conditions = M->get_quantity(NUM_DIRICHLET);
-    int previous_removed = 0;
+std::unique_ptr<Preconditioner> make_preconditioner(const SolverOptions& options) {
+    preconditioner_type type = options.preconditioner;
+    if (type == PRECONDITIONER_DEFAULT)
+        type = options.solver == SOLVER_PCG_AMG ? PRECONDITIONER_AMG : PRECONDITIONER_JACOBI;
+    std::unique_ptr<Preconditioner> M;
+    switch (type) {
+    case PRECONDITIONER_SSOR: M.reset(new SSORPreconditioner(options.pool)); break;
+    case PRECONDITIONER_ILU0: M.reset(new ILU0Preconditioner(options.pool)); break;
+    case PRECONDITIONER_IC0: M.reset(new IC0Preconditioner(options.pool)); break;
+    case PRECONDITIONER_BLOCK_JACOBI: M.reset(new BlockJacobiPreconditioner(options.pool)); break;
+    case PRECONDITIONER_AMG: M.reset(new AMGPreconditioner(options.smoother)); break;
+    default: M.reset(new JacobiPreconditioner());
+    }
+    M->set_diagnostics(options.diagnostics);
+    return M;
+}
 
-    for (int c = 0; c < num_conditions; c++) {
-        Condition* cond = M->get_dirichlet_condition(c);
+/*
+  Funcin para ejecutar PCG con el operador A (K en el almacenamiento
+  elegido); el precondicionador se construye a partir de K en formato CSR
+  completo. Con verbose se muestran sus tiempos de configuracin y de
+  aplicacin junto con las iteraciones. Devuelve false si el
+  precondicionador no se pudo construir (no se itera).
+ */
+template <class Operator>
+bool run_pcg(const Operator* A, const SparseMatrix* K, Vector* b, Vector* T, const SolverOptions& options,
+    int* iterations, double* residual) {
+    std::unique_ptr<Preconditioner> M = make_preconditioner(options);
+    if (options.verbose) std::cout << "\tConstruyendo el precondicionador " << M->get_name() << "...\n\n";
+    if (!M->setup(K)) return false;
+    if (options.verbose) M->report();
+    *iterations = pcg_solve(A, b, T, M.get(), options.tolerance, options.max_iterations, residual);
+    if (options.verbose) report_preconditioner(M.get(), *iterations);
+    return true;
+}
 
-        int index = cond->get_node()->get_ID() - 1 - previous_removed;
-        float cond_value = cond->get_value();
+/*
+  Funcin para resolver el sistema K T = b (K en formato CSR) con gradiente
+  conjugado precondicionado. Si se pide, se construye el precondicionador
+  AMG a partir de K; en otro caso se usa Jacobi. Con almacenamiento
+  simtrico (options.symmetric_storage) los productos K p de PCG usan solo
+  el tringulo superior de K, repartido entre los hilos de options.pool
+  (ver symmetric_sparse_matrix.hpp). Con warm_start, T trae una
+  aproximacin inicial (por ejemplo, la solucin de una malla anterior
+  interpolada). Las iteraciones y el residuo quedan en report; devuelve
+  false si el precondicionador no se pudo construir o si PCG no alcanz
+  la tolerancia (T tiene la ltima iteracin).
+ */
+bool solve_system_iterative(const SparseMatrix* K, Vector* b, Vector* T, const SolverOptions& options,
+    bool warm_start = false, SolveReport* report = nullptr) {
+    if (!warm_start) T->init();
+    double residual;
+    int iterations;
+    if (options.symmetric_storage) {
+        SymmetricSparseMatrix upper;
+        upper.from_csr(K);
+        upper.set_pool(options.pool);
+        if (!run_pcg(&upper, K, b, T, options, &iterations, &residual)) return false;
+    }
+    else if (!run_pcg(K, K, b, T, options, &iterations, &residual))
+        return false;
 
-        K->remove_row(index);
-        b->remove_row(index);
-        add_column_to_RHS(K, b, index, cond_value);
-        K->remove_column(index);
+    if (options.verbose)
+        std::cout << "\tPCG: " << iterations << " iteraciones, residuo relativo " << residual << "\n\n";
+    return check_convergence(iterations, residual, options, report);
+}
 
-        previous_removed++;
+/*
+  Funcin para resolver el sistema K T = b (K en formato CSR) con la
+  factorizacin de Cholesky en perfil, reordenando con RCM (ver
+  skyline.hpp). Devuelve false (con el motivo en diagnostics) si K no es
+  simtrica definida positiva.
+ */
+bool solve_system_skyline(const SparseMatrix* K, Vector* b, Vector* T, bool verbose = true,
+    std::ostream* diagnostics = &std::cerr) {
+    SkylineCholesky cholesky;
+    if (verbose) std::cout << "\tFactorizando la matriz global K (Cholesky en perfil, RCM)...\n\n";
+    if (!cholesky.factor(K)) {
+        diagnostic_stream(diagnostics) << "Error: the global matrix K is not symmetric positive definite\n";
+        return false;
     }
+    if (verbose) std::cout << "\tPerfil del factor: " << cholesky.get_profile_size() << " entradas\n\n";
+    cholesky.solve(b, T);
+    return true;
 }
 
 /*
-  Funcin para resolver el sistema de ecuaciones K T = b utilizando la matriz
-  inversa.
+  Funcin para combinar los resultados obtenidos con las condiciones de
+  contorno de Dirichlet en el vector de temperatura final. Devuelve false
+  (con el motivo en diagnostics) si Tf no tiene lugar para los n nodos de
+  la malla.
  */
-void solve_system(Matrix* K, Vector* b, Vector* T) {
-    int n = K->get_nrows();
-
-    Matrix Kinv(n, n);
+bool merge_results_with_dirichlet(Vector* T, Vector* Tf, int n, Mesh* M, std::ostream* diagnostics = &std::cerr) {
+    const DofMap* dofs = M->get_dof_map();
+    if (Tf->get_size() < n || dofs->get_num_nodes() != n) {
+        diagnostic_stream(diagnostics) << "Error: incompatible dimensions when merging the results (" << Tf->get_size()
+            << " values for " << n << " nodes)\n";
+        return false;
+    }
+    dofs->scatter(T, Tf);
+    return true;
+}
 
-    std::cout << "\tCalculando la inversa de la matriz global K...\n\n";
-    calculate_inverse(K, n, &Kinv);
+/*
+  Funcin que resuelve el problema con mtodos iterativos: el sistema
+  reducido se ensambla directamente en formato CSR, sin pasar por una
+  matriz densa, con el mtodo elegido en options.assembly (dispersin sobre
+  un patrn precalculado o tripletas ordenadas por radix, ver
+  sparse_assembly.hpp), y se resuelve con PCG o, con SOLVER_SKYLINE, con
+  Cholesky en perfil. Con warm_start, PCG parte de los valores que ya tiene
+  T_full. Las iteraciones y el residuo de PCG quedan en report. Devuelve
+  false si el sistema no se pudo resolver o si PCG no convergi (T_full
+  recibe entonces la ltima iteracin). Con options.factor_cache, el mtodo
+  directo guarda y reutiliza su factorizacin entre ejecuciones (ver
+  factor_cache.hpp).
+ */
+bool solve_problem_sparse(Mesh* M, Vector* T_full, const SolverOptions& options, bool warm_start = false,
+    SolveReport* report = nullptr) {
+    if (options.solver == SOLVER_SKYLINE && options.factor_cache)
+        return solve_problem_skyline_cached(M, T_full, options);
+
+    bool verbose = options.verbose;
+    SparseMatrix K;
+    Vector b;
+
+    if (verbose) std::cout << "Assembling sparse global system and applying Dirichlet Boundary Conditions...\n\n";
+    auto start = std::chrono::steady_clock::now();
+    if (options.assembly == ASSEMBLY_SCATTER)
+        assemble_sparse_scatter(M, &K, &b, options.pool);
+    else
+        assemble_sparse_triplets(M, &K, &b, options.pool);
+    if (verbose)
+        std::cout << "\tEnsamblaje " << (options.assembly == ASSEMBLY_SCATTER ? "por dispersion" : "por tripletas")
+        << ": " << K.get_nnz() << " entradas en "
+        << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n\n";
+
+    if (verbose) std::cout << "Applying Neumann Boundary Conditions...\n\n";
+    apply_neumann_boundary_conditions(&b, M, verbose);
+
+    if (verbose) std::cout << "Solving global system...\n\n";
+    Vector T(K.get_nrows());
+    bool converged = true;
+    if (options.solver == SOLVER_SKYLINE) {
+        if (!solve_system_skyline(&K, &b, &T, verbose, options.diagnostics)) return false;
+    }
+    else {
+        SolveReport local;
+        if (report == nullptr) report = &local;
+        if (warm_start) M->get_dof_map()->gather(T_full, &T);
+        converged = solve_system_iterative(&K, &b, &T, options, warm_start, report);
+        if (!converged && report->converged) return false;  // el precondicionador no se pudo construir
+    }
 
-    std::cout << "\tEjecutando clculo final...\n\n";
-    product_matrix_by_vector(&Kinv, b, n, n, T);
+    if (verbose) std::cout << "Preparing results...\n\n";
+    if (!merge_results_with_dirichlet(&T, T_full, M->get_quantity(NUM_NODES), M, options.diagnostics)) return false;
+    return converged;
 }
 
 /*
-  Funcin para combinar los resultados obtenidos con las condiciones de
-  contorno de Dirichlet en el vector de temperatura final.
+  Funcin que ejecuta el proceso completo del MEF sobre una malla ya leda:
+  sistemas locales, ensamblaje, condiciones de contorno, solucin y
+  combinacin con los valores de Dirichlet. El resultado queda en T_full,
+  que debe tener tamao igual al nmero de nodos. Los mtodos iterativos
+  dejan sus iteraciones y su residuo en report. Devuelve false si el
+  sistema no se pudo resolver o si no se alcanz la tolerancia.
  */
-void merge_results_with_dirichlet(Vector* T, Vector* Tf, int n, Mesh* M) {
-    int num_dirichlet = M->get_quantity(NUM_DIRICHLET);
+bool solve_problem(Mesh* M, Vector* T_full, const SolverOptions& options, SolveReport* report = nullptr) {
+    if (options.solver != SOLVER_DENSE)
+        return solve_problem_sparse(M, T_full, options, false, report);
 
-    int cont_dirichlet = 0;
-    int cont_T = 0;
+    bool verbose = options.verbose;
+    int num_nodes = M->get_quantity(NUM_NODES);
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    int num_free = M->get_dof_map()->get_num_free();
+    Matrix K(num_free, num_free);
+    Vector b(num_free);
+    Matrix* local_Ks = new Matrix[num_elements];
+    Vector* local_bs = new Vector[num_elements];
 
-    for (int i = 0; i < n; i++) {
-        if (M->does_node_have_dirichlet_condition(i + 1)) {
-            Condition* cond = M->get_dirichlet_condition(cont_dirichlet);
-            cont_dirichlet++;
+    if (verbose) std::cout << "Creating local systems...\n\n";
+    create_local_systems(local_Ks, local_bs, num_elements, M, verbose);
 
-            float cond_value = cond->get_value();
+    if (verbose) std::cout << "Performing Assembly and applying Dirichlet Boundary Conditions...\n\n";
+    assembly(&K, &b, local_Ks, local_bs, num_elements, M, verbose);
 
-            Tf->set(cond_value, i);
-        }
-        else {
-            Tf->set(T->get(cont_T), i);
-            cont_T++;
-        }
-    }
+    delete[] local_Ks;
+    delete[] local_bs;
+
+    if (verbose) std::cout << "Applying Neumann Boundary Conditions...\n\n";
+    apply_neumann_boundary_conditions(&b, M, verbose);
+
+    if (verbose) std::cout << "Solving global system...\n\n";
+    Vector T(num_free);
+    if (!solve_system(&K, &b, &T, verbose, options.pool, options.diagnostics)) return false;
+
+    if (verbose) std::cout << "Preparing results...\n\n";
+    return merge_results_with_dirichlet(&T, T_full, num_nodes, M, options.diagnostics);
+}
+
+/*
+  Funcin que resuelve el problema sin ensamblar K: el producto K x se
+  calcula elemento por elemento a partir de la geometra precalculada y se
+  usa PCG con Jacobi. La memoria es proporcional al nmero de nodos y
+  elementos, no al de entradas de K. Las iteraciones y el residuo quedan en
+  report; devuelve false si PCG no convergi (T_full recibe la ltima
+  iteracin) o si la solucin no se pudo combinar con los valores de
+  Dirichlet.
+ */
+bool solve_problem_matrix_free(Mesh* M, Vector* T_full, const SolverOptions& options, SolveReport* report = nullptr) {
+    MatrixFreeOperator K(M);
+    int n = K.get_nrows();
+    Vector b(n), T(n), diagonal(n);
+
+    if (options.verbose) std::cout << "Building right-hand side...\n\n";
+    K.build_rhs(M, &b);
+
+    if (options.verbose) std::cout << "Solving global system (matrix-free)...\n\n";
+    K.get_diagonal(&diagonal);
+    JacobiPreconditioner jacobi;
+    jacobi.setup(&diagonal);
+    T.init();
+    double residual;
+    int iterations = pcg_solve(&K, &b, &T, &jacobi, options.tolerance, options.max_iterations, &residual);
+    if (options.verbose)
+        std::cout << "\tPCG sin matriz: " << iterations << " iteraciones, residuo relativo " << residual << "\n\n";
+    bool converged = check_convergence(iterations, residual, options, report);
+
+    if (options.verbose) std::cout << "Preparing results...\n\n";
+    return merge_results_with_dirichlet(&T, T_full, M->get_quantity(NUM_NODES), M, options.diagnostics) && converged;
 }
 
 #endif  // SIMU_PROJEKT_MEF_PROCESS_HPP
@@ -0,0 +1,40 @@
+#ifndef SIMU_PROJEKT_MEF_SOLVER_HPP
+#define SIMU_PROJEKT_MEF_SOLVER_HPP
+
+#include "domain_decomposition.hpp"
+#include "mef_process.hpp"
+#include "mesh.hpp"
+#include "nonlinear_solver.hpp"
+#include "solver_options.hpp"
+#include "solver_planner.hpp"
+#include "vector.hpp"
+
+/*
+  Funcin de entrada del proceso del MEF: segn las opciones resuelve el
+  sistema global ensamblado (solve_problem), sin ensamblar
+  (solve_problem_matrix_free) o lo reparte en subdominios
+  (solve_problem_domain_decomposition). Con SOLVER_AUTO el mtodo lo elige
+  el planificador (plan_solver) antes de reservar la memoria del sistema.
+  Si hay una tabla k(T) el problema es no lineal y se resuelve con
+  solve_problem_nonlinear, que ensambla siempre el sistema disperso.
+  T_full recibe la temperatura de todos los nodos. Los mtodos iterativos
+  dejan sus iteraciones y su residuo en report. Devuelve false si el
+  sistema no se pudo resolver o si no se alcanz la tolerancia; en este
+  ltimo caso report->converged es false y T_full tiene la ltima iteracin.
+  Los avisos y errores se escriben en options.diagnostics.
+ */
+bool run_mef(Mesh* M, Vector* T_full, const SolverOptions& options, SolveReport* report = nullptr) {
+    if (!options.conductivity.empty()) return solve_problem_nonlinear(M, T_full, options, false, report);
+    if (options.solver == SOLVER_AUTO) {
+        SolverPlan plan = plan_solver(M, options);
+        if (options.verbose) report_plan(plan);
+        SolverOptions planned = options;
+        planned.solver = plan.solver;
+        return run_mef(M, T_full, planned, report);
+    }
+    if (options.solver == SOLVER_DOMAIN_DECOMPOSITION) return solve_problem_domain_decomposition(M, T_full, options, report);
+    if (options.solver == SOLVER_PCG_MATRIX_FREE) return solve_problem_matrix_free(M, T_full, options, report);
+    return solve_problem(M, T_full, options, report);
+}
+
+#endif  // SIMU_PROJEKT_MEF_SOLVER_HPP
\ No newline at end of file
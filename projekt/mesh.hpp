@@ -3,9 +3,13 @@
 
 #include <iostream>
 #include <cstdlib> // for malloc and free
+#include <vector>
 
+#include "arena.hpp"
 #include "condition.hpp"
+#include "dof_map.hpp"
 #include "element.hpp"
+#include "element_geometry.hpp"
 #include "node.hpp"
 
 // Enumeraciones para los parametros y cantidades del problema
@@ -20,16 +24,16 @@ private:
     Element** elements;                // Arreglo de elementos
     Condition** dirichlet_conditions;  // Arreglo de condiciones de dirichlet
     Condition** neumann_conditions;    // Arreglo de condiciones de neumann
+    Pool<Node> node_pool;              // Almacenamiento contiguo de los nodos
+    Pool<Element> element_pool;        // Almacenamiento contiguo de los elementos
+    Pool<Condition> condition_pool;    // Almacenamiento contiguo de las condiciones (Dirichlet y Neumann)
+    DofMap dof_map;                    // Numeracion de grados de libertad libres y restringidos
+    ElementGeometry geometry;          // Gradientes, jacobianos y volumenes precalculados de los elementos
 
 public:
-    Mesh() : nodes(nullptr), elements(nullptr), dirichlet_conditions(nullptr), neumann_conditions(nullptr) {}  // Constructor
-
-    ~Mesh() { // Destructor para liberar memoria
-        for (int i = 0; i < quantities[NUM_NODES]; ++i) delete nodes[i];
-        for (int i = 0; i < quantities[NUM_ELEMENTS]; ++i) delete elements[i];
-        for (int i = 0; i < quantities[NUM_DIRICHLET]; ++i) delete dirichlet_conditions[i];
-        for (int i = 0; i < quantities[NUM_NEUMANN]; ++i) delete neumann_conditions[i];
+    Mesh() : problem_data(), quantities(), nodes(nullptr), elements(nullptr), dirichlet_conditions(nullptr), neumann_conditions(nullptr) {}  // Constructor
 
+    ~Mesh() { // Destructor para liberar memoria; nodos, elementos y condiciones se liberan junto con sus pools
         delete[] nodes;
         delete[] elements;
         delete[] dirichlet_conditions;
@@ -56,13 +60,48 @@ public:
         return quantities[position];
     }
 
+    // Reserva los arreglos de punteros y los pools con las cantidades del encabezado
     void init_arrays() {
         nodes = new Node * [quantities[NUM_NODES]]();
         elements = new Element * [quantities[NUM_ELEMENTS]]();
         dirichlet_conditions = new Condition * [quantities[NUM_DIRICHLET]]();
         neumann_conditions = new Condition * [quantities[NUM_NEUMANN]]();
+
+        node_pool.reserve(quantities[NUM_NODES]);
+        element_pool.reserve(quantities[NUM_ELEMENTS]);
+        condition_pool.reserve(quantities[NUM_DIRICHLET] + quantities[NUM_NEUMANN]);
+    }
+
+    // Construye un nodo dentro del pool de la malla; la malla es duenia de la memoria
+    Node* create_node(int identifier, float x_value, float y_value, float z_value) {
+        Node* node = node_pool.create(identifier, x_value, y_value, z_value);
+        if (node == nullptr) std::cerr << "Error: Node pool is full\n";
+        return node;
+    }
+
+    // Construye un elemento dentro del pool de la malla
+    Element* create_element(int identifier, Node* first_node, Node* second_node, Node* third_node, Node* fourth_node) {
+        Element* element = element_pool.create(identifier, first_node, second_node, third_node, fourth_node);
+        if (element == nullptr) std::cerr << "Error: Element pool is full\n";
+        return element;
+    }
+
+    // Construye un elemento de cualquier familia (Tet4, Tet10, Hex8) dentro del pool de la malla
+    Element* create_element(int identifier, element_type type, Node* const* element_nodes) {
+        Element* element = element_pool.create(identifier, type, element_nodes);
+        if (element == nullptr) std::cerr << "Error: Element pool is full\n";
+        return element;
+    }
+
+    // Construye una condicion (de Dirichlet o de Neumann) dentro del pool de la malla
+    Condition* create_condition(Node* node, float value) {
+        Condition* condition = condition_pool.create(node, value);
+        if (condition == nullptr) std::cerr << "Error: Condition pool is full\n";
+        return condition;
     }
 
+    // Los metodos insert_* solo guardan el puntero: los objetos deben provenir de create_*
+
     void insert_node(Node* node, int position) {
         if (position >= 0 && position < quantities[NUM_NODES]) {
             nodes[position] = node;
@@ -120,13 +159,106 @@ public:
         }
     }
 
+    // Reordena los elementos: la posicion i pasa a tener el elemento que estaba en order[i], tambien dentro del pool,
+    // de modo que recorrerlos en orden recorre la memoria en orden; los identificadores se conservan
+    void permute_elements(const std::vector<int>& order) {
+        std::vector<Element> previous;
+        previous.reserve(quantities[NUM_ELEMENTS]);
+        for (int i = 0; i < quantities[NUM_ELEMENTS]; ++i) previous.push_back(*elements[order[i]]);
+        for (int i = 0; i < quantities[NUM_ELEMENTS]; ++i) {
+            elements[i] = element_pool.get(i);
+            *elements[i] = previous[i];
+        }
+    }
+
+    // Reordena los nodos igual que permute_elements; el nodo de la posicion i recibe el identificador i + 1 y los
+    // elementos y condiciones pasan a apuntar a su nueva ubicacion. Despues hay que volver a construir la numeracion
+    // y la geometria (build_dof_map y build_geometry)
+    void permute_nodes(const std::vector<int>& order) {
+        std::vector<int> position(quantities[NUM_NODES]);  // posicion nueva de cada nodo, segun su posicion anterior
+        for (int i = 0; i < quantities[NUM_NODES]; ++i) position[order[i]] = i;
+        for (int e = 0; e < quantities[NUM_ELEMENTS]; ++e)
+            for (int a = 0; a < elements[e]->get_num_nodes(); ++a)
+                elements[e]->set_node(a, node_pool.get(position[elements[e]->get_node(a)->get_ID() - 1]));
+        for (int c = 0; c < quantities[NUM_DIRICHLET]; ++c)
+            dirichlet_conditions[c]->set_node(node_pool.get(position[dirichlet_conditions[c]->get_node()->get_ID() - 1]));
+        for (int c = 0; c < quantities[NUM_NEUMANN]; ++c)
+            neumann_conditions[c]->set_node(node_pool.get(position[neumann_conditions[c]->get_node()->get_ID() - 1]));
+
+        std::vector<Node> previous;
+        previous.reserve(quantities[NUM_NODES]);
+        for (int i = 0; i < quantities[NUM_NODES]; ++i) previous.push_back(*nodes[order[i]]);
+        for (int i = 0; i < quantities[NUM_NODES]; ++i) {
+            nodes[i] = node_pool.get(i);
+            *nodes[i] = previous[i];
+            nodes[i]->set_ID(i + 1);
+        }
+    }
+
+    // Consulta O(1) sobre la numeracion; requiere haber llamado a build_dof_map()
     bool does_node_have_dirichlet_condition(int id) const {
-        for (int i = 0; i < quantities[NUM_DIRICHLET]; ++i) {
-            if (dirichlet_conditions[i]->get_node()->get_ID() == id) {
-                return true;
+        return dof_map.is_constrained(id - 1);
+    }
+
+    // Construye la numeracion de grados de libertad a partir de las condiciones de Dirichlet
+    void build_dof_map() {
+        dof_map.init(quantities[NUM_NODES]);
+        for (int i = 0; i < quantities[NUM_DIRICHLET]; ++i)
+            dof_map.constrain(dirichlet_conditions[i]->get_node()->get_ID() - 1, dirichlet_conditions[i]->get_value());
+        dof_map.number();
+    }
+
+    const DofMap* get_dof_map() const {
+        return &dof_map;
+    }
+
+    // Calcula la geometria de todos los elementos una sola vez; devuelve la cantidad de elementos degenerados
+    int build_geometry() {
+        begin_geometry(quantities[NUM_ELEMENTS] > 0 ? elements[0]->get_type() : ELEMENT_TET4);
+        for (int e = 0; e < quantities[NUM_ELEMENTS]; ++e) register_element_geometry(e);
+        compute_geometry(0, quantities[NUM_ELEMENTS]);
+        return end_geometry();
+    }
+
+    // Prepara la geometria para construirla a medida que se insertan los elementos; expected es la familia esperada
+    void begin_geometry(element_type expected) {
+        geometry.init(quantities[NUM_ELEMENTS], expected);
+    }
+
+    // Indica si el elemento e puede registrarse sin reubicar la geometria (ver ElementGeometry::fits)
+    bool geometry_fits(int e) const {
+        return geometry.fits(elements[e]->get_type());
+    }
+
+    // Registra la familia y los nodos del elemento e; los elementos se registran en orden
+    void register_element_geometry(int e) {
+        int index[MAX_ELEMENT_NODES];
+        for (int a = 0; a < elements[e]->get_num_nodes(); ++a) index[a] = elements[e]->get_node(a)->get_ID() - 1;
+        geometry.append(elements[e]->get_type(), index);
+    }
+
+    // Calcula la geometria de los elementos registrados [first, last); admite rangos disjuntos en paralelo
+    void compute_geometry(int first, int last) {
+        float x[MAX_ELEMENT_NODES], y[MAX_ELEMENT_NODES], z[MAX_ELEMENT_NODES];
+        for (int e = first; e < last; ++e) {
+            for (int a = 0; a < elements[e]->get_num_nodes(); ++a) {
+                Node* node = elements[e]->get_node(a);
+                x[a] = node->get_x_coordinate();
+                y[a] = node->get_y_coordinate();
+                z[a] = node->get_z_coordinate();
             }
+            geometry.compute(e, x, y, z);
         }
-        return false;
+    }
+
+    // Cierra la construccion de la geometria; devuelve la cantidad de elementos degenerados
+    int end_geometry() {
+        return geometry.finish();
+    }
+
+    // Geometria precalculada; requiere haber llamado a build_geometry()
+    const ElementGeometry* get_geometry() const {
+        return &geometry;
     }
 
     void insert_neumann_condition(Condition* neumann_condition, int position) {
@@ -165,8 +297,10 @@ public:
 
         std::cout << "\nList of elements\n**********************\n";
         for (int i = 0; i < quantities[NUM_ELEMENTS]; ++i) {
-            std::cout << "Element: " << elements[i]->get_ID() << ", Node 1= " << elements[i]->get_node1()->get_ID();
-            std::cout << ", Node 2= " << elements[i]->get_node2()->get_ID() << ", Node 3= " << elements[i]->get_node3()->get_ID() << ", Node 4= " << elements[i]->get_node4()->get_ID() << "\n";
+            std::cout << "Element: " << elements[i]->get_ID();
+            for (int a = 0; a < elements[i]->get_num_nodes(); ++a)
+                std::cout << ", Node " << a + 1 << "= " << elements[i]->get_node(a)->get_ID();
+            std::cout << "\n";
         }
 
         std::cout << "\nList of Dirichlet boundary conditions\n**********************\n";
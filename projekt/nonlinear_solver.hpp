@@ -0,0 +1,271 @@
+#ifndef SIMU_PROJEKT_NONLINEAR_SOLVER_HPP
+#define SIMU_PROJEKT_NONLINEAR_SOLVER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "conductivity_law.hpp"
+#include "iterative_solvers.hpp"
+#include "matrix_operations.hpp"
+#include "mef_process.hpp"
+#include "mesh.hpp"
+#include "solver_options.hpp"
+#include "sparse_assembly.hpp"
+#include "vector.hpp"
+
+const double FORCING_INITIAL = 0.5;     // tolerancia relativa de la primera solucion interna
+const double FORCING_MAX = 0.1;         // tolerancia relativa maxima de las soluciones internas
+const double FORCING_GAMMA = 0.9;       // constantes de la eleccion 2 de Eisenstat y Walker
+const double FORCING_ALPHA = 2;
+const int NONLINEAR_MAX_BACKTRACKS = 2; // reducciones del paso de Newton antes de pasar a Picard
+const int PRECONDITIONER_LAG_FACTOR = 2;      // el precondicionador se reconstruye si las iteraciones internas se duplican
+const int PRECONDITIONER_MIN_BASELINE = 5;    // iteraciones internas de referencia minimas
+
+/*
+  Problema de conduccion con k(T): guarda el plan de ensamblaje de la malla
+  y, para el ultimo punto evaluado, la conductividad y su derivada en cada
+  elemento, la matriz secante K(T) y el lado derecho b(T) (carga, columnas
+  de Dirichlet y Neumann). Cada evaluacion vuelve a sumar los valores sobre
+  el mismo patron, sin construir de nuevo el plan ni la matriz.
+ */
+class NonlinearHeatProblem {
+private:
+    Mesh* M;                          // malla con la geometria y la DofMap construidas
+    const ConductivityLaw* law;       // tabla k(T)
+    ThreadPool* pool;                 // hilos del ensamblaje (nullptr: sin hilos)
+    AssemblyPlan plan;                // patron y posiciones de las entradas locales
+    std::vector<float> element_k;     // k en la temperatura media de cada elemento
+    std::vector<float> element_dk;    // dk/dT en la temperatura media de cada elemento
+    Vector T_full;                    // temperaturas de todos los nodos en el ultimo punto evaluado
+    SparseMatrix K;                   // matriz secante K(T) del ultimo punto evaluado
+    Vector b;                         // lado derecho b(T) del ultimo punto evaluado
+    double b_norm;                    // norma de b (1 si es nula)
+
+public:
+    // constructor que recibe la malla y la ley de conductividad; construye el plan de ensamblaje
+    NonlinearHeatProblem(Mesh* mesh, const ConductivityLaw* conductivity, ThreadPool* threads)
+        : M(mesh), law(conductivity), pool(threads), element_k(mesh->get_quantity(NUM_ELEMENTS)),
+        element_dk(mesh->get_quantity(NUM_ELEMENTS)), T_full(mesh->get_quantity(NUM_NODES)), b_norm(1) {
+        plan.build(M, pool);
+    }
+
+    /*
+      Metodo para evaluar el problema en las temperaturas libres x: calcula
+      k y dk/dT de cada elemento, ensambla K(T) y b(T) y deja en r el residuo
+      r = b(T) - K(T) x, acumulado en doble precision para que el redondeo no
+      frene la convergencia. Devuelve la norma de r.
+     */
+    double evaluate(const Vector* x, Vector* r) {
+        const ElementGeometry* geometry = M->get_geometry();
+        M->get_dof_map()->scatter(x, &T_full);
+        const float* T = T_full.get_data();
+        run_row_blocks(geometry->get_num_elements(), pool, 1024, [&](int begin, int end) {
+            for (int e = begin; e < end; e++) {
+                int nn = geometry->get_num_nodes(e);
+                float mean = 0;
+                for (int a = 0; a < nn; a++) mean += T[geometry->get_node(e, a)];
+                element_k[e] = law->evaluate(mean / nn, &element_dk[e]);
+            }
+        });
+
+        plan.assemble(M, &K, &b, element_k.data());
+        apply_neumann_boundary_conditions(&b, M, false);
+        b_norm = std::sqrt(dot_product(&b, &b));
+        if (b_norm == 0) b_norm = 1;
+
+        const int* row_ptr = K.get_row_ptr();
+        const int* col_idx = K.get_col_idx();
+        const float* values = K.get_values();
+        run_row_blocks(K.get_nrows(), pool, 1024, [&](int begin, int end) {
+            for (int row = begin; row < end; row++) {
+                double acc = b.get(row);
+                for (int j = row_ptr[row]; j < row_ptr[row + 1]; j++) acc -= (double)values[j] * x->get(col_idx[j]);
+                r->set((float)acc, row);
+            }
+        });
+        return std::sqrt(dot_product(r, r));
+    }
+
+    // metodo para armar el jacobiano de Newton en el ultimo punto evaluado: J = K(T) + termino de dk/dT
+    void jacobian(SparseMatrix* J) const {
+        int n = K.get_nrows();
+        if (J->get_nrows() != n || J->get_nnz() != K.get_nnz()) {
+            J->set_size(n, n, K.get_nnz());
+            memcpy(J->get_row_ptr(), K.get_row_ptr(), sizeof(int) * (n + 1));
+            memcpy(J->get_col_idx(), K.get_col_idx(), sizeof(int) * K.get_nnz());
+        }
+        memcpy(J->get_values(), K.get_values(), sizeof(float) * K.get_nnz());
+        plan.add_conductivity_derivative(M, J, element_dk.data(), &T_full);
+    }
+
+    // metodo para obtener la matriz secante K(T) del ultimo punto evaluado
+    const SparseMatrix* get_matrix() const { return &K; }
+
+    // metodo para obtener la norma del lado derecho del ultimo punto evaluado
+    double get_rhs_norm() const { return b_norm; }
+};
+
+/*
+  Funcion para elegir la tolerancia relativa de la siguiente solucion
+  interna (eleccion 2 de Eisenstat y Walker): si el residuo bajo mucho en
+  la ultima iteracion conviene resolver con mas precision, y si bajo poco
+  no tiene sentido hacerlo. La salvaguarda evita que la tolerancia caiga
+  de golpe y el limite inferior evita resolver por debajo de lo que pide
+  la tolerancia no lineal (target_norm).
+ */
+double forcing_term(double previous_eta, double r_norm, double previous_r_norm, double target_norm) {
+    double ratio = r_norm / previous_r_norm;
+    double eta = FORCING_GAMMA * std::pow(ratio, FORCING_ALPHA);
+    double safeguard = FORCING_GAMMA * std::pow(previous_eta, FORCING_ALPHA);
+    if (safeguard > 0.1) eta = std::max(eta, safeguard);
+    eta = std::min(eta, FORCING_MAX);
+    return std::max(eta, 0.5 * target_norm / r_norm);
+}
+
+/*
+  Funcion que resuelve el problema no lineal -div(k(T) grad T) = Q con la
+  tabla options.conductivity. Se itera en forma de correccion: en cada
+  paso se evalua el residuo r = b(T) - K(T) T y se resuelve
+    Picard: K(T) dT = r    (PCG, K es simetrica)
+    Newton: J(T) dT = r    (BiCGStab, J = K + termino de dk/dT)
+  con el precondicionador elegido construido sobre K(T). El precondicionador
+  se conserva entre iteraciones y se reconstruye solo cuando una solucion
+  interna no alcanza su tolerancia o necesita mas de PRECONDITIONER_LAG_FACTOR
+  veces las iteraciones de la primera que lo uso. Las soluciones
+  internas parten de cero con la tolerancia de Eisenstat y Walker, de modo
+  que las primeras iteraciones son baratas. Picard toma siempre el paso
+  completo; si el paso de Newton no baja el residuo se reduce a la mitad
+  (hasta NONLINEAR_MAX_BACKTRACKS veces) y si aun asi no baja se da un paso
+  de Picard, que converge desde mas lejos. El patron y el plan de
+  ensamblaje se construyen una sola vez. La temperatura de partida es el
+  promedio de los valores de Dirichlet o, con warm_start, la que ya trae
+  T_full (por ejemplo, la solucion de otra carga).
+
+  Termina cuando ||r|| <= options.nonlinear_tolerance ||b||. Las iteraciones
+  no lineales y el residuo relativo final quedan en report. Devuelve false
+  si la iteracion diverge (residuo no finito) o si no alcanza la tolerancia
+  en options.nonlinear_max_iterations iteraciones; en este ultimo caso
+  T_full recibe la ultima iteracion.
+ */
+bool solve_problem_nonlinear(Mesh* M, Vector* T_full, const SolverOptions& options, bool warm_start = false,
+    SolveReport* report = nullptr) {
+    bool verbose = options.verbose;
+    bool newton = options.nonlinear == NONLINEAR_NEWTON;
+    const DofMap* dofs = M->get_dof_map();
+    int n = dofs->get_num_free();
+    auto start = std::chrono::steady_clock::now();
+
+    if (verbose)
+        std::cout << "Solving nonlinear problem k(T) (" << (newton ? "Newton" : "Picard") << ", "
+        << options.conductivity.get_num_points() << " puntos en la tabla)...\n\n";
+
+    Vector x(n), r(n), dx(n), trial(n), r_trial(n);
+    if (warm_start) dofs->gather(T_full, &x);
+    else {
+        double sum = 0;
+        int count = 0;
+        for (int node = 0; node < dofs->get_num_nodes(); node++)
+            if (dofs->is_constrained(node)) {
+                sum += dofs->get_fixed_value(node);
+                count++;
+            }
+        for (int i = 0; i < n; i++) x.set(count > 0 ? (float)(sum / count) : 0.0f, i);
+    }
+
+    NonlinearHeatProblem problem(M, &options.conductivity, options.pool);
+    SparseMatrix J;
+    double r_norm = problem.evaluate(&x, &r), previous_r_norm = 0, eta = FORCING_INITIAL;
+    int iteration = 0, inner_total = 0, num_setups = 0, baseline = 0;
+    bool converged = false, rebuild = true;
+    std::unique_ptr<Preconditioner> P;
+    while (true) {
+        double relative = r_norm / problem.get_rhs_norm();
+        if (!std::isfinite(relative)) {
+            diagnostic_stream(options.diagnostics) << "Error: the nonlinear iteration diverged\n";
+            return false;
+        }
+        if (relative <= options.nonlinear_tolerance) {
+            converged = true;
+            break;
+        }
+        if (iteration == options.nonlinear_max_iterations) break;
+
+        if (iteration > 0)
+            eta = forcing_term(eta, r_norm, previous_r_norm, options.nonlinear_tolerance * problem.get_rhs_norm());
+        bool fresh = rebuild;
+        if (fresh) {
+            P = make_preconditioner(options);
+            if (!P->setup(problem.get_matrix())) return false;
+            num_setups++;
+        }
+        dx.init();
+        double inner_residual;
+        int inner;
+        if (newton) {
+            problem.jacobian(&J);
+            inner = bicgstab_solve(&J, &r, &dx, P.get(), (float)eta, options.max_iterations, &inner_residual);
+        }
+        else
+            inner = pcg_solve(problem.get_matrix(), &r, &dx, P.get(), (float)eta, options.max_iterations, &inner_residual);
+        inner_total += inner;
+        if (fresh) baseline = std::max(inner, PRECONDITIONER_MIN_BASELINE);
+        rebuild = inner_residual > eta || inner > PRECONDITIONER_LAG_FACTOR * baseline;
+
+        // Picard toma siempre el paso completo; Newton lo reduce si el residuo no baja
+        float step = 1;
+        double trial_norm;
+        for (int halving = 0;; halving++) {
+            for (int i = 0; i < n; i++) trial.set(x.get(i) + step * dx.get(i), i);
+            trial_norm = problem.evaluate(&trial, &r_trial);
+            if (!newton || trial_norm < r_norm || halving == NONLINEAR_MAX_BACKTRACKS) break;
+            step /= 2;
+        }
+        bool fallback = newton && trial_norm >= r_norm;
+        if (fallback) {
+            // lejos de la solucion la direccion de Newton puede no servir: se da un paso de Picard desde x
+            problem.evaluate(&x, &r);
+            dx.init();
+            inner = pcg_solve(problem.get_matrix(), &r, &dx, P.get(), (float)eta, options.max_iterations, &inner_residual);
+            inner_total += inner;
+            step = 1;
+            for (int i = 0; i < n; i++) trial.set(x.get(i) + dx.get(i), i);
+            trial_norm = problem.evaluate(&trial, &r_trial);
+        }
+        std::swap(x, trial);
+        std::swap(r, r_trial);
+        previous_r_norm = r_norm;
+        r_norm = trial_norm;
+        iteration++;
+
+        if (verbose)
+            std::cout << "\tIteracion " << iteration << ": residuo relativo " << r_norm / problem.get_rhs_norm()
+            << ", tolerancia interna " << eta << " (" << inner << " iteraciones internas"
+            << (step < 1 ? ", paso reducido a " + std::to_string(step) : std::string())
+            << (fallback ? ", paso de Picard" : "") << (fresh ? ", precondicionador nuevo" : "") << ")\n";
+    }
+
+    if (verbose)
+        std::cout << "\n\t" << iteration << " iteraciones no lineales, " << inner_total << " iteraciones internas en total, "
+        << num_setups << " construcciones del precondicionador, "
+        << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n\n";
+    if (report != nullptr) {
+        report->converged = converged;
+        report->iterations = iteration;
+        report->residual = r_norm / problem.get_rhs_norm();
+    }
+    if (!converged)
+        diagnostic_stream(options.diagnostics) << "Error: the nonlinear iteration did not converge after " << iteration
+        << " iterations (relative residual " << r_norm / problem.get_rhs_norm() << ")\n";
+
+    if (verbose) std::cout << "Preparing results...\n\n";
+    dofs->scatter(&x, T_full);
+    return converged;
+}
+
+#endif  // SIMU_PROJEKT_NONLINEAR_SOLVER_HPP
\ No newline at end of file
@@ -0,0 +1,436 @@
+#ifndef SIMU_PROJEKT_OUT_OF_CORE_HPP
+#define SIMU_PROJEKT_OUT_OF_CORE_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "async_io.hpp"
+#include "dof_map.hpp"
+#include "element_traits.hpp"
+#include "input_output.hpp"
+#include "iterative_solvers.hpp"
+#include "mapped_file.hpp"
+#include "solver_options.hpp"
+#include "sparse_operations.hpp"
+#include "vector.hpp"
+
+/*
+  Matriz CSR guardada en disco: los indices de columna y los valores se
+  leen a traves de una proyeccion en memoria (MappedFile), de modo que el
+  sistema operativo trae las paginas a medida que el producto las recorre
+  y las descarta cuando falta memoria. Solo row_ptr (una entrada por fila)
+  queda en RAM. Cumple la interfaz de operador de pcg_solve.
+ */
+class MappedSparseMatrix {
+private:
+    int nrows;                        // cantidad de filas (y de columnas)
+    std::vector<long long> row_ptr;   // inicio de cada fila (nrows + 1 entradas)
+    MappedFile col_file;              // indices de columna (int)
+    MappedFile value_file;            // valores (float)
+    const int* col_idx;               // columnas proyectadas
+    const float* values;              // valores proyectados
+
+public:
+    MappedSparseMatrix() : nrows(0), col_idx(nullptr), values(nullptr) {}
+
+    // metodo para proyectar la matriz; toma posesion de rows. Devuelve false si los archivos no coinciden con rows
+    bool open(std::vector<long long>* rows, const std::string& col_path, const std::string& value_path) {
+        row_ptr.swap(*rows);
+        nrows = (int)row_ptr.size() - 1;
+        if (!col_file.open(col_path) || !value_file.open(value_path)) return false;
+        size_t nnz = (size_t)row_ptr[nrows];
+        if (col_file.get_size() != nnz * sizeof(int) || value_file.get_size() != nnz * sizeof(float)) return false;
+        col_idx = (const int*)col_file.get_data();
+        values = (const float*)value_file.get_data();
+        return true;
+    }
+
+    // metodo para liberar las proyecciones
+    void close() {
+        col_file.close();
+        value_file.close();
+        col_idx = nullptr;
+        values = nullptr;
+    }
+
+    // metodo para obtener la cantidad de filas
+    int get_nrows() const { return nrows; }
+
+    // metodo para obtener la cantidad de entradas guardadas
+    long long get_nnz() const { return nrows > 0 ? row_ptr[nrows] : 0; }
+
+    // metodo para calcular y = A * x recorriendo la matriz en orden (acceso secuencial al disco)
+    void multiply(const Vector* x, Vector* y) const {
+        const float* xd = x->get_data();
+        for (int r = 0; r < nrows; r++) {
+            float acc = 0;
+            for (long long k = row_ptr[r]; k < row_ptr[r + 1]; k++)
+                acc += values[k] * xd[col_idx[k]];
+            y->set(acc, r);
+        }
+    }
+
+    // metodo para obtener la diagonal de la matriz
+    void get_diagonal(Vector* diagonal) const {
+        for (int r = 0; r < nrows; r++) {
+            float d = 0;
+            for (long long k = row_ptr[r]; k < row_ptr[r + 1]; k++)
+                if (col_idx[k] == r) d = values[k];
+            diagonal->set(d, r);
+        }
+    }
+};
+
+// funcion para ordenar las tripletas del buffer, sumar las repetidas y guardarlas en disco como una corrida ordenada
+bool spill_triplet_run(std::vector<Triplet>* buffer, const std::string& path) {
+    std::sort(buffer->begin(), buffer->end(), triplet_less);
+    size_t count = 0;
+    for (size_t k = 0; k < buffer->size(); k++) {
+        const Triplet& t = (*buffer)[k];
+        if (count > 0 && (*buffer)[count - 1].row == t.row && (*buffer)[count - 1].col == t.col)
+            (*buffer)[count - 1].value += t.value;
+        else
+            (*buffer)[count++] = t;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (file) file.write((const char*)buffer->data(), sizeof(Triplet) * count);
+    buffer->clear();
+    if (!file) {
+        std::cerr << "Error writing temporary file: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Lector secuencial de una corrida de tripletas con un buffer de tamano fijo
+class TripletRunReader {
+private:
+    std::ifstream file;
+    std::vector<Triplet> buffer;
+    size_t position, count;
+
+public:
+    TripletRunReader() : position(0), count(0) {}
+
+    // metodo para abrir la corrida con un buffer de buffer_entries tripletas
+    bool open(const std::string& path, size_t buffer_entries) {
+        file.open(path, std::ios::binary);
+        buffer.resize(buffer_entries);
+        position = count = 0;
+        return (bool)file;
+    }
+
+    // metodo para obtener la proxima tripleta; devuelve false al final de la corrida
+    bool next(Triplet* t) {
+        if (position == count) {
+            file.read((char*)buffer.data(), sizeof(Triplet) * buffer.size());
+            count = (size_t)file.gcount() / sizeof(Triplet);
+            position = 0;
+            if (count == 0) return false;
+        }
+        *t = buffer[position++];
+        return true;
+    }
+};
+
+/*
+  Funcion que mezcla las corridas ordenadas (mezcla de k vias con un heap) y
+  escribe en disco la matriz reducida en formato CSR. Las entradas llegan
+  ordenadas por (fila, columna) en la numeracion de los nodos, y como los
+  grados de libertad libres se numeran en ese mismo orden (DofMap), la
+  matriz reducida sale ordenada sin pasos extra:
+
+    - fila restringida: se descarta
+    - fila libre, columna restringida: b[fila] -= valor * T_columna
+    - fila y columna libres: se escribe la entrada
+
+  Las columnas y los valores van a dos archivos; row_ptr queda en memoria.
+ */
+bool merge_runs_to_csr(const std::vector<std::string>& runs, size_t buffer_entries, const DofMap* dofs,
+    Vector* b, const std::string& col_path, const std::string& value_path, std::vector<long long>* row_ptr) {
+    struct HeapEntry {
+        Triplet t;
+        int run;
+    };
+    auto greater = [](const HeapEntry& a, const HeapEntry& b) { return triplet_less(b.t, a.t); };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(greater)> heap(greater);
+
+    std::vector<TripletRunReader> readers(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (!readers[i].open(runs[i], buffer_entries)) {
+            std::cerr << "Error opening temporary file: " << runs[i] << "\n";
+            return false;
+        }
+        HeapEntry entry;
+        entry.run = (int)i;
+        if (readers[i].next(&entry.t)) heap.push(entry);
+    }
+
+    std::ofstream col_file(col_path, std::ios::binary), value_file(value_path, std::ios::binary);
+    if (!col_file || !value_file) {
+        std::cerr << "Error creating temporary files: " << col_path << ", " << value_path << "\n";
+        return false;
+    }
+    std::vector<int> cols;
+    std::vector<float> vals;
+    cols.reserve(buffer_entries);
+    vals.reserve(buffer_entries);
+    auto flush = [&]() {
+        col_file.write((const char*)cols.data(), sizeof(int) * cols.size());
+        value_file.write((const char*)vals.data(), sizeof(float) * vals.size());
+        cols.clear();
+        vals.clear();
+    };
+
+    int num_free = dofs->get_num_free();
+    row_ptr->assign(num_free + 1, 0);
+    auto emit = [&](const Triplet& t) {
+        int row = dofs->get_free_index(t.row);
+        if (row < 0) return;
+        int col = dofs->get_free_index(t.col);
+        if (col < 0) {
+            b->add(-t.value * dofs->get_fixed_value(t.col), row);
+            return;
+        }
+        cols.push_back(col);
+        vals.push_back(t.value);
+        (*row_ptr)[row + 1]++;
+        if (cols.size() == buffer_entries) flush();
+    };
+
+    bool pending = false;
+    Triplet current = Triplet();
+    while (!heap.empty()) {
+        HeapEntry entry = heap.top();
+        heap.pop();
+        if (pending && entry.t.row == current.row && entry.t.col == current.col)
+            current.value += entry.t.value;
+        else {
+            if (pending) emit(current);
+            current = entry.t;
+            pending = true;
+        }
+        if (readers[entry.run].next(&entry.t)) heap.push(entry);
+    }
+    if (pending) emit(current);
+    flush();
+
+    for (int r = 0; r < num_free; r++) (*row_ptr)[r + 1] += (*row_ptr)[r];
+    if (!col_file || !value_file) {
+        std::cerr << "Error writing temporary files: " << col_path << ", " << value_path << "\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+  Funcion que resuelve el problema sin tener la malla ni el sistema global en
+  memoria, para modelos que no entran en la RAM:
+
+  1. Se leen los nodos (las coordenadas, un valor por nodo, si quedan en
+     memoria) y se recorre la seccion Elements en bloques: cada elemento se
+     integra con su nucleo y aporta sus entradas (nodo, nodo, valor) a un
+     buffer de tripletas. Cuando el buffer se llena se ordena, se suman las
+     repetidas y se vuelca a disco como una corrida ordenada.
+  2. Con las condiciones de Dirichlet ya leidas se numeran los grados de
+     libertad y las corridas se mezclan (k vias) en una matriz CSR reducida
+     escrita en disco.
+  3. La matriz se proyecta en memoria y se resuelve con PCG y Jacobi.
+
+  La memoria de trabajo (buffer de tripletas y buffers de mezcla) esta
+  acotada por options.memory_budget_mb; el resto es proporcional al numero
+  de nodos. Los temporales se escriben en options.scratch_directory (o junto
+  al modelo) y se borran al terminar. T_full recibe la temperatura de todos
+  los nodos. Devuelve false ante errores de lectura o escritura o si PCG no
+  converge (en ese caso T_full recibe la ultima iteracion).
+ */
+bool solve_problem_out_of_core(const std::string& filename, Vector* T_full, const SolverOptions& options) {
+    bool verbose = options.verbose;
+    float k, Q, T_bar, T_hat;
+    int num_nodes, num_elements, num_dirichlet, num_neumann;
+    AsyncFileReader dat_file;
+
+    if (!dat_file.open(filename + ".dat")) {
+        std::cerr << "Error opening file: " << filename << ".dat\n";
+        return false;
+    }
+    if (!(dat_file.read_float(&k) && dat_file.read_float(&Q) && dat_file.read_float(&T_bar) && dat_file.read_float(&T_hat)
+        && dat_file.read_int(&num_nodes) && dat_file.read_int(&num_elements)
+        && dat_file.read_int(&num_dirichlet) && dat_file.read_int(&num_neumann))) {
+        std::cerr << "Error reading header of file: " << filename << ".dat\n";
+        return false;
+    }
+
+    if (!seek_section(dat_file, "Coordinates")) {
+        std::cerr << "Error: Coordinates section not found in " << filename << ".dat\n";
+        return false;
+    }
+    std::vector<float> coordinates(3 * (size_t)num_nodes);
+    for (int i = 0; i < num_nodes; i++) {
+        int id = 0;
+        dat_file.read_int(&id);
+        dat_file.read_float(&coordinates[3 * i]);
+        dat_file.read_float(&coordinates[3 * i + 1]);
+        dat_file.read_float(&coordinates[3 * i + 2]);
+    }
+
+    if (!seek_section(dat_file, "Elements")) {
+        std::cerr << "Error: Elements section not found in " << filename << ".dat\n";
+        return false;
+    }
+
+    // archivos temporales: las corridas, y las columnas y valores de la matriz final
+    std::string prefix = filename;
+    if (!options.scratch_directory.empty()) {
+        size_t slash = filename.find_last_of("/\\");
+        prefix = options.scratch_directory + "/" + (slash == std::string::npos ? filename : filename.substr(slash + 1));
+    }
+    std::vector<std::string> runs;
+    std::string col_path = prefix + ".ooc.cols", value_path = prefix + ".ooc.vals";
+    auto remove_temporaries = [&]() {
+        for (const std::string& run : runs) std::remove(run.c_str());
+        runs.clear();
+    };
+
+    // la mitad del presupuesto es para el buffer de tripletas y la otra mitad para la mezcla
+    size_t budget = (size_t)std::max(options.memory_budget_mb, 1) << 20;
+    size_t run_capacity = std::max<size_t>(budget / 2 / sizeof(Triplet), MAX_ELEMENT_NODES * MAX_ELEMENT_NODES);
+    std::vector<Triplet> buffer;
+    buffer.reserve(run_capacity);
+
+    if (verbose) std::cout << "Streaming elements and spilling sorted runs (" << options.memory_budget_mb << " MB budget)...\n\n";
+    Vector b_full(num_nodes);
+    b_full.init();
+    std::string line;
+    dat_file.read_line(&line);  // resto de la linea de la etiqueta
+    int degenerate = 0;
+    for (int i = 0; i < num_elements; i++) {
+        long values[MAX_ELEMENT_NODES + 2];
+        int count = read_element_line(dat_file, values);
+        element_type type;
+        if (count == 0 || !element_type_from_num_nodes(count - 1, &type)) {
+            std::cerr << "Error: element line " << i + 1 << " in " << filename
+                << ".dat must have 4 (Tet4), 10 (Tet10) or 8 (Hex8) nodes\n";
+            remove_temporaries();
+            return false;
+        }
+
+        int nn = count - 1, nodes[MAX_ELEMENT_NODES];
+        float x[MAX_ELEMENT_NODES], y[MAX_ELEMENT_NODES], z[MAX_ELEMENT_NODES];
+        for (int a = 0; a < nn; a++) {
+            nodes[a] = (int)values[a + 1] - 1;
+            if (nodes[a] < 0 || nodes[a] >= num_nodes) {
+                std::cerr << "Error: One or more nodes for element " << values[0] << " are not initialized\n";
+                remove_temporaries();
+                return false;
+            }
+            x[a] = coordinates[3 * nodes[a]];
+            y[a] = coordinates[3 * nodes[a] + 1];
+            z[a] = coordinates[3 * nodes[a] + 2];
+        }
+
+        float K[MAX_ELEMENT_NODES * MAX_ELEMENT_NODES], load[MAX_ELEMENT_NODES], gradients[3 * MAX_ELEMENT_NODES];
+        float volume, jacobian;
+        if (!compute_element(type, x, y, z, K, load, gradients, &volume, &jacobian)) {
+            degenerate++;
+            continue;
+        }
+
+        if (buffer.size() + nn * nn > run_capacity) {
+            runs.push_back(prefix + ".ooc.run" + std::to_string(runs.size()));
+            if (!spill_triplet_run(&buffer, runs.back())) {
+                remove_temporaries();
+                return false;
+            }
+        }
+        for (int a = 0; a < nn; a++) {
+            b_full.add(Q * load[a], nodes[a]);
+            for (int c = 0; c < nn; c++) buffer.push_back(Triplet{ nodes[a], nodes[c], k * K[a * nn + c] });
+        }
+    }
+    if (!buffer.empty()) {
+        runs.push_back(prefix + ".ooc.run" + std::to_string(runs.size()));
+        if (!spill_triplet_run(&buffer, runs.back())) {
+            remove_temporaries();
+            return false;
+        }
+    }
+    std::vector<Triplet>().swap(buffer);  // liberar el buffer antes de la mezcla
+    if (degenerate > 0)
+        std::cerr << "Warning: " << degenerate << " degenerate elements (zero volume) in " << filename
+        << ".dat, they will not contribute to the system\n";
+
+    // condiciones de contorno
+    DofMap dofs;
+    dofs.init(num_nodes);
+    std::vector<int> neumann_nodes(num_neumann);
+    bool sections_found = seek_section(dat_file, "Dirichlet");
+    for (int i = 0; sections_found && i < num_dirichlet; i++) {
+        int id = 0;
+        dat_file.read_int(&id);
+        if (id >= 1 && id <= num_nodes) dofs.constrain(id - 1, T_bar);
+    }
+    sections_found = sections_found && seek_section(dat_file, "Neumann");
+    for (int i = 0; sections_found && i < num_neumann; i++) dat_file.read_int(&neumann_nodes[i]);
+    if (!sections_found || dat_file.fail()) {
+        std::cerr << "Error: Dirichlet or Neumann section missing or incomplete in " << filename << ".dat\n";
+        remove_temporaries();
+        return false;
+    }
+    dat_file.close();
+    dofs.number();
+
+    int num_free = dofs.get_num_free();
+    Vector b(num_free);
+    dofs.gather(&b_full, &b);
+    for (int node : neumann_nodes)
+        if (node >= 1 && node <= num_nodes && dofs.get_free_index(node - 1) >= 0)
+            b.add(T_hat, dofs.get_free_index(node - 1));
+
+    if (verbose) std::cout << "Merging " << runs.size() << " sorted runs into the on-disk CSR matrix...\n\n";
+    size_t merge_entries = std::max<size_t>(budget / 2 / ((runs.size() + 1) * sizeof(Triplet)), 1024);
+    std::vector<long long> row_ptr;
+    bool merged = merge_runs_to_csr(runs, merge_entries, &dofs, &b, col_path, value_path, &row_ptr);
+    remove_temporaries();
+
+    MappedSparseMatrix K;
+    if (!merged || !K.open(&row_ptr, col_path, value_path)) {
+        if (merged) std::cerr << "Error mapping the on-disk matrix: " << col_path << "\n";
+        K.close();
+        std::remove(col_path.c_str());
+        std::remove(value_path.c_str());
+        return false;
+    }
+    if (verbose)
+        std::cout << "\t" << num_free << " free degrees of freedom, " << K.get_nnz() << " stored entries ("
+        << (K.get_nnz() * (sizeof(int) + sizeof(float)) >> 20) << " MB on disk)\n\n";
+
+    if (verbose) std::cout << "Solving global system (out-of-core)...\n\n";
+    Vector T(num_free), diagonal(num_free);
+    K.get_diagonal(&diagonal);
+    JacobiPreconditioner jacobi;
+    jacobi.setup(&diagonal);
+    T.init();
+    double residual;
+    int iterations = pcg_solve(&K, &b, &T, &jacobi, options.tolerance, options.max_iterations, &residual);
+    if (verbose)
+        std::cout << "\tPCG fuera de memoria: " << iterations << " iteraciones, residuo relativo " << residual << "\n\n";
+    bool converged = check_convergence(iterations, residual, options, nullptr);
+
+    K.close();
+    std::remove(col_path.c_str());
+    std::remove(value_path.c_str());
+
+    if (verbose) std::cout << "Preparing results...\n\n";
+    T_full->set_size(num_nodes);
+    dofs.scatter(&T, T_full);
+    return converged;
+}
+
+#endif  // SIMU_PROJEKT_OUT_OF_CORE_HPP
\ No newline at end of file
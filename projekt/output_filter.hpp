@@ -0,0 +1,255 @@
+#ifndef SIMU_PROJEKT_OUTPUT_FILTER_HPP
+#define SIMU_PROJEKT_OUTPUT_FILTER_HPP
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "diagnostics.hpp"
+#include "mesh.hpp"
+
+const int DEFAULT_RESULT_PRECISION = 6;  // cifras significativas por defecto (las del flujo de salida)
+const int MAX_RESULT_PRECISION = 9;      // cifras que distinguen cualquier float
+
+// Nodos de cada cara de los elementos: primero los vertices (3 o 4) y despues los nodos medios de sus aristas (Tet10)
+const int FACE_NODES_TET[4][6] = { { 1, 2, 3, 5, 8, 9 }, { 0, 2, 3, 6, 7, 9 }, { 0, 1, 3, 4, 7, 8 }, { 0, 1, 2, 4, 5, 6 } };
+const int FACE_NODES_HEX[6][4] = { { 0, 1, 2, 3 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 }, { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+
+// Opciones de los resultados escritos (ver OutputFilter); por defecto se escribe todo con 6 cifras
+struct OutputOptions {
+    std::vector<int> node_set;          // identificadores de los nodos a escribir (vacio: sin restriccion)
+    bool use_box = false;               // escribir solo los nodos dentro de box
+    float box[6] = { 0, 0, 0, 0, 0, 0 };  // xmin, ymin, zmin, xmax, ymax, zmax
+    bool surface_only = false;          // escribir solo los nodos de la superficie de la malla
+    int stride = 1;                     // escribir uno de cada stride nodos (y elementos) seleccionados
+    int temperature_precision = DEFAULT_RESULT_PRECISION;  // cifras significativas de la temperatura
+    int flux_precision = DEFAULT_RESULT_PRECISION;         // cifras significativas del gradiente y el flujo
+
+    // metodo para leer el conjunto de nodos: identificadores separados por espacios; se ignoran comentarios (#)
+    // los errores se escriben en errors (nullptr: se descartan)
+    bool load_node_set(const std::string& filename, std::ostream* errors = &std::cerr) {
+        std::ifstream file(filename);
+        if (!file) {
+            diagnostic_stream(errors) << "Error opening node set: " << filename << "\n";
+            return false;
+        }
+
+        std::vector<int> ids;
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream values(line.substr(0, line.find('#')));
+            int id;
+            while (values >> id) ids.push_back(id);
+            if (!values.eof()) {
+                diagnostic_stream(errors) << "Error: invalid node set " << filename << " (expected node identifiers)\n";
+                return false;
+            }
+        }
+        if (ids.empty()) {
+            diagnostic_stream(errors) << "Error: empty node set " << filename << "\n";
+            return false;
+        }
+        node_set.swap(ids);
+        return true;
+    }
+
+    // metodo para leer la caja "xmin,ymin,zmin,xmax,ymax,zmax"
+    bool parse_box(const std::string& value) {
+        std::string text(value);
+        std::replace(text.begin(), text.end(), ',', ' ');
+        std::istringstream values(text);
+        float b[6];
+        for (int d = 0; d < 6; d++)
+            if (!(values >> b[d])) return false;
+        std::string rest;
+        if (values >> rest) return false;
+        for (int d = 0; d < 3; d++)
+            if (!(b[d] <= b[d + 3])) return false;
+        std::copy(b, b + 6, box);
+        use_box = true;
+        return true;
+    }
+
+    // metodo para saber si algun filtro necesita la malla (coordenadas o caras)
+    bool needs_mesh() const { return use_box || surface_only; }
+
+    // metodo para saber si hay filtros que eligen nodos por su identificador o su posicion
+    bool selects_nodes() const { return !node_set.empty() || needs_mesh(); }
+};
+
+/*
+  Funcion para marcar los nodos de la superficie de la malla: los de las
+  caras que pertenecen a un solo elemento. En mallas mixtas una cara de un
+  hexaedro puede estar cubierta por dos triangulos de tetraedros; esas caras
+  tampoco son de la superficie.
+ */
+void mark_surface_nodes(const Mesh* M, std::vector<char>* on_surface) {
+    struct Face {
+        int corner[4];  // vertices de la cara en orden creciente (-1 en el cuarto si es triangular)
+        int element;    // elemento que la contiene
+        int face;       // cara local del elemento
+    };
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    std::vector<Face> faces;
+    faces.reserve(4 * (size_t)num_elements);
+
+    for (int e = 0; e < num_elements; e++) {
+        Element* element = M->get_element(e);
+        bool hex = element->get_type() == ELEMENT_HEX8;
+        for (int f = 0; f < (hex ? 6 : 4); f++) {
+            Face face = { { -1, -1, -1, -1 }, e, f };
+            int corners = hex ? 4 : 3;
+            for (int i = 0; i < corners; i++)
+                face.corner[i] = element->get_node(hex ? FACE_NODES_HEX[f][i] : FACE_NODES_TET[f][i])->get_ID() - 1;
+            std::sort(face.corner, face.corner + corners);
+            faces.push_back(face);
+        }
+    }
+
+    auto less = [](const Face& x, const Face& y) {
+        return std::lexicographical_compare(x.corner, x.corner + 4, y.corner, y.corner + 4);
+    };
+    std::sort(faces.begin(), faces.end(), less);
+
+    // caras sin pareja; las que aparecen dos veces son interiores
+    std::vector<Face> unmatched;
+    for (size_t i = 0; i < faces.size();) {
+        size_t j = i + 1;
+        while (j < faces.size() && std::equal(faces[i].corner, faces[i].corner + 4, faces[j].corner)) j++;
+        if (j == i + 1) unmatched.push_back(faces[i]);
+        i = j;
+    }
+
+    // cuadrilateros cubiertos por triangulos: cada triangulo usa tres de sus cuatro vertices
+    std::vector<char> interior(unmatched.size(), 0);
+    for (size_t i = 0; i < unmatched.size(); i++) {
+        if (unmatched[i].corner[3] < 0) continue;
+        for (int skip = 0; skip < 4; skip++) {
+            Face triangle = { { -1, -1, -1, -1 }, 0, 0 };
+            for (int c = 0, k = 0; c < 4; c++)
+                if (c != skip) triangle.corner[k++] = unmatched[i].corner[c];
+            auto match = std::lower_bound(unmatched.begin(), unmatched.end(), triangle, less);
+            if (match == unmatched.end() || !std::equal(triangle.corner, triangle.corner + 4, match->corner)) continue;
+            interior[i] = 1;
+            interior[match - unmatched.begin()] = 1;
+        }
+    }
+
+    on_surface->assign(M->get_quantity(NUM_NODES), 0);
+    for (size_t i = 0; i < unmatched.size(); i++) {
+        if (interior[i]) continue;
+        Element* element = M->get_element(unmatched[i].element);
+        int f = unmatched[i].face;
+        switch (element->get_type()) {
+        case ELEMENT_HEX8:
+            for (int a : FACE_NODES_HEX[f]) (*on_surface)[element->get_node(a)->get_ID() - 1] = 1;
+            break;
+        default:
+            for (int a = 0; a < (element->get_num_nodes() == 10 ? 6 : 3); a++)
+                (*on_surface)[element->get_node(FACE_NODES_TET[f][a])->get_ID() - 1] = 1;
+        }
+    }
+}
+
+/*
+  Seleccion de los resultados que se escriben. Los filtros espaciales
+  (conjunto de nodos, caja y superficie) se intersecan y eligen nodos; un
+  elemento se escribe si alguno de sus nodos quedo elegido. Despues se
+  diezma: de los nodos (y de los elementos de cada familia) elegidos se
+  escribe uno de cada stride, en el orden del archivo. La seleccion se
+  guarda como una marca por nodo y por elemento, y write_output la consulta
+  mientras recorre los resultados, sin copiarlos.
+
+  Las marcas de nodos siguen la numeracion del archivo (la de los
+  resultados ya devueltos por restore_node_order): si la malla fue
+  reordenada, node_order[nuevo] da el indice original de cada nodo. Las
+  marcas de elementos siguen el orden actual de la malla, que es el de
+  FluxField.
+ */
+class OutputFilter {
+private:
+    std::vector<char> node_mask;      // 1 si el nodo (numeracion del archivo) pasa los filtros espaciales; vacio: todos
+    std::vector<char> element_mask;   // 1 si el elemento tiene algun nodo elegido; vacio: todos
+    int stride = 1;
+    int temperature_precision = DEFAULT_RESULT_PRECISION;
+    int flux_precision = DEFAULT_RESULT_PRECISION;
+
+public:
+    /*
+      Metodo para armar la seleccion de un modelo de num_nodes nodos. M
+      puede ser nullptr (solucion fuera de memoria) si ningun filtro necesita
+      la malla. Devuelve false si un filtro no se puede aplicar.
+     */
+    bool build(const OutputOptions& options, int num_nodes, const Mesh* M = nullptr,
+        const std::vector<int>* node_order = nullptr) {
+        stride = options.stride;
+        temperature_precision = options.temperature_precision;
+        flux_precision = options.flux_precision;
+        node_mask.clear();
+        element_mask.clear();
+        if (!options.selects_nodes()) return true;
+        if (options.needs_mesh() && M == nullptr) {
+            std::cerr << "Error: -output-box and -output-surface need the mesh in memory (not available with -solver ooc)\n";
+            return false;
+        }
+
+        node_mask.assign(num_nodes, 1);
+        if (!options.node_set.empty()) {
+            std::vector<char> in_set(num_nodes, 0);
+            for (int id : options.node_set) {
+                if (id < 1 || id > num_nodes) {
+                    std::cerr << "Error: node " << id << " of the output node set does not exist\n";
+                    return false;
+                }
+                in_set[id - 1] = 1;
+            }
+            node_mask.swap(in_set);
+        }
+        if (M == nullptr) return true;
+
+        std::vector<char> on_surface;
+        if (options.surface_only) mark_surface_nodes(M, &on_surface);
+        bool reordered = node_order != nullptr && !node_order->empty();
+        for (int i = 0; i < num_nodes; i++) {
+            int original = reordered ? (*node_order)[i] : i;
+            if (!node_mask[original]) continue;
+            if (options.surface_only && !on_surface[i]) node_mask[original] = 0;
+            if (options.use_box) {
+                Node* node = M->get_node(i);
+                float p[3] = { node->get_x_coordinate(), node->get_y_coordinate(), node->get_z_coordinate() };
+                for (int d = 0; d < 3; d++)
+                    if (p[d] < options.box[d] || p[d] > options.box[d + 3]) node_mask[original] = 0;
+            }
+        }
+
+        int num_elements = M->get_quantity(NUM_ELEMENTS);
+        element_mask.assign(num_elements, 0);
+        for (int e = 0; e < num_elements; e++) {
+            Element* element = M->get_element(e);
+            for (int a = 0; a < element->get_num_nodes() && !element_mask[e]; a++) {
+                int node = element->get_node(a)->get_ID() - 1;
+                element_mask[e] = node_mask[reordered ? (*node_order)[node] : node];
+            }
+        }
+        return true;
+    }
+
+    // metodo para saber si el nodo i (numeracion del archivo) pasa los filtros espaciales
+    bool keep_node(int i) const { return node_mask.empty() || node_mask[i]; }
+
+    // metodo para saber si el elemento e (orden de FluxField) pasa los filtros espaciales
+    bool keep_element(int e) const { return element_mask.empty() || element_mask[e]; }
+
+    // metodos para decidir si se escribe el nodo i o el elemento e; selected cuenta los elegidos ya recorridos
+    bool write_node(int i, int* selected) const { return keep_node(i) && (*selected)++ % stride == 0; }
+    bool write_element(int e, int* selected) const { return keep_element(e) && (*selected)++ % stride == 0; }
+
+    int get_stride() const { return stride; }
+    int get_temperature_precision() const { return temperature_precision; }
+    int get_flux_precision() const { return flux_precision; }
+};
+
+#endif  // SIMU_PROJEKT_OUTPUT_FILTER_HPP
\ No newline at end of file
@@ -0,0 +1,166 @@
+#ifndef SIMU_PROJEKT_PARTITION_HPP
+#define SIMU_PROJEKT_PARTITION_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "mesh.hpp"
+
+// Resultado de dividir la malla en subdominios
+struct MeshPartition {
+    int num_parts;                                 // cantidad de subdominios
+    std::vector<int> element_part;                 // subdominio de cada elemento
+    std::vector<int> node_owner;                   // subdominio duenio de cada nodo
+    std::vector<char> is_interface;                // 1 si el nodo pertenece a elementos de mas de un subdominio
+    std::vector<std::vector<int>> part_elements;   // elementos de cada subdominio
+    std::vector<std::vector<int>> part_nodes;      // nodos tocados por los elementos de cada subdominio
+    int num_interface_nodes;                       // cantidad de nodos de interfaz
+};
+
+// Adyacencia nodo -> elementos en formato CSR
+struct NodeElementGraph {
+    std::vector<int> start;     // inicio de la lista de cada nodo (num_nodes + 1 entradas)
+    std::vector<int> elements;  // elementos que contienen a cada nodo
+};
+
+// funcion para obtener los indices (base 0) de los nodos de un elemento; devuelve la cantidad de nodos
+int get_element_node_indices(Mesh* M, int e, int* indices) {
+    Element* element = M->get_element(e);
+    int num_nodes = element->get_num_nodes();
+    for (int a = 0; a < num_nodes; a++)
+        indices[a] = element->get_node(a)->get_ID() - 1;
+    return num_nodes;
+}
+
+// funcion para construir la adyacencia nodo -> elementos de la malla
+void build_node_element_graph(Mesh* M, NodeElementGraph* graph) {
+    int num_nodes = M->get_quantity(NUM_NODES);
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    int idx[MAX_ELEMENT_NODES];
+
+    graph->start.assign(num_nodes + 1, 0);
+    for (int e = 0; e < num_elements; e++) {
+        int nn = get_element_node_indices(M, e, idx);
+        for (int a = 0; a < nn; a++) graph->start[idx[a] + 1]++;
+    }
+    for (int i = 0; i < num_nodes; i++) graph->start[i + 1] += graph->start[i];
+
+    graph->elements.resize(graph->start[num_nodes]);
+    std::vector<int> next(graph->start.begin(), graph->start.end() - 1);
+    for (int e = 0; e < num_elements; e++) {
+        int nn = get_element_node_indices(M, e, idx);
+        for (int a = 0; a < nn; a++) graph->elements[next[idx[a]]++] = e;
+    }
+}
+
+/*
+  Biseccion recursiva de coordenadas (RCB) sobre los centroides de los
+  elementos: el conjunto se corta por la mediana ponderada del eje de mayor
+  extension, repartiendo los subdominios proporcionalmente entre ambas
+  mitades para admitir cantidades que no son potencia de dos.
+ */
+void rcb_split(std::vector<int>::iterator first, std::vector<int>::iterator last,
+    const std::vector<float>& centroids, int first_part, int num_parts, std::vector<int>* element_part) {
+    if (num_parts == 1 || last - first <= 1) {
+        for (auto it = first; it != last; ++it) (*element_part)[*it] = first_part;
+        return;
+    }
+
+    float lo[3] = { 1e30f, 1e30f, 1e30f }, hi[3] = { -1e30f, -1e30f, -1e30f };
+    for (auto it = first; it != last; ++it)
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], centroids[3 * *it + d]);
+            hi[d] = std::max(hi[d], centroids[3 * *it + d]);
+        }
+    int axis = 0;
+    for (int d = 1; d < 3; d++)
+        if (hi[d] - lo[d] > hi[axis] - lo[axis]) axis = d;
+
+    int left_parts = num_parts / 2;
+    auto middle = first + (last - first) * left_parts / num_parts;
+    std::nth_element(first, middle, last, [&centroids, axis](int a, int b) {
+        return centroids[3 * a + axis] < centroids[3 * b + axis];
+    });
+
+    rcb_split(first, middle, centroids, first_part, left_parts, element_part);
+    rcb_split(middle, last, centroids, first_part + left_parts, num_parts - left_parts, element_part);
+}
+
+// funcion para dividir la malla en num_parts subdominios e identificar los nodos de interfaz
+void partition_mesh_rcb(Mesh* M, int num_parts, MeshPartition* partition) {
+    int num_nodes = M->get_quantity(NUM_NODES);
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+    if (num_parts < 1) num_parts = 1;
+    if (num_parts > num_elements) num_parts = num_elements;
+
+    std::vector<float> centroids(3 * num_elements);
+    for (int e = 0; e < num_elements; e++) {
+        Element* element = M->get_element(e);
+        int nn = element->get_num_nodes();
+        float cx = 0, cy = 0, cz = 0;
+        for (int a = 0; a < nn; a++) {
+            cx += element->get_node(a)->get_x_coordinate();
+            cy += element->get_node(a)->get_y_coordinate();
+            cz += element->get_node(a)->get_z_coordinate();
+        }
+        centroids[3 * e] = cx / nn;
+        centroids[3 * e + 1] = cy / nn;
+        centroids[3 * e + 2] = cz / nn;
+    }
+
+    std::vector<int> order(num_elements);
+    for (int e = 0; e < num_elements; e++) order[e] = e;
+
+    partition->num_parts = num_parts;
+    partition->element_part.assign(num_elements, 0);
+    rcb_split(order.begin(), order.end(), centroids, 0, num_parts, &partition->element_part);
+
+    // el duenio de un nodo es el subdominio de menor indice que lo toca
+    partition->node_owner.assign(num_nodes, -1);
+    partition->is_interface.assign(num_nodes, 0);
+    partition->part_elements.assign(num_parts, std::vector<int>());
+    partition->part_nodes.assign(num_parts, std::vector<int>());
+
+    std::vector<int> last_seen(num_nodes, -1);
+    int idx[MAX_ELEMENT_NODES];
+    for (int e = 0; e < num_elements; e++) {
+        int part = partition->element_part[e];
+        partition->part_elements[part].push_back(e);
+        int nn = get_element_node_indices(M, e, idx);
+        for (int a = 0; a < nn; a++) {
+            int node = idx[a];
+            int& owner = partition->node_owner[node];
+            if (owner == -1) owner = part;
+            else if (owner != part) {
+                partition->is_interface[node] = 1;
+                owner = std::min(owner, part);
+            }
+        }
+    }
+
+    for (int p = 0; p < num_parts; p++)
+        for (int e : partition->part_elements[p]) {
+            int nn = get_element_node_indices(M, e, idx);
+            for (int a = 0; a < nn; a++)
+                if (last_seen[idx[a]] != p) {
+                    last_seen[idx[a]] = p;
+                    partition->part_nodes[p].push_back(idx[a]);
+                }
+        }
+
+    partition->num_interface_nodes = 0;
+    for (int i = 0; i < num_nodes; i++) partition->num_interface_nodes += partition->is_interface[i];
+}
+
+// metodo para mostrar el tamano de cada subdominio
+void report_partition(const MeshPartition* partition) {
+    std::cout << "\tPartition in " << partition->num_parts << " subdomains, "
+        << partition->num_interface_nodes << " interface nodes\n";
+    for (int p = 0; p < partition->num_parts; p++)
+        std::cout << "\t\tSubdomain " << p << ": " << partition->part_elements[p].size() << " elements, "
+        << partition->part_nodes[p].size() << " nodes\n";
+    std::cout << "\n";
+}
+
+#endif  // SIMU_PROJEKT_PARTITION_HPP
\ No newline at end of file
@@ -0,0 +1,497 @@
+#ifndef SIMU_PROJEKT_PRECONDITIONERS_HPP
+#define SIMU_PROJEKT_PRECONDITIONERS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "diagnostics.hpp"
+#include "sparse_matrix.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+const int LEVEL_PARALLEL_MIN_ROWS = 512;  // filas minimas de un nivel para repartirlo entre hilos
+const float SSOR_OMEGA = 1.0f;            // factor de relajacion de SSOR (1: Gauss-Seidel simetrico)
+const float FACTOR_SHIFTS[] = { 0.0f, 1e-3f, 1e-2f, 1e-1f, 1.0f };  // desplazamientos relativos de la diagonal ante una ruptura
+
+// Mediciones de un precondicionador, comunes a todos los tipos
+struct PreconditionerStats {
+    double setup_seconds = 0;   // tiempo de la fase de configuracion
+    double apply_seconds = 0;   // tiempo acumulado de las aplicaciones
+    int applications = 0;       // cantidad de aplicaciones (una por iteracion de PCG)
+};
+
+/*
+  Interfaz de los precondicionadores de PCG. setup y apply miden el tiempo y
+  cuentan las aplicaciones, de modo que todos los tipos se comparan con las
+  mismas mediciones; cada tipo implementa build (configuracion a partir de
+  la matriz ensamblada) y solve (z = M^-1 r). Los avisos de build (por
+  ejemplo, pivotes no positivos) se escriben en diagnostics; build devuelve
+  false si no pudo construir un precondicionador utilizable.
+ */
+class Preconditioner {
+private:
+    PreconditionerStats stats;  // mediciones acumuladas
+
+protected:
+    std::ostream* diagnostics = &std::cerr;  // destino de los avisos (nullptr: se descartan)
+
+    // configuracion a partir de la matriz ensamblada; devuelve false si fallo
+    virtual bool build(const SparseMatrix* A) = 0;
+
+    // aplicacion: z = M^-1 r
+    virtual void solve(const Vector* r, Vector* z) = 0;
+
+public:
+    virtual ~Preconditioner() {}
+
+    // metodo para obtener el nombre del precondicionador, tal como se escribe en la opcion -precond
+    virtual const char* get_name() const = 0;
+
+    // metodo para mostrar detalles propios del precondicionador (por ejemplo, la jerarquia del AMG)
+    virtual void report() const {}
+
+    // fase de configuracion; devuelve false si el precondicionador no se pudo construir
+    bool setup(const SparseMatrix* A) {
+        auto start = std::chrono::steady_clock::now();
+        bool built = build(A);
+        stats.setup_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return built;
+    }
+
+    // fase de aplicacion
+    void apply(const Vector* r, Vector* z) {
+        auto start = std::chrono::steady_clock::now();
+        solve(r, z);
+        stats.apply_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.applications++;
+    }
+
+    // metodo para obtener las mediciones acumuladas
+    const PreconditionerStats& get_stats() const { return stats; }
+
+    // metodo para elegir el destino de los avisos de la configuracion
+    void set_diagnostics(std::ostream* sink) { diagnostics = sink; }
+};
+
+// Metodo para mostrar las mediciones de un precondicionador junto con las iteraciones de PCG que necesito
+void report_preconditioner(const Preconditioner* M, int iterations) {
+    const PreconditionerStats& stats = M->get_stats();
+    std::cout << "\tPrecondicionador " << M->get_name() << ": configuracion " << stats.setup_seconds
+        << " s, aplicacion " << stats.apply_seconds << " s (" << stats.applications << " aplicaciones, "
+        << (stats.applications > 0 ? stats.apply_seconds / stats.applications : 0) << " s cada una), "
+        << iterations << " iteraciones\n\n";
+}
+
+/*
+  Matriz triangular dispersa para las sustituciones de los
+  precondicionadores: las entradas fuera de la diagonal se guardan en CSR y
+  la inversa de la diagonal aparte. Una triangular inferior se resuelve
+  hacia adelante y una superior hacia atras.
+
+  Para resolver en paralelo, las filas se agrupan por niveles (level
+  scheduling): el nivel de una fila es uno mas que el mayor nivel de las
+  filas de las que depende, de modo que las filas de un mismo nivel son
+  independientes entre si. Los niveles se recorren en orden y cada uno con
+  al menos LEVEL_PARALLEL_MIN_ROWS filas se reparte entre los hilos.
+ */
+class TriangularMatrix {
+private:
+    bool lower;                    // triangular inferior o superior
+    std::vector<int> row_ptr;      // inicio de cada fila en col_idx/values (n + 1 entradas)
+    std::vector<int> col_idx;      // columna de cada entrada fuera de la diagonal
+    std::vector<float> values;     // valor de cada entrada fuera de la diagonal
+    std::vector<float> inv_diag;   // inversa de la diagonal
+    std::vector<int> level_rows;   // filas agrupadas por nivel
+    std::vector<int> level_start;  // inicio de cada nivel en level_rows
+
+    // metodo para calcular la fila i: x_i = (b_i - sum_j t_ij x_j) / t_ii; b y x pueden ser el mismo arreglo
+    void solve_row(const float* b, float* x, int i) const {
+        float sum = b[i];
+        for (int k = row_ptr[i]; k < row_ptr[i + 1]; k++) sum -= values[k] * x[col_idx[k]];
+        x[i] = sum * inv_diag[i];
+    }
+
+public:
+    TriangularMatrix() : lower(true), row_ptr(1, 0) {}
+
+    // metodo para empezar a cargar una matriz; las filas se agregan en orden con add_entry y end_row
+    void begin(int n, bool is_lower) {
+        lower = is_lower;
+        row_ptr.assign(1, 0);
+        row_ptr.reserve(n + 1);
+        col_idx.clear();
+        values.clear();
+        inv_diag.clear();
+        inv_diag.reserve(n);
+    }
+
+    // metodo para agregar una entrada fuera de la diagonal a la fila actual
+    void add_entry(int col, float value) {
+        col_idx.push_back(col);
+        values.push_back(value);
+    }
+
+    // metodo para cerrar la fila actual con su diagonal
+    void end_row(float diagonal) {
+        inv_diag.push_back(diagonal != 0 ? 1 / diagonal : 1);
+        row_ptr.push_back((int)col_idx.size());
+    }
+
+    // metodo para cargar la traspuesta de T (la diagonal se conserva)
+    void transpose_of(const TriangularMatrix& T) {
+        int n = T.get_nrows();
+        lower = !T.lower;
+        row_ptr.assign(n + 1, 0);
+        for (int c : T.col_idx) row_ptr[c + 1]++;
+        for (int i = 0; i < n; i++) row_ptr[i + 1] += row_ptr[i];
+        col_idx.resize(T.col_idx.size());
+        values.resize(T.values.size());
+        std::vector<int> next(row_ptr.begin(), row_ptr.end() - 1);
+        for (int r = 0; r < n; r++)
+            for (int k = T.row_ptr[r]; k < T.row_ptr[r + 1]; k++) {
+                int dest = next[T.col_idx[k]]++;
+                col_idx[dest] = r;
+                values[dest] = T.values[k];
+            }
+        inv_diag = T.inv_diag;
+    }
+
+    // metodo para agrupar las filas por nivel; se llama una vez cargada la matriz
+    void build_levels() {
+        int n = get_nrows();
+        std::vector<int> level(n, 0);
+        int num_levels = n > 0 ? 1 : 0;
+        for (int step = 0; step < n; step++) {
+            int i = lower ? step : n - 1 - step;
+            for (int k = row_ptr[i]; k < row_ptr[i + 1]; k++) level[i] = std::max(level[i], level[col_idx[k]] + 1);
+            num_levels = std::max(num_levels, level[i] + 1);
+        }
+        level_start.assign(num_levels + 1, 0);
+        for (int i = 0; i < n; i++) level_start[level[i] + 1]++;
+        for (int l = 0; l < num_levels; l++) level_start[l + 1] += level_start[l];
+        std::vector<int> next(level_start.begin(), level_start.end() - 1);
+        level_rows.resize(n);
+        for (int i = 0; i < n; i++) level_rows[next[level[i]]++] = i;
+    }
+
+    // metodo para obtener la cantidad de filas
+    int get_nrows() const { return (int)inv_diag.size(); }
+
+    // metodo para obtener la cantidad de niveles
+    int get_num_levels() const { return level_start.empty() ? 0 : (int)level_start.size() - 1; }
+
+    // metodo para resolver las filas [begin, end) en orden, sin hilos (las demas filas de las que dependan ya deben estar resueltas)
+    void solve_rows(const float* b, float* x, int begin, int end) const {
+        if (lower)
+            for (int i = begin; i < end; i++) solve_row(b, x, i);
+        else
+            for (int i = end - 1; i >= begin; i--) solve_row(b, x, i);
+    }
+
+    // metodo para resolver T x = b por niveles; con pool, los niveles grandes se reparten entre sus hilos
+    void solve(const float* b, float* x, ThreadPool* pool) const {
+        if (pool == nullptr) {
+            solve_rows(b, x, 0, get_nrows());  // sin hilos, el orden natural recorre la memoria en secuencia
+            return;
+        }
+        for (int l = 0; l < get_num_levels(); l++) {
+            int first = level_start[l], last = level_start[l + 1];
+            if (last - first < LEVEL_PARALLEL_MIN_ROWS) {
+                for (int j = first; j < last; j++) solve_row(b, x, level_rows[j]);
+                continue;
+            }
+            int num_threads = parallel_width(pool);
+            pool->run_blocks(num_threads, [this, b, x, first, last, num_threads](int t) {
+                int begin = first + (int)((long long)(last - first) * t / num_threads);
+                int end = first + (int)((long long)(last - first) * (t + 1) / num_threads);
+                for (int j = begin; j < end; j++) solve_row(b, x, level_rows[j]);
+            });
+        }
+    }
+};
+
+/*
+  Factorizacion de Cholesky incompleta sin relleno, IC(0): L tiene el patron
+  del triangulo inferior de A y L L^T coincide con A en ese patron. Las
+  entradas de A con columna anterior a first_column[i] se descartan, lo que
+  permite factorizar por separado bloques diagonales (block-Jacobi). Cada
+  entrada l_ij es un producto escalar entre las filas i y j ya calculadas,
+  que se recorren en orden de columna. La diagonal de A se multiplica por
+  (1 + shift); devuelve la cantidad de pivotes no positivos, que se
+  reemplazan por la diagonal desplazada.
+ */
+int incomplete_cholesky(const SparseMatrix* A, const std::vector<int>& first_column, float shift, TriangularMatrix* L) {
+    int n = A->get_nrows();
+    const int* Ap = A->get_row_ptr();
+    const int* Aj = A->get_col_idx();
+    const float* Ax = A->get_values();
+    std::vector<int> Lp(1, 0), Lj;   // filas de L sin la diagonal
+    std::vector<double> Lx, diagonal(n);
+    int breakdowns = 0;
+
+    L->begin(n, true);
+    for (int i = 0; i < n; i++) {
+        int row_begin = (int)Lj.size();
+        for (int k = Ap[i]; k < Ap[i + 1] && Aj[k] < i; k++) {
+            int j = Aj[k];
+            if (j < first_column[i]) continue;
+            // producto de las filas i (lo ya calculado) y j en las columnas anteriores a j
+            double sum = Ax[k];
+            int p = row_begin, q = Lp[j];
+            while (p < (int)Lj.size() && q < Lp[j + 1]) {
+                if (Lj[p] == Lj[q]) sum -= Lx[p++] * Lx[q++];
+                else if (Lj[p] < Lj[q]) p++;
+                else q++;
+            }
+            Lj.push_back(j);
+            Lx.push_back(sum / diagonal[j]);
+        }
+        double d = A->get_diagonal(i) * (1.0 + shift);
+        double pivot = d;
+        for (int p = row_begin; p < (int)Lj.size(); p++) pivot -= Lx[p] * Lx[p];
+        if (pivot <= 0) {
+            breakdowns++;
+            pivot = d > 0 ? d : 1;
+        }
+        diagonal[i] = std::sqrt(pivot);
+        Lp.push_back((int)Lj.size());
+
+        for (int p = row_begin; p < (int)Lj.size(); p++) L->add_entry(Lj[p], (float)Lx[p]);
+        L->end_row((float)diagonal[i]);
+    }
+    return breakdowns;
+}
+
+// Precondicionador de Cholesky incompleto IC(0): z = (L L^T)^-1 r, con sustituciones por niveles
+class IC0Preconditioner : public Preconditioner {
+private:
+    TriangularMatrix L, U;             // factor y su traspuesta
+    ThreadPool* pool;                  // hilos de las sustituciones (nullptr: sin hilos)
+    std::vector<float> y;              // vector intermedio
+
+protected:
+    bool build(const SparseMatrix* A) override {
+        std::vector<int> first_column(A->get_nrows(), 0);
+        int breakdowns = 0;
+        for (float shift : FACTOR_SHIFTS)
+            if ((breakdowns = incomplete_cholesky(A, first_column, shift, &L)) == 0) break;
+        if (breakdowns > 0) diagnostic_stream(diagnostics) << "Warning: IC(0) found " << breakdowns << " non-positive pivots\n";
+        U.transpose_of(L);
+        L.build_levels();
+        U.build_levels();
+        y.resize(A->get_nrows());
+        return true;
+    }
+
+    void solve(const Vector* r, Vector* z) override {
+        L.solve(r->get_data(), y.data(), pool);
+        U.solve(y.data(), z->get_data(), pool);
+    }
+
+public:
+    explicit IC0Preconditioner(ThreadPool* threads = nullptr) : pool(threads) {}
+
+    const char* get_name() const override { return "ic0"; }
+
+    void report() const override {
+        std::cout << "\t\tIC(0): " << L.get_num_levels() << " niveles hacia adelante, "
+            << U.get_num_levels() << " hacia atras\n\n";
+    }
+};
+
+/*
+  Precondicionador de factorizacion LU incompleta sin relleno, ILU(0): L
+  (diagonal unitaria) y U tienen el patron de A y L U coincide con A en ese
+  patron. Se calcula fila por fila (variante IKJ) sobre una copia de los
+  valores de A. Para una matriz simetrica es equivalente a IC(0) escalado;
+  se ofrece para comparar y para sistemas no simetricos.
+ */
+class ILU0Preconditioner : public Preconditioner {
+private:
+    TriangularMatrix L, U;             // factores (L con diagonal unitaria)
+    ThreadPool* pool;                  // hilos de las sustituciones (nullptr: sin hilos)
+    std::vector<float> y;              // vector intermedio
+
+    // metodo para factorizar con la diagonal multiplicada por (1 + shift); devuelve la cantidad de pivotes no positivos
+    int factor(const SparseMatrix* A, float shift) {
+        int n = A->get_nrows();
+        const int* Ap = A->get_row_ptr();
+        const int* Aj = A->get_col_idx();
+        std::vector<double> LU(A->get_values(), A->get_values() + A->get_nnz());
+        std::vector<int> diagonal(n, -1), position(n, -1);
+        int breakdowns = 0;
+
+        for (int i = 0; i < n; i++) {
+            for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+                position[Aj[k]] = k;
+                if (Aj[k] == i) {
+                    diagonal[i] = k;
+                    LU[k] *= 1.0 + shift;
+                }
+            }
+            for (int k = Ap[i]; k < Ap[i + 1] && Aj[k] < i; k++) {
+                int row = Aj[k];
+                if (diagonal[row] < 0) continue;
+                LU[k] /= LU[diagonal[row]];
+                for (int m = diagonal[row] + 1; m < Ap[row + 1]; m++)
+                    if (position[Aj[m]] >= 0) LU[position[Aj[m]]] -= LU[k] * LU[m];
+            }
+            if (diagonal[i] < 0) {
+                breakdowns++;
+            }
+            else if (LU[diagonal[i]] <= 0) {
+                breakdowns++;
+                LU[diagonal[i]] = A->get_diagonal(i) > 0 ? A->get_diagonal(i) * (1.0 + shift) : 1;
+            }
+            for (int k = Ap[i]; k < Ap[i + 1]; k++) position[Aj[k]] = -1;
+        }
+
+        L.begin(n, true);
+        U.begin(n, false);
+        for (int i = 0; i < n; i++) {
+            for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+                if (Aj[k] < i) L.add_entry(Aj[k], (float)LU[k]);
+                else if (Aj[k] > i) U.add_entry(Aj[k], (float)LU[k]);
+            }
+            L.end_row(1);
+            U.end_row(diagonal[i] >= 0 ? (float)LU[diagonal[i]] : 1);
+        }
+        return breakdowns;
+    }
+
+protected:
+    bool build(const SparseMatrix* A) override {
+        int breakdowns = 0;
+        for (float shift : FACTOR_SHIFTS)
+            if ((breakdowns = factor(A, shift)) == 0) break;
+        if (breakdowns > 0) diagnostic_stream(diagnostics) << "Warning: ILU(0) found " << breakdowns << " non-positive pivots\n";
+        L.build_levels();
+        U.build_levels();
+        y.resize(A->get_nrows());
+        return true;
+    }
+
+    void solve(const Vector* r, Vector* z) override {
+        L.solve(r->get_data(), y.data(), pool);
+        U.solve(y.data(), z->get_data(), pool);
+    }
+
+public:
+    explicit ILU0Preconditioner(ThreadPool* threads = nullptr) : pool(threads) {}
+
+    const char* get_name() const override { return "ilu0"; }
+
+    void report() const override {
+        std::cout << "\t\tILU(0): " << L.get_num_levels() << " niveles hacia adelante, "
+            << U.get_num_levels() << " hacia atras\n\n";
+    }
+};
+
+/*
+  Precondicionador SSOR: M = w / (2 - w) (D / w + L) (D / w)^-1 (D / w + U),
+  con L, D y U las partes inferior, diagonal y superior de A. No necesita
+  factorizar: las sustituciones usan las entradas de A directamente.
+ */
+class SSORPreconditioner : public Preconditioner {
+private:
+    TriangularMatrix L, U;             // D / w + L y D / w + U
+    std::vector<float> scaled_diag;    // D / w
+    ThreadPool* pool;                  // hilos de las sustituciones (nullptr: sin hilos)
+    std::vector<float> y;              // vector intermedio
+
+protected:
+    bool build(const SparseMatrix* A) override {
+        int n = A->get_nrows();
+        const int* Ap = A->get_row_ptr();
+        const int* Aj = A->get_col_idx();
+        const float* Ax = A->get_values();
+        scaled_diag.resize(n);
+        L.begin(n, true);
+        U.begin(n, false);
+        for (int i = 0; i < n; i++) {
+            for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+                if (Aj[k] < i) L.add_entry(Aj[k], Ax[k]);
+                else if (Aj[k] > i) U.add_entry(Aj[k], Ax[k]);
+            }
+            scaled_diag[i] = A->get_diagonal(i) / SSOR_OMEGA;
+            L.end_row(scaled_diag[i]);
+            U.end_row(scaled_diag[i]);
+        }
+        L.build_levels();
+        U.build_levels();
+        y.resize(n);
+        return true;
+    }
+
+    void solve(const Vector* r, Vector* z) override {
+        int n = (int)y.size();
+        float scale = (2 - SSOR_OMEGA) / SSOR_OMEGA;
+        L.solve(r->get_data(), y.data(), pool);
+        for (int i = 0; i < n; i++) y[i] *= scaled_diag[i];
+        float* zv = z->get_data();
+        U.solve(y.data(), zv, pool);
+        for (int i = 0; i < n; i++) zv[i] *= scale;
+    }
+
+public:
+    explicit SSORPreconditioner(ThreadPool* threads = nullptr) : pool(threads) {}
+
+    const char* get_name() const override { return "ssor"; }
+};
+
+/*
+  Precondicionador block-Jacobi: las filas se dividen en un bloque contiguo
+  por hilo y cada bloque diagonal de A se factoriza con IC(0) descartando
+  los acoples con los demas bloques. Cada hilo resuelve su bloque completo
+  sin sincronizarse con los demas, a cambio de un precondicionador algo mas
+  debil que IC(0) sobre toda la matriz.
+ */
+class BlockJacobiPreconditioner : public Preconditioner {
+private:
+    TriangularMatrix L, U;             // factores de todos los bloques
+    ThreadPool* pool;                  // hilos de los bloques (nullptr: un solo bloque)
+    std::vector<int> block_start;      // primera fila de cada bloque (un bloque por hilo, mas el final)
+
+protected:
+    bool build(const SparseMatrix* A) override {
+        int n = A->get_nrows();
+        int blocks = std::max(1, std::min(parallel_width(pool), n));
+        block_start.resize(blocks + 1);
+        std::vector<int> first_column(n);
+        for (int b = 0; b <= blocks; b++) block_start[b] = (int)((long long)n * b / blocks);
+        for (int b = 0; b < blocks; b++)
+            for (int i = block_start[b]; i < block_start[b + 1]; i++) first_column[i] = block_start[b];
+
+        int breakdowns = 0;
+        for (float shift : FACTOR_SHIFTS)
+            if ((breakdowns = incomplete_cholesky(A, first_column, shift, &L)) == 0) break;
+        if (breakdowns > 0) diagnostic_stream(diagnostics) << "Warning: block-Jacobi IC(0) found " << breakdowns << " non-positive pivots\n";
+        U.transpose_of(L);
+        return true;
+    }
+
+    void solve(const Vector* r, Vector* z) override {
+        const float* rv = r->get_data();
+        float* zv = z->get_data();
+        int blocks = (int)block_start.size() - 1;
+        auto solve_block = [this, rv, zv](int b) {
+            L.solve_rows(rv, zv, block_start[b], block_start[b + 1]);
+            U.solve_rows(zv, zv, block_start[b], block_start[b + 1]);
+        };
+        if (pool == nullptr) {
+            for (int b = 0; b < blocks; b++) solve_block(b);
+            return;
+        }
+        pool->run_blocks(blocks, solve_block);
+    }
+
+public:
+    explicit BlockJacobiPreconditioner(ThreadPool* threads = nullptr) : pool(threads) {}
+
+    const char* get_name() const override { return "block-jacobi"; }
+};
+
+#endif  // SIMU_PROJEKT_PRECONDITIONERS_HPP
\ No newline at end of file
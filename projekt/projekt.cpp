@@ -1,60 +1,132 @@
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
 
 
 #include "mesh.hpp"
 #include "input_output.hpp"
 #include "matrix_operations.hpp"
 #include "mef_process.hpp"
+#include "mef_solver.hpp"
+#include "out_of_core.hpp"
+#include "adaptive_refinement.hpp"
+#include "batch_process.hpp"
+#include "mesh_reordering.hpp"
+#include "solver_options.hpp"
 
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cout << "Incorrect use of the program, it must be: mef filename\n"; 
+    SolverOptions options;
+
+    if (argc >= 3 && std::string(argv[1]) == "-batch") {
+        // modo por lotes: mef -batch manifest [-threads N] [-max-jobs M] [solver options]
+        int num_threads = (int)std::thread::hardware_concurrency();
+        if (num_threads < 3) num_threads = 3;
+        int max_jobs = num_threads;
+        for (int i = 3; i < argc; i++) {
+            std::string option(argv[i]);
+            if (option == "-threads" || option == "-max-jobs") {
+                if (i + 1 >= argc || !parse_int_value(argv[i + 1], 1, option == "-threads" ? &num_threads : &max_jobs)) {
+                    std::cout << "Invalid value for " << option << "\n";
+                    exit(EXIT_FAILURE);
+                }
+                i++;
+            }
+            else if (!parse_solver_option(argc, argv, &i, &options)) {
+                std::cout << "Unknown option or invalid value: " << option << "\n";
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (!check_solver_options(options)) exit(EXIT_FAILURE);
+        return run_batch(argv[2], num_threads, max_jobs, options) ? 0 : EXIT_FAILURE;
+    }
+
+    for (int i = 2; i < argc; i++)
+        if (!parse_solver_option(argc, argv, &i, &options)) {
+            std::cout << "Unknown option or invalid value: " << argv[i] << "\n";
+            exit(EXIT_FAILURE);
+        }
+    if (!check_solver_options(options)) exit(EXIT_FAILURE);
+
+    if (argc < 2) {
+        std::cout << "Incorrect use of the program, it must be: mef filename [solver options]\n"; 
+        std::cout << "or: mef -batch manifest [-threads N] [-max-jobs M] [solver options]\n";
+        std::cout << "solver options: -solver auto|dense|skyline|pcg-jacobi|pcg-amg|dd|pcg-mf|ooc -parts P -smoother gauss-seidel|chebyshev\n";
+        std::cout << "                -precond jacobi|ssor|ilu0|ic0|block-jacobi|amg (preconditioner of pcg-jacobi and pcg-amg) -tol value -maxit value\n";
+        std::cout << "                -memory MB (budget of the automatic plan and the out-of-core solver) -scratch directory\n";
+        std::cout << "                -assembly scatter|triplets -storage full|symmetric (iterative solvers)\n";
+        std::cout << "                -cache on|off (reuse the skyline factorization across runs, stored in the scratch directory)\n";
+        std::cout << "                -flux on|off (write temperature gradients and heat flux with the results)\n";
+        std::cout << "                -reorder none|morton|hilbert -reorder-nodes on|off -reorder-report on|off (space-filling-curve mesh ordering)\n";
+        std::cout << "                -kt table (temperature-dependent conductivity, lines \"T k\"; replaces k of the input file;\n";
+        std::cout << "                solved on the sparse system, so only with -solver auto|pcg-jacobi|pcg-amg)\n";
+        std::cout << "                -nonlinear picard|newton -nl-tol value -nl-maxit value (iteration used with -kt)\n";
+        std::cout << "                -adapt tolerance -adapt-steps value (adaptive refinement, Tet4 meshes)\n";
+        std::cout << "                -output-nodes file -output-box xmin,ymin,zmin,xmax,ymax,zmax -output-surface on|off\n";
+        std::cout << "                -output-stride value (write a subset of the results) -precision-T digits -precision-flux digits\n";
         exit(EXIT_FAILURE);
     }
 
-    Mesh M;
+    // un solo pool de hilos para todas las etapas; el hilo principal tambien trabaja
+    std::unique_ptr<ThreadPool> pool(options.num_threads > 1 ? new ThreadPool(options.num_threads - 1) : nullptr);
+    options.pool = pool.get();
 
-    std::cout << "Reading geometry and mesh data...\n\n";
     std::string filename(argv[1]);
-    read_input(filename, &M);
-    M.report();
-
-    int num_nodes = M.get_quantity(NUM_NODES);
-    int num_elements = M.get_quantity(NUM_ELEMENTS);
-    Matrix K(num_nodes, num_nodes), local_Ks[NUM_ELEMENTS];
-    Vector b(num_nodes), local_bs[NUM_ELEMENTS];
-
-    std::cout << "Creating local systems...\n\n";
-    create_local_systems(local_Ks, local_bs, num_elements, &M);
-
-    std::cout << "Performing Assembly...\n\n";
-    assembly(&K, &b, local_Ks, local_bs, num_elements, &M);
-
-    //K.show();
-    //b.show();
-
-    std::cout << "Applying Neumann Boundary Conditions...\n\n";
-    apply_neumann_boundary_conditions(&b, &M);
-
-    //b.show();
-
-    std::cout << "Applying Dirichlet Boundary Conditions...\n\n";
-    apply_dirichlet_boundary_conditions(&K, &b, &M);
-
-    //K.show();
-    //b.show();
-
-    std::cout << "Solving global system...\n\n";
-    Vector T(b.get_size()), T_full(num_nodes);
-    solve_system(&K, &b, &T);
-    //T.show();
-
-    std::cout << "Preparing results...\n\n";
-    merge_results_with_dirichlet(&T, &T_full, num_nodes, &M);
-    //T_full.show();
+    Vector T_full;
+    FluxField flux;
+    bool has_flux = false;
+    OutputFilter filter;
+
+    if (options.solver == SOLVER_OUT_OF_CORE) {
+        // la malla no se carga: los elementos se leen por bloques durante el ensamblaje
+        if (options.output.needs_mesh()) {
+            std::cerr << "Error: -output-box and -output-surface need the mesh in memory (not available with -solver ooc)\n";
+            exit(EXIT_FAILURE);
+        }
+        if (!solve_problem_out_of_core(filename, &T_full, options)) exit(EXIT_FAILURE);
+        if (!filter.build(options.output, T_full.get_size())) exit(EXIT_FAILURE);
+    }
+    else {
+        Mesh M;
+
+        std::cout << "Reading geometry and mesh data...\n\n";
+        if (!read_input(filename, &M, options.pool)) exit(EXIT_FAILURE);
+        M.report();
+
+        // las temperaturas se devuelven a la numeracion del archivo antes de escribirlas
+        MeshOrdering ordering;
+        if (options.ordering != ORDER_NONE) reorder_mesh(&M, options, &ordering);
+
+        if (options.adapt_tolerance > 0) {
+            // los resultados corresponden a la malla refinada, que se escribe junto a ellos
+            std::unique_ptr<Mesh> refined;
+            if (!solve_problem_adaptive(&M, &T_full, options, &refined)) exit(EXIT_FAILURE);
+            std::cout << "Writing refined mesh...\n\n";
+            write_mesh(filename, refined ? refined.get() : &M);
+            if (options.compute_flux) {
+                compute_flux(refined ? refined.get() : &M, &T_full, &flux, options.pool);
+                has_flux = true;
+            }
+            if (!filter.build(options.output, T_full.get_size(), refined ? refined.get() : &M)) exit(EXIT_FAILURE);
+        }
+        else {
+            int num_nodes = M.get_quantity(NUM_NODES);
+            T_full.set_size(num_nodes);
+            if (!run_mef(&M, &T_full, options)) exit(EXIT_FAILURE);
+            //T_full.show();
+            if (options.compute_flux) {
+                std::cout << "Computing heat flux...\n\n";
+                compute_flux(&M, &T_full, &flux, options.pool, &options.conductivity);
+                has_flux = true;
+            }
+            // la seleccion de resultados se arma sobre la malla reordenada pero en la numeracion del archivo
+            if (!filter.build(options.output, num_nodes, &M, &ordering.node_order)) exit(EXIT_FAILURE);
+            restore_node_order(ordering, &T_full, has_flux ? &flux : nullptr);
+        }
+    }
 
     std::cout << "Writing output file...\n\n";
-    write_output(filename, &T_full);
+    write_output(filename, &T_full, true, has_flux ? &flux : nullptr, &filter);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,293 @@
+#ifndef SIMU_PROJEKT_SKYLINE_HPP
+#define SIMU_PROJEKT_SKYLINE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "sparse_matrix.hpp"
+#include "vector.hpp"
+
+const unsigned int SKYLINE_FILE_VERSION = 1;  // version del formato de los archivos de factorizacion
+
+// Encabezado del archivo de factorizacion; le siguen order[n], first[n] (int) y las entradas del perfil (float)
+struct SkylineFileHeader {
+    char magic[8];             // "SKYLINE" terminado en cero
+    unsigned int version;      // SKYLINE_FILE_VERSION
+    unsigned int value_size;   // sizeof(float)
+    unsigned long long key;    // clave del sistema factorizado (ver factor_cache.hpp)
+    long long n;               // grados de libertad
+    long long profile;         // entradas del perfil
+};
+
+/*
+  Ordenamiento de Cuthill-McKee inverso (RCM) de un grafo simetrico de n
+  vertices. Los vecinos se recorren con neighbors(v, visit), que llama a
+  visit(w) una vez por cada vecino w != v; asi el mismo ordenamiento sirve
+  para una matriz CSR y para la conectividad de la malla sin armar la
+  adyacencia. En cada componente conexa se parte de un nodo
+  pseudo-periferico (el de menor grado del ultimo nivel de una busqueda en
+  anchura desde el de menor grado) y los vecinos se agregan por grado
+  creciente. order[p] es el vertice que queda en la posicion p.
+ */
+template <class Neighbors>
+void reverse_cuthill_mckee(int n, Neighbors neighbors, std::vector<int>* order) {
+    std::vector<int> degree(n, 0);
+    for (int v = 0; v < n; v++) neighbors(v, [&degree, v](int) { degree[v]++; });
+
+    std::vector<int> level(n, -1);
+    std::vector<char> visited(n, 0);
+    std::vector<int> queue, candidates;
+    order->clear();
+    order->reserve(n);
+
+    // busqueda en anchura desde start sobre los vertices no visitados; devuelve el de menor grado del ultimo nivel
+    auto last_level_node = [&](int start) {
+        queue.assign(1, start);
+        level[start] = 0;
+        int best = start;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int v = queue[head];
+            if (level[v] > level[best] || (level[v] == level[best] && degree[v] < degree[best])) best = v;
+            neighbors(v, [&](int w) {
+                if (!visited[w] && level[w] < 0) {
+                    level[w] = level[v] + 1;
+                    queue.push_back(w);
+                }
+            });
+        }
+        for (int v : queue) level[v] = -1;
+        return best;
+    };
+
+    std::vector<int> by_degree(n);
+    for (int v = 0; v < n; v++) by_degree[v] = v;
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&degree](int a, int b) { return degree[a] < degree[b]; });
+
+    for (int seed : by_degree) {
+        if (visited[seed]) continue;
+        int start = last_level_node(seed);
+
+        size_t head = order->size();
+        order->push_back(start);
+        visited[start] = 1;
+        for (; head < order->size(); head++) {
+            candidates.clear();
+            neighbors((*order)[head], [&](int w) {
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    candidates.push_back(w);
+                }
+            });
+            std::sort(candidates.begin(), candidates.end(), [&degree](int a, int b) {
+                return degree[a] != degree[b] ? degree[a] < degree[b] : a < b;
+            });
+            order->insert(order->end(), candidates.begin(), candidates.end());
+        }
+    }
+    std::reverse(order->begin(), order->end());
+}
+
+/*
+  Perfil (envolvente) del triangulo inferior con el ordenamiento dado:
+  width[p] es la cantidad de entradas de la fila p desde su primera columna
+  no nula hasta la diagonal inclusive. Devuelve la suma de los anchos, que
+  es la memoria de la factorizacion de Cholesky en almacenamiento skyline
+  (el relleno queda dentro de la envolvente).
+ */
+template <class Neighbors>
+long long envelope_profile(int n, Neighbors neighbors, const std::vector<int>& order, std::vector<int>* width) {
+    std::vector<int> position(n);
+    for (int p = 0; p < n; p++) position[order[p]] = p;
+    width->resize(n);
+    long long profile = 0;
+    for (int p = 0; p < n; p++) {
+        int first = p;
+        neighbors(order[p], [&](int w) { first = std::min(first, position[w]); });
+        (*width)[p] = p - first + 1;
+        profile += (*width)[p];
+    }
+    return profile;
+}
+
+/*
+  Factorizacion de Cholesky directa para matrices dispersas simetricas
+  definidas positivas, en almacenamiento skyline por filas: la matriz se
+  reordena con RCM para reducir la envolvente y cada fila del factor L
+  guarda las entradas desde su primera columna no nula hasta la diagonal,
+  de forma contigua. Todo el relleno de Cholesky queda dentro de la
+  envolvente, de modo que la memoria se conoce antes de factorizar.
+
+  Cada entrada L[i][j] es un producto escalar entre dos tramos contiguos de
+  las filas i y j, que se acumula en doble precision.
+
+  El factor se puede guardar en un archivo binario (save) y recuperar en
+  otra ejecucion (load); al recuperarlo las entradas del perfil se usan
+  directamente desde el archivo proyectado en memoria, sin copiarlas.
+ */
+class SkylineCholesky {
+private:
+    int n;                       // grados de libertad
+    std::vector<int> order;      // fila original en cada posicion
+    std::vector<int> position;   // posicion de cada fila original
+    std::vector<int> first;      // primera columna de cada fila del factor
+    std::vector<size_t> offset;  // values[offset[i] + j] es L[i][j] (aritmetica modular: offset puede "pasar" de cero)
+    std::vector<float> values;   // filas del factor, concatenadas (vacio si el factor viene de un archivo)
+    MappedFile mapped;           // archivo de factorizacion proyectado
+    const float* L_rows;         // filas del factor: values o el contenido de mapped
+    size_t profile_size;         // entradas del perfil
+
+    // metodo para calcular offset a partir de first; devuelve la cantidad de entradas del perfil
+    size_t build_offsets() {
+        offset.resize(n);
+        size_t size = 0;
+        for (int i = 0; i < n; i++) {
+            offset[i] = size - (size_t)first[i];
+            size += (size_t)(i - first[i] + 1);
+        }
+        return size;
+    }
+
+public:
+    SkylineCholesky() : n(0), L_rows(nullptr), profile_size(0) {}
+
+    // metodo para obtener la cantidad de entradas del perfil
+    size_t get_profile_size() const { return profile_size; }
+
+    // metodo para factorizar K; devuelve false si K no es definida positiva
+    bool factor(const SparseMatrix* K) {
+        n = K->get_nrows();
+        const int* row_ptr = K->get_row_ptr();
+        const int* col_idx = K->get_col_idx();
+        const float* K_values = K->get_values();
+        auto neighbors = [row_ptr, col_idx](int v, auto visit) {
+            for (int j = row_ptr[v]; j < row_ptr[v + 1]; j++)
+                if (col_idx[j] != v) visit(col_idx[j]);
+        };
+
+        reverse_cuthill_mckee(n, neighbors, &order);
+        std::vector<int> width;
+        envelope_profile(n, neighbors, order, &width);
+        position.resize(n);
+        for (int p = 0; p < n; p++) position[order[p]] = p;
+
+        first.resize(n);
+        for (int i = 0; i < n; i++) first[i] = i - width[i] + 1;
+        mapped.close();
+        profile_size = build_offsets();
+        values.assign(profile_size, 0.0f);
+        float* L = values.data();
+        L_rows = L;
+
+        // copiar el triangulo inferior de la matriz reordenada
+        for (int r = 0; r < n; r++) {
+            int i = position[r];
+            for (int j = row_ptr[r]; j < row_ptr[r + 1]; j++) {
+                int c = position[col_idx[j]];
+                if (c <= i) L[offset[i] + c] = K_values[j];
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            size_t row_i = offset[i];
+            for (int j = first[i]; j <= i; j++) {
+                size_t row_j = offset[j];
+                double sum = L[row_i + j];
+                for (int k = std::max(first[i], first[j]); k < j; k++) sum -= (double)L[row_i + k] * L[row_j + k];
+                if (j < i) {
+                    L[row_i + j] = (float)(sum / L[row_j + j]);
+                }
+                else {
+                    if (sum <= 0) return false;
+                    L[row_i + i] = (float)std::sqrt(sum);
+                }
+            }
+        }
+        return true;
+    }
+
+    // metodo para guardar el factor en path con la clave key; devuelve false si no se puede escribir
+    bool save(const std::string& path, unsigned long long key) const {
+        SkylineFileHeader header;
+        memset(&header, 0, sizeof(header));
+        strcpy(header.magic, "SKYLINE");
+        header.version = SKYLINE_FILE_VERSION;
+        header.value_size = sizeof(float);
+        header.key = key;
+        header.n = n;
+        header.profile = (long long)profile_size;
+
+        // se escribe en un temporal y se renombra, para que otra ejecucion nunca lea un archivo a medias
+        std::string temporary = path + ".tmp";
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file) return false;
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)order.data(), sizeof(int) * (size_t)n);
+        file.write((const char*)first.data(), sizeof(int) * (size_t)n);
+        file.write((const char*)L_rows, sizeof(float) * profile_size);
+        file.close();
+        if (file.fail()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        std::remove(path.c_str());
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+    // metodo para recuperar un factor guardado con save; devuelve false si el archivo no existe o no corresponde a key
+    bool load(const std::string& path, unsigned long long key) {
+        mapped.close();
+        if (!mapped.open(path) || mapped.get_size() < sizeof(SkylineFileHeader)) return false;
+        const char* data = (const char*)mapped.get_data();
+        SkylineFileHeader header;
+        memcpy(&header, data, sizeof(header));
+        if (strcmp(header.magic, "SKYLINE") != 0 || header.version != SKYLINE_FILE_VERSION
+            || header.value_size != sizeof(float) || header.key != key || header.n < 0
+            || mapped.get_size() != sizeof(header) + 2 * sizeof(int) * (size_t)header.n + sizeof(float) * (size_t)header.profile) {
+            mapped.close();
+            return false;
+        }
+
+        n = (int)header.n;
+        order.resize(n);
+        first.resize(n);
+        memcpy(order.data(), data + sizeof(header), sizeof(int) * (size_t)n);
+        memcpy(first.data(), data + sizeof(header) + sizeof(int) * (size_t)n, sizeof(int) * (size_t)n);
+        for (int i = 0; i < n; i++)
+            if (first[i] < 0 || first[i] > i || order[i] < 0 || order[i] >= n) {
+                mapped.close();
+                return false;
+            }
+        if (build_offsets() != (size_t)header.profile) {
+            mapped.close();
+            return false;
+        }
+        profile_size = (size_t)header.profile;
+        values.clear();
+        L_rows = (const float*)(data + sizeof(header) + 2 * sizeof(int) * (size_t)n);
+        return true;
+    }
+
+    // metodo para resolver K x = b con el factor: sustitucion hacia adelante con L y hacia atras con L^T
+    void solve(const Vector* b, Vector* x) const {
+        const float* L = L_rows;
+        std::vector<double> y(n);
+        for (int i = 0; i < n; i++) {
+            double sum = b->get(order[i]);
+            for (int k = first[i]; k < i; k++) sum -= L[offset[i] + k] * y[k];
+            y[i] = sum / L[offset[i] + i];
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            y[i] /= L[offset[i] + i];
+            for (int k = first[i]; k < i; k++) y[k] -= L[offset[i] + k] * y[i];
+        }
+        for (int i = 0; i < n; i++) x->set((float)y[i], order[i]);
+    }
+};
+
+#endif  // SIMU_PROJEKT_SKYLINE_HPP
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "solver.hpp"
+#include "flux_postprocess.hpp"
+#include "mef_solver.hpp"
+#include "mesh.hpp"
+#include "mesh_reordering.hpp"
+#include "solver_options.hpp"
+#include "vector.hpp"
+
+// Datos de un Solver: el modelo tal como se recibio, la malla armada a partir de el y los resultados
+struct Solver::Impl {
+    SolverOptions options;                        // opciones de solucion (sin mensajes ni avisos)
+    std::unique_ptr<ThreadPool> pool;             // hilos de todas las etapas de la solucion (nullptr con un hilo)
+    float k = 1, Q = 0;                           // conductividad y fuente de calor
+    std::vector<float> coordinates;               // x, y, z de cada nodo
+    std::vector<char> element_family;             // familia de cada elemento (element_type)
+    std::vector<int> element_start;               // primer nodo de cada elemento en element_nodes (num_elements + 1)
+    std::vector<int> element_nodes;               // nodos de todos los elementos, concatenados
+    std::vector<int> dirichlet_nodes, neumann_nodes;
+    std::vector<float> dirichlet_values, neumann_values;
+    std::unique_ptr<Mesh> mesh;                   // malla armada en la ultima solucion (nullptr si el modelo cambio)
+    MeshOrdering ordering;                        // permutacion de los nodos de la malla (ver options.ordering)
+    Vector T_full;                                // temperaturas de la ultima solucion
+    FluxField flux;                               // flujo de calor de la ultima solucion
+    bool solved = false;                          // indica si T_full corresponde al modelo actual
+    bool has_flux = false;                        // indica si flux corresponde al modelo actual
+    SolveReport report;                           // iteraciones y residuo de la ultima solucion
+
+    Impl() : element_start(1, 0) {
+        options.verbose = false;
+        options.diagnostics = nullptr;
+        options.num_threads = 1;
+        options.num_parts = 1;
+    }
+
+    int get_num_nodes() const { return (int)(coordinates.size() / 3); }
+
+    // metodo para descartar la malla y los resultados cuando cambia el modelo
+    void invalidate() {
+        mesh.reset();
+        solved = false;
+        has_flux = false;
+    }
+
+    // metodo para copiar condiciones nodales verificando los indices
+    bool copy_conditions(int count, const int* nodes, const float* values, std::vector<int>* node_list,
+        std::vector<float>* value_list) const {
+        if (count < 0 || (count > 0 && (nodes == nullptr || values == nullptr))) return false;
+        for (int i = 0; i < count; i++)
+            if (nodes[i] < 0 || nodes[i] >= get_num_nodes()) return false;
+        node_list->assign(nodes, nodes + count);
+        value_list->assign(values, values + count);
+        return true;
+    }
+
+    // metodo para armar la malla a partir del modelo, igual que read_input a partir de un archivo
+    solver_status build_mesh() {
+        int num_nodes = get_num_nodes();
+        int num_elements = (int)element_family.size();
+        std::unique_ptr<Mesh> M(new Mesh());
+
+        M->set_problem_data(k, Q);
+        M->set_quantities(num_nodes, num_elements, (int)dirichlet_nodes.size(), (int)neumann_nodes.size());
+        M->init_arrays();
+        for (int i = 0; i < num_nodes; i++)
+            M->insert_node(M->create_node(i + 1, coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]), i);
+        for (int e = 0; e < num_elements; e++) {
+            Node* nodes[MAX_ELEMENT_NODES];
+            for (int j = element_start[e]; j < element_start[e + 1]; j++)
+                nodes[j - element_start[e]] = M->get_node(element_nodes[j]);
+            M->insert_element(M->create_element(e + 1, (element_type)element_family[e], nodes), e);
+        }
+        for (int c = 0; c < (int)dirichlet_nodes.size(); c++)
+            M->insert_dirichlet_condition(M->create_condition(M->get_node(dirichlet_nodes[c]), dirichlet_values[c]), c);
+        for (int c = 0; c < (int)neumann_nodes.size(); c++)
+            M->insert_neumann_condition(M->create_condition(M->get_node(neumann_nodes[c]), neumann_values[c]), c);
+
+        M->build_dof_map();
+        if (M->build_geometry() > 0) return SOLVER_STATUS_DEGENERATE_MESH;
+        ordering.node_order.clear();
+        if (options.ordering != ORDER_NONE) reorder_mesh(M.get(), options, &ordering);
+        mesh = std::move(M);
+        return SOLVER_STATUS_OK;
+    }
+};
+
+const char* solver_status_name(solver_status status) {
+    switch (status) {
+    case SOLVER_STATUS_OK: return "ok";
+    case SOLVER_STATUS_INVALID_INPUT: return "invalid input";
+    case SOLVER_STATUS_NO_MODEL: return "no model";
+    case SOLVER_STATUS_DEGENERATE_MESH: return "degenerate mesh";
+    case SOLVER_STATUS_SOLVE_FAILED: return "solve failed";
+    case SOLVER_STATUS_NO_SOLUTION: return "no solution";
+    case SOLVER_STATUS_NOT_CONVERGED: return "not converged";
+    }
+    return "unknown";
+}
+
+Solver::Solver() : impl(new Impl()) {}
+
+Solver::~Solver() = default;
+
+Solver::Solver(Solver&& other) noexcept = default;
+
+Solver& Solver::operator=(Solver&& other) noexcept = default;
+
+solver_status Solver::set_option(const char* option, const char* value) {
+    if (option == nullptr || value == nullptr) return SOLVER_STATUS_INVALID_INPUT;
+    // el refinamiento adaptativo cambiaria la malla de quien llama y la solucion fuera de memoria lee un archivo
+    if (strcmp(option, "-adapt") == 0 || strcmp(option, "-adapt-steps") == 0) return SOLVER_STATUS_INVALID_INPUT;
+
+    char* argv[2] = { const_cast<char*>(option), const_cast<char*>(value) };
+    int i = 0;
+    SolverOptions options = impl->options;
+    if (!parse_solver_option(2, argv, &i, &options) || options.solver == SOLVER_OUT_OF_CORE)
+        return SOLVER_STATUS_INVALID_INPUT;
+    // la tabla k(T) solo se resuelve con el sistema disperso ensamblado
+    if (!options.conductivity.empty() && !solver_supports_conductivity_table(options.solver))
+        return SOLVER_STATUS_INVALID_INPUT;
+    impl->options = options;
+    // el orden de la malla se aplica al armarla
+    if (strncmp(option, "-reorder", 8) == 0) impl->mesh.reset();
+    impl->solved = false;
+    impl->has_flux = false;
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::set_num_threads(int num_threads) {
+    if (num_threads < 1) return SOLVER_STATUS_INVALID_INPUT;
+    impl->options.num_threads = num_threads;
+    impl->pool.reset(num_threads > 1 ? new ThreadPool(num_threads - 1) : nullptr);
+    impl->options.pool = impl->pool.get();
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::set_material(float k, float Q) {
+    if (!(k > 0)) return SOLVER_STATUS_INVALID_INPUT;
+    impl->k = k;
+    impl->Q = Q;
+    impl->invalidate();
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::set_nodes(int num_nodes, const float* coordinates) {
+    if (num_nodes <= 0 || coordinates == nullptr) return SOLVER_STATUS_INVALID_INPUT;
+    impl->coordinates.assign(coordinates, coordinates + 3 * (size_t)num_nodes);
+    impl->element_family.clear();
+    impl->element_start.assign(1, 0);
+    impl->element_nodes.clear();
+    impl->dirichlet_nodes.clear();
+    impl->dirichlet_values.clear();
+    impl->neumann_nodes.clear();
+    impl->neumann_values.clear();
+    impl->invalidate();
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::add_elements(int num_elements, int nodes_per_element, const int* connectivity) {
+    if (impl->coordinates.empty()) return SOLVER_STATUS_NO_MODEL;
+    if (num_elements < 0 || (num_elements > 0 && connectivity == nullptr)) return SOLVER_STATUS_INVALID_INPUT;
+
+    int family = -1;
+    for (int f : { ELEMENT_TET4, ELEMENT_TET10, ELEMENT_HEX8 })
+        if (element_num_nodes((element_type)f) == nodes_per_element) family = f;
+    if (family < 0) return SOLVER_STATUS_INVALID_INPUT;
+    size_t count = (size_t)num_elements * nodes_per_element;
+    for (size_t j = 0; j < count; j++)
+        if (connectivity[j] < 0 || connectivity[j] >= impl->get_num_nodes()) return SOLVER_STATUS_INVALID_INPUT;
+
+    for (int e = 0; e < num_elements; e++) {
+        impl->element_family.push_back((char)family);
+        impl->element_start.push_back(impl->element_start.back() + nodes_per_element);
+    }
+    impl->element_nodes.insert(impl->element_nodes.end(), connectivity, connectivity + count);
+    impl->invalidate();
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::set_dirichlet(int count, const int* nodes, const float* values) {
+    if (!impl->copy_conditions(count, nodes, values, &impl->dirichlet_nodes, &impl->dirichlet_values))
+        return SOLVER_STATUS_INVALID_INPUT;
+    impl->invalidate();
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::set_neumann(int count, const int* nodes, const float* values) {
+    if (!impl->copy_conditions(count, nodes, values, &impl->neumann_nodes, &impl->neumann_values))
+        return SOLVER_STATUS_INVALID_INPUT;
+    impl->invalidate();
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::solve() {
+    if (impl->coordinates.empty() || impl->element_family.empty()) return SOLVER_STATUS_NO_MODEL;
+    // sin temperaturas impuestas K es singular
+    if (impl->dirichlet_nodes.empty()) return SOLVER_STATUS_INVALID_INPUT;
+
+    impl->solved = false;
+    impl->has_flux = false;
+    if (impl->mesh == nullptr) {
+        solver_status status = impl->build_mesh();
+        if (status != SOLVER_STATUS_OK) return status;
+    }
+
+    Mesh* M = impl->mesh.get();
+    impl->T_full.set_size(impl->get_num_nodes());
+    impl->report = SolveReport();
+    // sin convergencia la ultima iteracion se entrega igual, con SOLVER_STATUS_NOT_CONVERGED
+    if (!run_mef(M, &impl->T_full, impl->options, &impl->report) && impl->report.converged)
+        return SOLVER_STATUS_SOLVE_FAILED;
+    if (impl->options.compute_flux) {
+        compute_flux(M, &impl->T_full, &impl->flux, impl->options.pool, &impl->options.conductivity);
+        impl->has_flux = true;
+    }
+    restore_node_order(impl->ordering, &impl->T_full, impl->has_flux ? &impl->flux : nullptr);
+    impl->solved = true;
+    return impl->report.converged ? SOLVER_STATUS_OK : SOLVER_STATUS_NOT_CONVERGED;
+}
+
+int Solver::get_iterations() const {
+    return impl->report.iterations;
+}
+
+double Solver::get_residual() const {
+    return impl->report.residual;
+}
+
+int Solver::get_num_nodes() const {
+    return impl->get_num_nodes();
+}
+
+solver_status Solver::get_temperatures(float* temperatures) const {
+    if (!impl->solved) return SOLVER_STATUS_NO_SOLUTION;
+    if (temperatures == nullptr) return SOLVER_STATUS_INVALID_INPUT;
+    memcpy(temperatures, impl->T_full.get_data(), sizeof(float) * (size_t)impl->get_num_nodes());
+    return SOLVER_STATUS_OK;
+}
+
+solver_status Solver::get_heat_flux(float* flux) const {
+    if (!impl->has_flux) return SOLVER_STATUS_NO_SOLUTION;
+    if (flux == nullptr) return SOLVER_STATUS_INVALID_INPUT;
+    memcpy(flux, impl->flux.nodal_flux.data(), sizeof(float) * impl->flux.nodal_flux.size());
+    return SOLVER_STATUS_OK;
+}
\ No newline at end of file
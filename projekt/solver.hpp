@@ -0,0 +1,103 @@
+#ifndef SIMU_PROJEKT_SOLVER_HPP
+#define SIMU_PROJEKT_SOLVER_HPP
+
+#include <memory>
+
+// Resultado de las operaciones de Solver
+enum solver_status {
+    SOLVER_STATUS_OK,               // operacion completada
+    SOLVER_STATUS_INVALID_INPUT,    // datos u opcion no validos (indices fuera de rango, familia desconocida, ...)
+    SOLVER_STATUS_NO_MODEL,         // faltan los nodos o los elementos del modelo
+    SOLVER_STATUS_DEGENERATE_MESH,  // hay elementos de volumen nulo
+    SOLVER_STATUS_SOLVE_FAILED,     // el sistema no se pudo resolver (K no es definida positiva)
+    SOLVER_STATUS_NO_SOLUTION,      // se pidieron resultados antes de resolver
+    SOLVER_STATUS_NOT_CONVERGED     // la iteracion no alcanzo la tolerancia; los resultados son los de la ultima iteracion
+};
+
+// funcion para obtener una descripcion corta de un resultado
+const char* solver_status_name(solver_status status);
+
+/*
+  Interfaz de biblioteca del programa: un Solver guarda un modelo recibido en
+  arreglos de memoria (sin archivos), es duenio de su malla, sus resultados,
+  sus opciones y su pool de hilos, y devuelve un solver_status en lugar de mostrar mensajes o
+  terminar el proceso. Cada objeto es independiente, asi que se pueden
+  resolver varios modelos a la vez desde hilos distintos, un Solver por
+  hilo; un mismo Solver no debe usarse desde dos hilos al mismo tiempo.
+
+  Los nodos se numeran desde 0 y la conectividad de cada elemento sigue el
+  orden de nodos de los archivos .dat de su familia (4 nodos: Tet4, 10
+  nodos: Tet10, 8 nodos: Hex8). Uso tipico:
+
+    Solver solver;
+    solver.set_material(k, Q);
+    solver.set_nodes(num_nodes, coordinates);        // x, y, z por nodo
+    solver.add_elements(num_tets, 4, connectivity);  // se puede llamar una vez por familia
+    solver.set_dirichlet(count, nodes, values);
+    solver.set_neumann(count, nodes, values);
+    if (solver.solve() == SOLVER_STATUS_OK) solver.get_temperatures(T);
+
+  Si un metodo iterativo agota sus iteraciones sin alcanzar la tolerancia,
+  solve() devuelve SOLVER_STATUS_NOT_CONVERGED y los resultados quedan
+  disponibles con la ultima iteracion; get_iterations() y get_residual()
+  permiten decidir si sirven. La biblioteca no escribe avisos ni errores.
+
+  La implementacion esta en solver.cpp, que se compila como biblioteca
+  estatica (solver.vcxproj); este encabezado no expone los tipos internos.
+ */
+class Solver {
+public:
+    Solver();
+    ~Solver();
+    Solver(Solver&& other) noexcept;
+    Solver& operator=(Solver&& other) noexcept;
+    Solver(const Solver&) = delete;
+    Solver& operator=(const Solver&) = delete;
+
+    // metodo para fijar una opcion de solucion, con los mismos nombres y valores que la linea de comandos ("-solver", "pcg-amg");
+    // una combinacion que la linea de comandos rechaza (por ejemplo -kt con -solver dense) devuelve SOLVER_STATUS_INVALID_INPUT
+    solver_status set_option(const char* option, const char* value);
+
+    // metodo para fijar la cantidad de hilos de cada solucion (1 por defecto, para resolver varios modelos a la vez);
+    // el Solver crea un pool con esos hilos y lo reutiliza en todas las soluciones
+    solver_status set_num_threads(int num_threads);
+
+    // metodo para fijar la conductividad termica k (> 0) y la fuente de calor Q
+    solver_status set_material(float k, float Q);
+
+    // metodo para definir los nodos (x, y, z de cada uno); descarta los elementos y condiciones anteriores
+    solver_status set_nodes(int num_nodes, const float* coordinates);
+
+    // metodo para agregar elementos de una familia, con nodes_per_element indices de nodo por elemento
+    solver_status add_elements(int num_elements, int nodes_per_element, const int* connectivity);
+
+    // metodo para definir las temperaturas impuestas (condiciones de Dirichlet)
+    solver_status set_dirichlet(int count, const int* nodes, const float* values);
+
+    // metodo para definir los flujos nodales impuestos (condiciones de Neumann)
+    solver_status set_neumann(int count, const int* nodes, const float* values);
+
+    // metodo para resolver el modelo; la malla se arma en la primera solucion y se reutiliza mientras el modelo no cambie
+    solver_status solve();
+
+    // metodo para obtener las iteraciones de la ultima solucion (de PCG, o no lineales con -kt; 0 con un metodo directo)
+    int get_iterations() const;
+
+    // metodo para obtener el residuo relativo final de la ultima solucion (0 con un metodo directo)
+    double get_residual() const;
+
+    // metodo para obtener la cantidad de nodos del modelo
+    int get_num_nodes() const;
+
+    // metodo para copiar las temperaturas de la ultima solucion (una por nodo)
+    solver_status get_temperatures(float* temperatures) const;
+
+    // metodo para copiar el flujo de calor promediado en los nodos de la ultima solucion (3 por nodo)
+    solver_status get_heat_flux(float* flux) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+#endif  // SIMU_PROJEKT_SOLVER_HPP
\ No newline at end of file
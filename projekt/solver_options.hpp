@@ -0,0 +1,306 @@
+#ifndef SIMU_PROJEKT_SOLVER_OPTIONS_HPP
+#define SIMU_PROJEKT_SOLVER_OPTIONS_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "amg.hpp"
+#include "conductivity_law.hpp"
+#include "diagnostics.hpp"
+#include "output_filter.hpp"
+#include "thread_pool.hpp"
+
+// Metodos de ensamblaje del sistema disperso (ver sparse_assembly.hpp)
+enum assembly_type { ASSEMBLY_SCATTER, ASSEMBLY_TRIPLETS };
+
+// Metodos disponibles para resolver el sistema global (SOLVER_AUTO: lo elige el planificador, ver solver_planner.hpp)
+enum solver_type { SOLVER_DENSE, SOLVER_PCG_JACOBI, SOLVER_PCG_AMG, SOLVER_DOMAIN_DECOMPOSITION, SOLVER_PCG_MATRIX_FREE,
+    SOLVER_OUT_OF_CORE, SOLVER_SKYLINE, SOLVER_AUTO };
+
+// funcion para obtener el nombre de un metodo, tal como se escribe en la opcion -solver
+inline const char* solver_name(solver_type solver) {
+    const char* const names[] = { "dense", "pcg-jacobi", "pcg-amg", "dd", "pcg-mf", "ooc", "skyline", "auto" };
+    return names[solver];
+}
+
+// funcion que indica si el metodo admite una tabla k(T): el problema no lineal siempre ensambla el sistema disperso
+// y lo resuelve con el precondicionador de pcg-jacobi o pcg-amg (ver nonlinear_solver.hpp)
+inline bool solver_supports_conductivity_table(solver_type solver) {
+    return solver == SOLVER_AUTO || solver == SOLVER_PCG_JACOBI || solver == SOLVER_PCG_AMG;
+}
+
+// Precondicionadores de PCG (ver preconditioners.hpp); PRECONDITIONER_DEFAULT: el del metodo (Jacobi o AMG)
+enum preconditioner_type { PRECONDITIONER_DEFAULT, PRECONDITIONER_JACOBI, PRECONDITIONER_SSOR, PRECONDITIONER_ILU0,
+    PRECONDITIONER_IC0, PRECONDITIONER_BLOCK_JACOBI, PRECONDITIONER_AMG };
+
+// Curvas para reordenar elementos y nodos de la malla (ver mesh_reordering.hpp)
+enum mesh_ordering { ORDER_NONE, ORDER_MORTON, ORDER_HILBERT };
+
+// Metodos de la iteracion no lineal con k(T) (ver nonlinear_solver.hpp)
+enum nonlinear_method { NONLINEAR_PICARD, NONLINEAR_NEWTON };
+
+/*
+  Resultado de una solucion. Los metodos iterativos guardan sus
+  iteraciones, el residuo relativo final y si alcanzaron la tolerancia (con
+  k(T), los de la iteracion no lineal); los directos dejan los valores por
+  defecto. Si converged es false la solucion devuelta es la ultima
+  iteracion.
+ */
+struct SolveReport {
+    bool converged = true;   // false si la iteracion termino sin alcanzar la tolerancia
+    int iterations = 0;      // iteraciones realizadas (0 con los metodos directos)
+    double residual = 0;     // residuo relativo final (0 con los metodos directos)
+};
+
+// Opciones del proceso de solucion
+struct SolverOptions {
+    solver_type solver = SOLVER_AUTO;                 // metodo de solucion
+    amg_smoother smoother = SMOOTHER_GAUSS_SEIDEL;    // suavizador del AMG
+    preconditioner_type preconditioner = PRECONDITIONER_DEFAULT;  // precondicionador de pcg-jacobi y pcg-amg
+    assembly_type assembly = ASSEMBLY_SCATTER;        // ensamblaje de la matriz dispersa de los metodos iterativos
+    bool symmetric_storage = true;                    // productos de PCG con el triangulo superior de K (ver symmetric_sparse_matrix.hpp)
+    float tolerance = 1e-6f;                          // tolerancia relativa de los metodos iterativos
+    int max_iterations = 1000;                        // iteraciones maximas de los metodos iterativos
+    int num_parts = std::max(1, (int)std::thread::hardware_concurrency());  // subdominios (hardware_concurrency puede devolver 0) de la descomposicion de dominio
+    int num_threads = std::max(1, (int)std::thread::hardware_concurrency());  // hilos de la solucion (el pool tiene uno menos: el que llama tambien trabaja)
+    ThreadPool* pool = nullptr;                       // hilos compartidos por todas las etapas; lo crea quien resuelve (nullptr: sin hilos)
+    int memory_budget_mb = 256;                       // memoria de trabajo del planificador y del ensamblaje fuera de memoria
+    std::string scratch_directory;                    // carpeta de los temporales fuera de memoria y de la cache de factorizaciones
+    bool factor_cache = false;                        // guardar y reutilizar la factorizacion del metodo skyline (ver factor_cache.hpp)
+    bool compute_flux = true;                         // calcular y escribir el gradiente y el flujo de calor (ver flux_postprocess.hpp)
+    mesh_ordering ordering = ORDER_NONE;              // curva para reordenar la malla antes de resolver
+    bool reorder_nodes = true;                        // reordenar tambien los nodos (si no, solo los elementos)
+    bool reorder_report = false;                      // informar los tiempos de los nucleos antes y despues de reordenar
+    ConductivityLaw conductivity;                     // tabla k(T); si no esta vacia el problema es no lineal
+    nonlinear_method nonlinear = NONLINEAR_NEWTON;    // iteracion del problema no lineal
+    float nonlinear_tolerance = 1e-5f;                // residuo relativo de la iteracion no lineal
+    int nonlinear_max_iterations = 30;                // iteraciones maximas de la iteracion no lineal
+    float adapt_tolerance = 0;                        // error estimado relativo del refinamiento adaptativo (0: sin refinar)
+    int adapt_max_steps = 8;                          // refinamientos maximos del modo adaptativo
+    OutputOptions output;                             // filtros y precision de los resultados escritos (ver output_filter.hpp)
+    bool verbose = true;                              // mostrar el detalle de cada etapa
+    std::ostream* diagnostics = &std::cerr;           // destino de los avisos y errores de la solucion (nullptr: se descartan)
+};
+
+/*
+  Funcion para cerrar una solucion con PCG: guarda las iteraciones, el
+  residuo relativo y si se alcanzo options.tolerance en report (si no es
+  nullptr) y, si no se alcanzo, lo informa en options.diagnostics. Devuelve
+  true si PCG convergio.
+ */
+inline bool check_convergence(int iterations, double residual, const SolverOptions& options, SolveReport* report) {
+    bool converged = residual <= options.tolerance;
+    if (report != nullptr) {
+        report->converged = converged;
+        report->iterations = iterations;
+        report->residual = residual;
+    }
+    if (!converged)
+        diagnostic_stream(options.diagnostics) << "Error: PCG did not converge after " << iterations
+        << " iterations (relative residual " << residual << ")\n";
+    return converged;
+}
+
+// funcion para leer un entero que ocupe todo value y no sea menor que minimum; devuelve false si no lo es
+inline bool parse_int_value(const std::string& value, int minimum, int* result) {
+    const char* text = value.c_str();
+    char* end;
+    errno = 0;
+    long number = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || number < minimum || number > INT_MAX) return false;
+    *result = (int)number;
+    return true;
+}
+
+// funcion para leer un numero real finito que ocupe todo value; con positive, ademas debe ser mayor que cero
+inline bool parse_float_value(const std::string& value, bool positive, float* result) {
+    const char* text = value.c_str();
+    char* end;
+    errno = 0;
+    float number = strtof(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(number)) return false;
+    if (positive ? !(number > 0) : number < 0) return false;
+    *result = number;
+    return true;
+}
+
+/*
+  Metodo para interpretar una opcion de linea de comandos en argv[*i]. Si la
+  opcion es reconocida se guarda en options, se avanza *i hasta su ultimo
+  argumento y se devuelve true. La tabla de -kt y el conjunto de nodos de
+  -output-nodes se leen al interpretar la opcion; si no se pueden leer se
+  devuelve false. Los valores numericos deben ocupar todo el argumento (sin
+  caracteres de sobra); las tolerancias deben ser positivas, -adapt no
+  negativa y las cantidades al menos 1 (-adapt-steps al menos 0). Si el
+  valor no es valido se devuelve false y options queda sin cambios.
+
+    -solver auto|dense|skyline|pcg-jacobi|pcg-amg|dd|pcg-mf|ooc
+    -smoother gauss-seidel|chebyshev
+    -precond jacobi|ssor|ilu0|ic0|block-jacobi|amg
+    -assembly scatter|triplets
+    -storage full|symmetric
+    -tol value
+    -maxit value
+    -parts value
+    -memory megabytes
+    -scratch directory
+    -cache on|off
+    -flux on|off
+    -reorder none|morton|hilbert
+    -reorder-nodes on|off
+    -reorder-report on|off
+    -kt table
+    -nonlinear picard|newton
+    -nl-tol value
+    -nl-maxit value
+    -adapt tolerance
+    -adapt-steps value
+    -output-nodes file
+    -output-box xmin,ymin,zmin,xmax,ymax,zmax
+    -output-surface on|off
+    -output-stride value
+    -precision-T digits
+    -precision-flux digits
+ */
+bool parse_solver_option(int argc, char** argv, int* i, SolverOptions* options) {
+    std::string option(argv[*i]);
+    if (*i + 1 >= argc) return false;
+    std::string value(argv[*i + 1]);
+
+    if (option == "-solver") {
+        if (value == "auto") options->solver = SOLVER_AUTO;
+        else if (value == "dense") options->solver = SOLVER_DENSE;
+        else if (value == "skyline") options->solver = SOLVER_SKYLINE;
+        else if (value == "pcg-jacobi") options->solver = SOLVER_PCG_JACOBI;
+        else if (value == "pcg-amg") options->solver = SOLVER_PCG_AMG;
+        else if (value == "dd") options->solver = SOLVER_DOMAIN_DECOMPOSITION;
+        else if (value == "pcg-mf") options->solver = SOLVER_PCG_MATRIX_FREE;
+        else if (value == "ooc") options->solver = SOLVER_OUT_OF_CORE;
+        else return false;
+    }
+    else if (option == "-precond") {
+        if (value == "jacobi") options->preconditioner = PRECONDITIONER_JACOBI;
+        else if (value == "ssor") options->preconditioner = PRECONDITIONER_SSOR;
+        else if (value == "ilu0") options->preconditioner = PRECONDITIONER_ILU0;
+        else if (value == "ic0") options->preconditioner = PRECONDITIONER_IC0;
+        else if (value == "block-jacobi") options->preconditioner = PRECONDITIONER_BLOCK_JACOBI;
+        else if (value == "amg") options->preconditioner = PRECONDITIONER_AMG;
+        else return false;
+    }
+    else if (option == "-smoother") {
+        if (value == "gauss-seidel") options->smoother = SMOOTHER_GAUSS_SEIDEL;
+        else if (value == "chebyshev") options->smoother = SMOOTHER_CHEBYSHEV;
+        else return false;
+    }
+    else if (option == "-assembly") {
+        if (value == "scatter") options->assembly = ASSEMBLY_SCATTER;
+        else if (value == "triplets") options->assembly = ASSEMBLY_TRIPLETS;
+        else return false;
+    }
+    else if (option == "-storage") {
+        if (value == "full") options->symmetric_storage = false;
+        else if (value == "symmetric") options->symmetric_storage = true;
+        else return false;
+    }
+    else if (option == "-tol") {
+        if (!parse_float_value(value, true, &options->tolerance)) return false;
+    }
+    else if (option == "-maxit") {
+        if (!parse_int_value(value, 1, &options->max_iterations)) return false;
+    }
+    else if (option == "-parts") {
+        if (!parse_int_value(value, 1, &options->num_parts)) return false;
+    }
+    else if (option == "-memory") {
+        if (!parse_int_value(value, 1, &options->memory_budget_mb)) return false;
+    }
+    else if (option == "-scratch") options->scratch_directory = value;
+    else if (option == "-flux") {
+        if (value == "on") options->compute_flux = true;
+        else if (value == "off") options->compute_flux = false;
+        else return false;
+    }
+    else if (option == "-reorder") {
+        if (value == "none") options->ordering = ORDER_NONE;
+        else if (value == "morton") options->ordering = ORDER_MORTON;
+        else if (value == "hilbert") options->ordering = ORDER_HILBERT;
+        else return false;
+    }
+    else if (option == "-reorder-nodes") {
+        if (value == "on") options->reorder_nodes = true;
+        else if (value == "off") options->reorder_nodes = false;
+        else return false;
+    }
+    else if (option == "-reorder-report") {
+        if (value == "on") options->reorder_report = true;
+        else if (value == "off") options->reorder_report = false;
+        else return false;
+    }
+    else if (option == "-cache") {
+        if (value == "on") options->factor_cache = true;
+        else if (value == "off") options->factor_cache = false;
+        else return false;
+    }
+    else if (option == "-kt") {
+        if (!options->conductivity.load(value, options->diagnostics)) return false;
+    }
+    else if (option == "-nonlinear") {
+        if (value == "picard") options->nonlinear = NONLINEAR_PICARD;
+        else if (value == "newton") options->nonlinear = NONLINEAR_NEWTON;
+        else return false;
+    }
+    else if (option == "-nl-tol") {
+        if (!parse_float_value(value, true, &options->nonlinear_tolerance)) return false;
+    }
+    else if (option == "-nl-maxit") {
+        if (!parse_int_value(value, 1, &options->nonlinear_max_iterations)) return false;
+    }
+    else if (option == "-adapt") {
+        if (!parse_float_value(value, false, &options->adapt_tolerance)) return false;
+    }
+    else if (option == "-adapt-steps") {
+        if (!parse_int_value(value, 0, &options->adapt_max_steps)) return false;
+    }
+    else if (option == "-output-nodes") {
+        if (!options->output.load_node_set(value, options->diagnostics)) return false;
+    }
+    else if (option == "-output-box") {
+        if (!options->output.parse_box(value)) return false;
+    }
+    else if (option == "-output-surface") {
+        if (value == "on") options->output.surface_only = true;
+        else if (value == "off") options->output.surface_only = false;
+        else return false;
+    }
+    else if (option == "-output-stride") {
+        if (!parse_int_value(value, 1, &options->output.stride)) return false;
+    }
+    else if (option == "-precision-T" || option == "-precision-flux") {
+        int digits;
+        if (!parse_int_value(value, 1, &digits) || digits > MAX_RESULT_PRECISION) return false;
+        if (option == "-precision-T") options->output.temperature_precision = digits;
+        else options->output.flux_precision = digits;
+    }
+    else return false;
+
+    (*i)++;
+    return true;
+}
+
+// funcion para comprobar que las opciones interpretadas se pueden usar juntas; devuelve false si no
+bool check_solver_options(const SolverOptions& options) {
+    if (!options.conductivity.empty() && !solver_supports_conductivity_table(options.solver)) {
+        diagnostic_stream(options.diagnostics) << "Error: -kt is solved on the assembled sparse system and cannot be used with -solver "
+            << solver_name(options.solver) << " (use auto, pcg-jacobi or pcg-amg)\n";
+        return false;
+    }
+    return true;
+}
+
+#endif  // SIMU_PROJEKT_SOLVER_OPTIONS_HPP
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef SIMU_PROJEKT_SOLVER_PLANNER_HPP
+#define SIMU_PROJEKT_SOLVER_PLANNER_HPP
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "mesh.hpp"
+#include "partition.hpp"
+#include "skyline.hpp"
+#include "solver_options.hpp"
+
+// Constantes del modelo de costo (estimaciones gruesas, medidas sobre mallas de prueba)
+const double PLAN_AMG_COMPLEXITY = 2.0;     // entradas de la jerarquia AMG / entradas de K
+const double PLAN_AMG_ITERATIONS = 15;      // iteraciones de PCG con AMG
+const double PLAN_AMG_SETUP_FLOPS = 30;     // operaciones de la construccion del AMG por entrada de K
+const double PLAN_JACOBI_ITERATIONS = 7;    // iteraciones de PCG con Jacobi por n^(1/3)
+
+// Costo estimado de un metodo de solucion
+struct SolverEstimate {
+    solver_type solver;   // metodo
+    double memory_mb;     // memoria de trabajo (sin contar la malla)
+    double flops;         // operaciones de punto flotante
+    bool fits;            // cabe en el presupuesto de memoria
+};
+
+// Plan de solucion: caracteristicas del sistema, costo de cada candidato y metodo elegido
+struct SolverPlan {
+    int num_free = 0;                          // grados de libertad libres
+    long long nnz = 0;                         // entradas de K
+    long long profile = 0;                     // entradas del perfil de Cholesky con RCM (incluye el relleno)
+    int max_width = 0;                         // ancho maximo de fila del perfil
+    double budget_mb = 0;                      // presupuesto de memoria
+    std::vector<SolverEstimate> candidates;    // costo de cada metodo
+    solver_type solver = SOLVER_PCG_MATRIX_FREE;  // metodo elegido
+};
+
+/*
+  Planificador previo a la solucion: a partir de la conectividad de la malla
+  (sin ensamblar nada) cuenta las entradas de K, calcula el perfil que
+  tendria la factorizacion de Cholesky con el ordenamiento RCM (todo el
+  relleno cae dentro de la envolvente) y estima memoria y operaciones de:
+
+    dense     Cholesky denso: 4 n^2 bytes y n^3 / 3 operaciones
+    skyline   Cholesky disperso en perfil: 4 bytes y ~ancho operaciones por entrada del perfil
+    pcg-amg   PCG con AMG: la matriz CSR y la jerarquia, ~PLAN_AMG_ITERATIONS iteraciones
+    pcg-mf    PCG sin matriz con Jacobi: solo vectores, iteraciones ~ n^(1/3)
+
+  Se elige el de menor costo entre los que caben en options.memory_budget_mb;
+  si ninguno cabe, el metodo sin matriz, que es el de menor memoria. La
+  adyacencia entre grados de libertad se recorre sobre la marcha desde la
+  adyacencia nodo -> elementos, por lo que el plan usa memoria proporcional
+  al tamano de la malla.
+ */
+SolverPlan plan_solver(Mesh* M, const SolverOptions& options) {
+    const DofMap* dofs = M->get_dof_map();
+    const ElementGeometry* geometry = M->get_geometry();
+    int n = dofs->get_num_free();
+    int num_elements = M->get_quantity(NUM_ELEMENTS);
+
+    NodeElementGraph graph;
+    build_node_element_graph(M, &graph);
+    std::vector<int> stamp(n, -1);
+    int visit_count = 0;
+    auto neighbors = [&](int v, auto visit) {
+        int node = dofs->get_free_node(v);
+        int mark = visit_count++;
+        for (int j = graph.start[node]; j < graph.start[node + 1]; j++) {
+            int e = graph.elements[j];
+            for (int a = 0; a < geometry->get_num_nodes(e); a++) {
+                int w = dofs->get_free_index(geometry->get_node(e, a));
+                if (w < 0 || w == v || stamp[w] == mark) continue;
+                stamp[w] = mark;
+                visit(w);
+            }
+        }
+    };
+
+    SolverPlan plan;
+    plan.num_free = n;
+    plan.budget_mb = options.memory_budget_mb;
+    plan.nnz = n;
+    for (int v = 0; v < n; v++) neighbors(v, [&plan](int) { plan.nnz++; });
+
+    std::vector<int> order, width;
+    reverse_cuthill_mckee(n, neighbors, &order);
+    plan.profile = envelope_profile(n, neighbors, order, &width);
+    double skyline_flops = 4.0 * plan.profile;
+    for (int p = 0; p < n; p++) {
+        skyline_flops += (double)width[p] * width[p];
+        if (width[p] > plan.max_width) plan.max_width = width[p];
+    }
+
+    double element_entries = 0;  // entradas de las matrices locales
+    for (int e = 0; e < num_elements; e++) element_entries += (double)geometry->get_num_nodes(e) * geometry->get_num_nodes(e);
+
+    const double MB = 1024.0 * 1024.0;
+    double csr_bytes = 8.0 * plan.nnz + 4.0 * (n + 1);
+    double dn = n;
+
+    plan.candidates.push_back({ SOLVER_DENSE, (4.0 * dn * dn + 4.0 * element_entries + 12.0 * dn) / MB,
+        dn * dn * dn / 3, false });
+    plan.candidates.push_back({ SOLVER_SKYLINE, (csr_bytes + 4.0 * plan.profile + 40.0 * dn) / MB, skyline_flops, false });
+    double operator_bytes = options.symmetric_storage ? 0.5 * csr_bytes : 0;  // copia del triangulo superior para PCG
+    plan.candidates.push_back({ SOLVER_PCG_AMG, ((1 + PLAN_AMG_COMPLEXITY) * csr_bytes + operator_bytes + 32.0 * dn) / MB,
+        PLAN_AMG_SETUP_FLOPS * plan.nnz + PLAN_AMG_ITERATIONS * 2.0 * plan.nnz * (1 + 6 * PLAN_AMG_COMPLEXITY), false });
+    plan.candidates.push_back({ SOLVER_PCG_MATRIX_FREE, 24.0 * dn / MB,
+        PLAN_JACOBI_ITERATIONS * std::cbrt(dn) * (2.0 * element_entries + 10.0 * dn), false });
+
+    const SolverEstimate* best = nullptr;
+    for (SolverEstimate& candidate : plan.candidates) {
+        candidate.fits = candidate.memory_mb <= plan.budget_mb;
+        if (candidate.fits && (best == nullptr || candidate.flops < best->flops)) best = &candidate;
+    }
+    plan.solver = best != nullptr ? best->solver : SOLVER_PCG_MATRIX_FREE;
+    return plan;
+}
+
+// Metodo para mostrar el plan de solucion
+void report_plan(const SolverPlan& plan) {
+    std::cout << "Plan de solucion (presupuesto de memoria " << plan.budget_mb << " MB):\n";
+    std::cout << "\tGrados de libertad: " << plan.num_free << ", entradas de K: " << plan.nnz
+        << ", perfil con RCM: " << plan.profile << " (ancho maximo " << plan.max_width << ")\n";
+    for (const SolverEstimate& candidate : plan.candidates)
+        std::cout << "\t" << solver_name(candidate.solver) << ": " << candidate.memory_mb << " MB, "
+        << candidate.flops << " operaciones" << (candidate.fits ? "" : " (excede el presupuesto)") << "\n";
+    bool any_fits = false;
+    for (const SolverEstimate& candidate : plan.candidates) any_fits = any_fits || candidate.fits;
+    if (!any_fits) std::cout << "\tNingun metodo cabe en el presupuesto; se usa el de menor memoria\n";
+    std::cout << "\tMetodo elegido: " << solver_name(plan.solver) << "\n\n";
+}
+
+#endif  // SIMU_PROJEKT_SOLVER_PLANNER_HPP
\ No newline at end of file
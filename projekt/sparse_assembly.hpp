@@ -0,0 +1,408 @@
+#ifndef SIMU_PROJEKT_SPARSE_ASSEMBLY_HPP
+#define SIMU_PROJEKT_SPARSE_ASSEMBLY_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "matrix_operations.hpp"
+#include "mesh.hpp"
+#include "partition.hpp"
+#include "sparse_matrix.hpp"
+#include "vector.hpp"
+
+const int RADIX_BITS = 12;                      // bits por pasada del ordenamiento radix (3 pasadas para claves de 36 bits)
+const int RADIX_BUCKETS = 1 << RADIX_BITS;      // cubetas por pasada
+
+/*
+  Plan de ensamblaje: todo lo que depende solo de la conectividad y de los
+  nodos con Dirichlet, calculado una vez por malla. Guarda el patron CSR
+  del sistema reducido y, para cada entrada (a, c) de la matriz local de
+  cada elemento, su posicion en el arreglo de valores de K (o -1 si la
+  columna tiene Dirichlet y la entrada va al lado derecho). Con el plan,
+  volver a ensamblar (otra conductividad, una iteracion no lineal, otro
+  paso de tiempo) es solo sumar en posiciones ya conocidas, sin buscar
+  columnas.
+
+  Las filas se reparten en bloques contiguos, uno por hilo del pool, con cantidades
+  de entradas parecidas, y cada bloque guarda la lista de elementos que
+  tocan sus filas. Cada hilo suma solo en sus filas, asi que no hay
+  conflictos de escritura, y cada posicion recibe sus aportes siempre en
+  el mismo orden de elementos: el resultado no depende de la cantidad de
+  hilos.
+ */
+class AssemblyPlan {
+private:
+    int n;                                          // grados de libertad libres
+    std::vector<int> row_ptr;                       // inicio de cada fila del patron (n + 1 entradas)
+    std::vector<int> col_idx;                       // columnas del patron, ordenadas en cada fila
+    std::vector<size_t> entry_start;                // primera entrada local de cada elemento en slot (num_elements + 1)
+    std::vector<int> slot;                          // posicion en los valores de K de cada entrada local (-1: al lado derecho)
+    std::vector<int> block_start;                   // primera fila de cada bloque (num_blocks + 1 entradas)
+    std::vector<std::vector<int>> block_elements;   // elementos con alguna fila libre en cada bloque
+    ThreadPool* pool;                               // hilos que ensamblan los bloques (nullptr: sin hilos)
+
+public:
+    AssemblyPlan() : n(0), pool(nullptr) {}
+
+    // metodo para construir el plan de la malla M (con la geometria y la DofMap ya construidas), con un bloque por hilo del pool
+    void build(Mesh* M, ThreadPool* threads = nullptr) {
+        const DofMap* dofs = M->get_dof_map();
+        const ElementGeometry* geometry = M->get_geometry();
+        int num_elements = geometry->get_num_elements();
+        n = dofs->get_num_free();
+        pool = threads;
+
+        NodeElementGraph graph;
+        build_node_element_graph(M, &graph);
+
+        // columnas libres de la fila row, ordenadas y sin repetir; marked[col] == row indica que col ya se agrego,
+        // asi se ordenan solo las columnas distintas y el costo no depende del orden de los nodos
+        auto row_columns = [&](int row, std::vector<int>* cols, std::vector<int>* marked) {
+            int node = dofs->get_free_node(row);
+            cols->clear();
+            for (int j = graph.start[node]; j < graph.start[node + 1]; j++) {
+                int e = graph.elements[j];
+                for (int a = 0; a < geometry->get_num_nodes(e); a++) {
+                    int col = dofs->get_free_index(geometry->get_node(e, a));
+                    if (col < 0 || (*marked)[col] == row) continue;
+                    (*marked)[col] = row;
+                    cols->push_back(col);
+                }
+            }
+            std::sort(cols->begin(), cols->end());
+        };
+
+        // patron: cantidad de columnas por fila y luego las columnas
+        row_ptr.assign(n + 1, 0);
+        run_row_blocks(n, pool, 64, [&](int begin, int end) {
+            std::vector<int> cols, marked(n, -1);
+            for (int row = begin; row < end; row++) {
+                row_columns(row, &cols, &marked);
+                row_ptr[row + 1] = (int)cols.size();
+            }
+        });
+        for (int r = 0; r < n; r++) row_ptr[r + 1] += row_ptr[r];
+        col_idx.resize(row_ptr[n]);
+        run_row_blocks(n, pool, 64, [&](int begin, int end) {
+            std::vector<int> cols, marked(n, -1);
+            for (int row = begin; row < end; row++) {
+                row_columns(row, &cols, &marked);
+                std::copy(cols.begin(), cols.end(), col_idx.begin() + row_ptr[row]);
+            }
+        });
+
+        // posicion de cada entrada local en el arreglo de valores
+        entry_start.assign(num_elements + 1, 0);
+        for (int e = 0; e < num_elements; e++)
+            entry_start[e + 1] = entry_start[e] + (size_t)geometry->get_num_nodes(e) * geometry->get_num_nodes(e);
+        slot.resize(entry_start[num_elements]);
+        run_row_blocks(num_elements, pool, 1024, [&](int begin, int end) {
+            for (int e = begin; e < end; e++) {
+                int nn = geometry->get_num_nodes(e);
+                int* destination = &slot[entry_start[e]];
+                for (int a = 0; a < nn; a++) {
+                    int row = dofs->get_free_index(geometry->get_node(e, a));
+                    for (int c = 0; c < nn; c++) {
+                        int col = dofs->get_free_index(geometry->get_node(e, c));
+                        if (row < 0 || col < 0) {
+                            destination[a * nn + c] = -1;
+                            continue;
+                        }
+                        const int* position = std::lower_bound(&col_idx[0] + row_ptr[row], &col_idx[0] + row_ptr[row + 1], col);
+                        destination[a * nn + c] = (int)(position - &col_idx[0]);
+                    }
+                }
+            }
+        });
+
+        // bloques de filas con cantidades de entradas parecidas y los elementos de cada uno
+        int num_blocks = std::max(1, std::min(parallel_width(pool), n));
+        block_start.assign(num_blocks + 1, n);
+        block_start[0] = 0;
+        for (int t = 1, r = 0; t < num_blocks; t++) {
+            long long target = (long long)row_ptr[n] * t / num_blocks;
+            while (r < n && row_ptr[r] < target) r++;
+            block_start[t] = r;
+        }
+        std::vector<int> row_block(n);
+        for (int t = 0; t < num_blocks; t++)
+            for (int r = block_start[t]; r < block_start[t + 1]; r++) row_block[r] = t;
+        block_elements.assign(num_blocks, std::vector<int>());
+        for (int e = 0; e < num_elements; e++)
+            for (int a = 0; a < geometry->get_num_nodes(e); a++) {
+                int row = dofs->get_free_index(geometry->get_node(e, a));
+                if (row < 0) continue;
+                // los elementos se agregan en orden, asi que basta mirar el ultimo para no repetirlos
+                std::vector<int>& elements = block_elements[row_block[row]];
+                if (elements.empty() || elements.back() != e) elements.push_back(e);
+            }
+    }
+
+    // metodo para obtener la cantidad de entradas del patron
+    int get_nnz() const { return n > 0 ? row_ptr[n] : 0; }
+
+    /*
+      Metodo para ensamblar K y el lado derecho (carga de los elementos y
+      columnas de Dirichlet, sin Neumann) con el plan. element_k da la
+      conductividad de cada elemento; si es nullptr se usa la de la malla.
+      Si K ya viene de un ensamblaje anterior con este plan, se conserva su
+      patron y solo se reemplazan los valores.
+     */
+    void assemble(Mesh* M, SparseMatrix* K, Vector* b, const float* element_k = nullptr) const {
+        const DofMap* dofs = M->get_dof_map();
+        const ElementGeometry* geometry = M->get_geometry();
+        float k = M->get_problem_data(THERMAL_CONDUCTIVITY);
+        float Q = M->get_problem_data(HEAT_SOURCE);
+
+        if (K->get_nrows() != n || K->get_nnz() != get_nnz()) {
+            K->set_size(n, n, get_nnz());
+            std::copy(row_ptr.begin(), row_ptr.end(), K->get_row_ptr());
+            std::copy(col_idx.begin(), col_idx.end(), K->get_col_idx());
+        }
+        float* Kx = K->get_values();
+        b->set_size(n);
+        float* bv = b->get_data();
+
+        run_threads((int)block_elements.size(), pool, [&](int t) {
+            int first_row = block_start[t], last_row = block_start[t + 1];
+            std::fill(Kx + row_ptr[first_row], Kx + row_ptr[last_row], 0.0f);
+            std::fill(bv + first_row, bv + last_row, 0.0f);
+            for (int e : block_elements[t]) {
+                int nn = geometry->get_num_nodes(e);
+                float ke = element_k != nullptr ? element_k[e] : k;
+                const int* destination = &slot[entry_start[e]];
+                for (int a = 0; a < nn; a++) {
+                    int row = dofs->get_free_index(geometry->get_node(e, a));
+                    if (row < first_row || row >= last_row) continue;  // incluye las filas con Dirichlet (row < 0)
+                    bv[row] += geometry->local_load(e, a, Q);
+                    for (int c = 0; c < nn; c++) {
+                        float value = ke * geometry->stiffness_entry(e, a, c);
+                        int position = destination[a * nn + c];
+                        if (position >= 0) Kx[position] += value;
+                        else bv[row] -= value * dofs->get_fixed_value(geometry->get_node(e, c));
+                    }
+                }
+            }
+        });
+    }
+
+    /*
+      Metodo para sumar a J (ya ensamblada con el plan y element_k) el
+      termino de la derivada de la conductividad del jacobiano de Newton.
+      Con k_e = k(T medio del elemento), la fila a de cada elemento recibe
+      element_dk[e] / nn * (S_e T_e)_a en cada columna libre del elemento,
+      donde S_e es la rigidez geometrica y T_e las temperaturas del elemento
+      en T_full (incluidas las de Dirichlet). El resultado no es simetrico.
+     */
+    void add_conductivity_derivative(Mesh* M, SparseMatrix* J, const float* element_dk, const Vector* T_full) const {
+        const DofMap* dofs = M->get_dof_map();
+        const ElementGeometry* geometry = M->get_geometry();
+        const float* T = T_full->get_data();
+        float* Jx = J->get_values();
+
+        run_threads((int)block_elements.size(), pool, [&](int t) {
+            int first_row = block_start[t], last_row = block_start[t + 1];
+            for (int e : block_elements[t]) {
+                if (element_dk[e] == 0) continue;
+                int nn = geometry->get_num_nodes(e);
+                float weight = element_dk[e] / nn;
+                const int* destination = &slot[entry_start[e]];
+                for (int a = 0; a < nn; a++) {
+                    int row = dofs->get_free_index(geometry->get_node(e, a));
+                    if (row < first_row || row >= last_row) continue;
+                    float flux = 0;
+                    for (int c = 0; c < nn; c++) flux += geometry->stiffness_entry(e, a, c) * T[geometry->get_node(e, c)];
+                    for (int c = 0; c < nn; c++)
+                        if (destination[a * nn + c] >= 0) Jx[destination[a * nn + c]] += weight * flux;
+                }
+            }
+        });
+    }
+};
+
+/*
+  Ensamblaje del sistema reducido en formato CSR dispersando sobre un patron
+  precalculado: se construye el plan de ensamblaje de la malla (patron y
+  posicion de cada entrada local, ver AssemblyPlan) y se suma con el. El
+  lado derecho (carga y columnas de Dirichlet) se arma en la misma pasada.
+  Para ensamblar varias veces sobre la misma malla conviene guardar el plan
+  y llamar solo a AssemblyPlan::assemble.
+ */
+void assemble_sparse_scatter(Mesh* M, SparseMatrix* K, Vector* b, ThreadPool* pool = nullptr) {
+    AssemblyPlan plan;
+    plan.build(M, pool);
+    plan.assemble(M, K, b);
+}
+
+/*
+  Funcion para ordenar pares (clave, valor) por clave con radix LSD en
+  paralelo: los pares se dividen en num_threads tramos que procesan los
+  hilos del pool. En cada pasada se cuentan las cifras de cada tramo, un
+  prefijo sobre (cifra, tramo) da a cada tramo sus posiciones de destino y
+  luego cada tramo se distribuye. El orden es estable, asi que tras
+  ceil(key_bits / RADIX_BITS) pasadas las claves quedan ordenadas. keys y
+  values se usan como doble buffer con temp_keys y temp_values.
+ */
+void parallel_radix_sort(std::vector<unsigned long long>* keys, std::vector<float>* values, int key_bits,
+    int num_threads, ThreadPool* pool) {
+    size_t count = keys->size();
+    std::vector<unsigned long long> temp_keys(count);
+    std::vector<float> temp_values(count);
+    std::vector<unsigned long long>* source_keys = keys, * target_keys = &temp_keys;
+    std::vector<float>* source_values = values, * target_values = &temp_values;
+    std::vector<size_t> offsets((size_t)num_threads * RADIX_BUCKETS);
+
+    auto slice_begin = [count, num_threads](int t) { return count * t / num_threads; };
+    for (int shift = 0; shift < key_bits; shift += RADIX_BITS) {
+        run_threads(num_threads, pool, [&](int t) {
+            size_t* histogram = &offsets[(size_t)t * RADIX_BUCKETS];
+            std::fill(histogram, histogram + RADIX_BUCKETS, 0);
+            for (size_t i = slice_begin(t); i < slice_begin(t + 1); i++)
+                histogram[((*source_keys)[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        });
+
+        size_t position = 0;
+        for (int digit = 0; digit < RADIX_BUCKETS; digit++)
+            for (int t = 0; t < num_threads; t++) {
+                size_t bucket = offsets[(size_t)t * RADIX_BUCKETS + digit];
+                offsets[(size_t)t * RADIX_BUCKETS + digit] = position;
+                position += bucket;
+            }
+
+        run_threads(num_threads, pool, [&](int t) {
+            size_t* next = &offsets[(size_t)t * RADIX_BUCKETS];
+            for (size_t i = slice_begin(t); i < slice_begin(t + 1); i++) {
+                size_t destination = next[((*source_keys)[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                (*target_keys)[destination] = (*source_keys)[i];
+                (*target_values)[destination] = (*source_values)[i];
+            }
+        });
+        std::swap(source_keys, target_keys);
+        std::swap(source_values, target_values);
+    }
+
+    if (source_keys != keys) {
+        keys->swap(temp_keys);
+        values->swap(temp_values);
+    }
+}
+
+/*
+  Ensamblaje del sistema reducido en formato CSR a partir de tripletas. Cada
+  hilo recorre un tramo de elementos y escribe sus entradas (fila, columna,
+  valor) en su propio tramo de los arreglos globales, codificadas como
+  clave = fila * n + columna, y su aporte al lado derecho en su propio
+  vector, sin fase simbolica ni conflictos de escritura. Luego las claves se ordenan con radix en paralelo
+  y una reduccion segmentada (cada hilo suma las claves repetidas de su
+  tramo, con los tramos cortados en cambios de clave) produce las columnas y
+  los valores; row_ptr sale de una busqueda binaria por fila.
+ */
+void assemble_sparse_triplets(Mesh* M, SparseMatrix* K, Vector* b, ThreadPool* pool = nullptr) {
+    const DofMap* dofs = M->get_dof_map();
+    const ElementGeometry* geometry = M->get_geometry();
+    int n = dofs->get_num_free();
+    int num_elements = geometry->get_num_elements();
+    float k = M->get_problem_data(THERMAL_CONDUCTIVITY);
+    float Q = M->get_problem_data(HEAT_SOURCE);
+    int num_threads = parallel_width(pool);
+
+    // cada hilo toma un tramo de elementos; primero se cuentan sus entradas para
+    // que escriba directamente en su parte de los arreglos globales
+    auto first_element = [num_elements, num_threads](int t) { return (int)((long long)num_elements * t / num_threads); };
+    std::vector<size_t> start(num_threads + 1, 0);
+    run_threads(num_threads, pool, [&](int t) {
+        size_t entries = 0;
+        for (int e = first_element(t); e < first_element(t + 1); e++) {
+            int nn = geometry->get_num_nodes(e), free_nodes = 0;
+            for (int a = 0; a < nn; a++) free_nodes += dofs->get_free_index(geometry->get_node(e, a)) >= 0;
+            entries += (size_t)free_nodes * free_nodes;
+        }
+        start[t + 1] = entries;
+    });
+    for (int t = 0; t < num_threads; t++) start[t + 1] += start[t];
+
+    // tripletas y aporte al lado derecho de cada hilo
+    std::vector<unsigned long long> keys(start[num_threads]);
+    std::vector<float> values(start[num_threads]);
+    std::vector<std::vector<float>> thread_b(num_threads);
+    run_threads(num_threads, pool, [&](int t) {
+        std::vector<float>& rhs = thread_b[t];
+        rhs.assign(n, 0.0f);
+        size_t position = start[t];
+        for (int e = first_element(t); e < first_element(t + 1); e++) {
+            int nn = geometry->get_num_nodes(e);
+            for (int a = 0; a < nn; a++) {
+                int row = dofs->get_free_index(geometry->get_node(e, a));
+                if (row < 0) continue;
+                rhs[row] += geometry->local_load(e, a, Q);
+                for (int c = 0; c < nn; c++) {
+                    int other = geometry->get_node(e, c);
+                    float value = k * geometry->stiffness_entry(e, a, c);
+                    int col = dofs->get_free_index(other);
+                    if (col < 0) {
+                        rhs[row] -= value * dofs->get_fixed_value(other);
+                        continue;
+                    }
+                    keys[position] = (unsigned long long)row * n + col;
+                    values[position] = value;
+                    position++;
+                }
+            }
+        }
+    });
+
+    // reducir el lado derecho por filas
+    b->set_size(n);
+    run_row_blocks(n, pool, 1024, [&](int begin, int end) {
+        for (int row = begin; row < end; row++) {
+            float sum = 0;
+            for (int t = 0; t < num_threads; t++) sum += thread_b[t][row];
+            b->set(sum, row);
+        }
+    });
+
+    int key_bits = 0;
+    while (key_bits < 64 && ((unsigned long long)n * n) >> key_bits) key_bits++;
+    parallel_radix_sort(&keys, &values, key_bits, num_threads, pool);
+
+    // reduccion segmentada: los tramos de cada hilo empiezan en un cambio de clave
+    size_t count = keys.size();
+    std::vector<size_t> segment(num_threads + 1, count), unique(num_threads + 1, 0);
+    for (int t = 0; t < num_threads; t++) {
+        size_t i = count * t / num_threads;
+        while (i > 0 && i < count && keys[i] == keys[i - 1]) i++;
+        segment[t] = i;
+    }
+    for (int t = num_threads - 1; t > 0; t--) segment[t] = std::min(segment[t], segment[t + 1]);
+    run_threads(num_threads, pool, [&](int t) {
+        size_t distinct = 0;
+        for (size_t i = segment[t]; i < segment[t + 1]; i++)
+            if (i == segment[t] || keys[i] != keys[i - 1]) distinct++;
+        unique[t + 1] = distinct;
+    });
+    for (int t = 0; t < num_threads; t++) unique[t + 1] += unique[t];
+
+    K->set_size(n, n, (int)unique[num_threads]);
+    int* Kp = K->get_row_ptr();
+    int* Kj = K->get_col_idx();
+    float* Kx = K->get_values();
+    std::vector<int> rows(unique[num_threads]);
+    run_threads(num_threads, pool, [&](int t) {
+        long long position = (long long)unique[t] - 1;
+        for (size_t i = segment[t]; i < segment[t + 1]; i++) {
+            if (i == segment[t] || keys[i] != keys[i - 1]) {
+                position++;
+                rows[position] = (int)(keys[i] / n);
+                Kj[position] = (int)(keys[i] % n);
+                Kx[position] = 0;
+            }
+            Kx[position] += values[i];
+        }
+    });
+    run_row_blocks(n + 1, pool, 1024, [&](int begin, int end) {
+        for (int row = begin; row < end; row++)
+            Kp[row] = (int)(std::lower_bound(rows.begin(), rows.end(), row) - rows.begin());
+    });
+}
+
+#endif  // SIMU_PROJEKT_SPARSE_ASSEMBLY_HPP
\ No newline at end of file
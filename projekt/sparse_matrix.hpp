@@ -0,0 +1,125 @@
+#ifndef SIMU_PROJEKT_SPARSE_MATRIX_HPP
+#define SIMU_PROJEKT_SPARSE_MATRIX_HPP
+
+#include <cmath>
+#include <iostream>
+#include <cstdlib> // for malloc and free
+
+#include "matrix.hpp"
+#include "vector.hpp"
+
+// Sparse matrix in compressed sparse row (CSR) format
+class SparseMatrix {
+private:
+    int nrows, ncols, nnz; // dimensions and number of stored entries
+    int* row_ptr;          // start of each row in col_idx/values (nrows + 1 entries)
+    int* col_idx;          // column of each stored entry, sorted inside each row
+    float* values;         // value of each stored entry
+
+    // method to release the data structure
+    void release() {
+        if (row_ptr != nullptr) free(row_ptr);
+        if (col_idx != nullptr) free(col_idx);
+        if (values != nullptr) free(values);
+        row_ptr = nullptr;
+        col_idx = nullptr;
+        values = nullptr;
+    }
+
+public:
+    // default constructor
+    SparseMatrix() : nrows(0), ncols(0), nnz(0), row_ptr(nullptr), col_idx(nullptr), values(nullptr) {}
+
+    // destructor to free allocated memory
+    ~SparseMatrix() {
+        release();
+    }
+
+    SparseMatrix(const SparseMatrix&) = delete;
+    SparseMatrix& operator=(const SparseMatrix&) = delete;
+
+    // method to set the dimensions and the number of entries; row_ptr is zeroed, the rest is left uninitialized
+    void set_size(int rows, int cols, int entries) {
+        release();
+        nrows = rows;
+        ncols = cols;
+        nnz = entries;
+        row_ptr = (int*)calloc(nrows + 1, sizeof(int));
+        col_idx = (int*)malloc(sizeof(int) * (nnz > 0 ? nnz : 1));
+        values = (float*)malloc(sizeof(float) * (nnz > 0 ? nnz : 1));
+    }
+
+    // method to build the matrix from the nonzero entries of a dense matrix
+    void from_dense(const Matrix* M, float drop_tolerance = 0) {
+        int n = M->get_nrows(), m = M->get_ncols();
+        int count = 0;
+        for (int r = 0; r < n; r++)
+            for (int c = 0; c < m; c++)
+                if (std::abs(M->get(r, c)) > drop_tolerance) count++;
+
+        set_size(n, m, count);
+        int k = 0;
+        for (int r = 0; r < n; r++) {
+            row_ptr[r] = k;
+            for (int c = 0; c < m; c++) {
+                float value = M->get(r, c);
+                if (std::abs(value) > drop_tolerance) {
+                    col_idx[k] = c;
+                    values[k] = value;
+                    k++;
+                }
+            }
+        }
+        row_ptr[n] = k;
+    }
+
+    // method to get the number of rows in the matrix
+    int get_nrows() const { return nrows; }
+
+    // method to get the number of columns in the matrix
+    int get_ncols() const { return ncols; }
+
+    // method to get the number of stored entries
+    int get_nnz() const { return nnz; }
+
+    // raw access to the CSR arrays
+    int* get_row_ptr() { return row_ptr; }
+    const int* get_row_ptr() const { return row_ptr; }
+    int* get_col_idx() { return col_idx; }
+    const int* get_col_idx() const { return col_idx; }
+    float* get_values() { return values; }
+    const float* get_values() const { return values; }
+
+    // method to get the value of an element (zero if it is not stored)
+    float get(int row, int col) const {
+        for (int k = row_ptr[row]; k < row_ptr[row + 1]; k++)
+            if (col_idx[k] == col) return values[k];
+        return 0;
+    }
+
+    // method to get the diagonal entry of a row
+    float get_diagonal(int row) const {
+        return get(row, row);
+    }
+
+    // method to compute y = A * x
+    void multiply(const Vector* x, Vector* y) const {
+        for (int r = 0; r < nrows; r++) {
+            float acc = 0;
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; k++)
+                acc += values[k] * x->get(col_idx[k]);
+            y->set(acc, r);
+        }
+    }
+
+    // method to display the matrix as a list of (row, col, value) entries
+    void show() const {
+        std::cout << "[ ";
+        for (int r = 0; r < nrows; r++)
+            for (int k = row_ptr[r]; k < row_ptr[r + 1]; k++)
+                std::cout << "(" << r << ", " << col_idx[k] << ": " << values[k] << ") ";
+        std::cout << " ]\n\n";
+    }
+};
+
+#endif //SIMU_PROJEKT_SPARSE_MATRIX_HPP
\ No newline at end of file
@@ -0,0 +1,180 @@
+#ifndef SIMU_PROJEKT_SPARSE_OPERATIONS_HPP
+#define SIMU_PROJEKT_SPARSE_OPERATIONS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "sparse_matrix.hpp"
+#include "vector.hpp"
+
+// Entrada de una matriz en formato de coordenadas (COO)
+struct Triplet {
+    int row;
+    int col;
+    float value;
+};
+
+// funcion de comparacion que ordena las tripletas por fila y luego por columna
+inline bool triplet_less(const Triplet& a, const Triplet& b) {
+    return a.row < b.row || (a.row == b.row && a.col < b.col);
+}
+
+// funcion para construir una matriz CSR a partir de tripletas (fila, columna, valor); las repetidas se suman
+void sparse_from_triplets(int n, int m, const std::vector<int>& rows, const std::vector<int>& cols,
+    const std::vector<float>& vals, SparseMatrix* A) {
+    int count = (int)rows.size();
+
+    // ordenar por fila (conteo) y luego por columna dentro de cada fila
+    std::vector<int> start(n + 1, 0), order(count);
+    for (int k = 0; k < count; k++) start[rows[k] + 1]++;
+    for (int r = 0; r < n; r++) start[r + 1] += start[r];
+    std::vector<int> next(start.begin(), start.end() - 1);
+    for (int k = 0; k < count; k++) order[next[rows[k]]++] = k;
+    for (int r = 0; r < n; r++)
+        std::sort(order.begin() + start[r], order.begin() + start[r + 1],
+            [&cols](int a, int b) { return cols[a] < cols[b]; });
+
+    // contar entradas distintas
+    int nnz = 0;
+    for (int r = 0; r < n; r++)
+        for (int k = start[r]; k < start[r + 1]; k++)
+            if (k == start[r] || cols[order[k]] != cols[order[k - 1]]) nnz++;
+
+    A->set_size(n, m, nnz);
+    int* Ap = A->get_row_ptr();
+    int* Aj = A->get_col_idx();
+    float* Ax = A->get_values();
+    int pos = -1;
+    for (int r = 0; r < n; r++) {
+        Ap[r] = pos + 1;
+        for (int k = start[r]; k < start[r + 1]; k++) {
+            if (k == start[r] || cols[order[k]] != cols[order[k - 1]]) {
+                pos++;
+                Aj[pos] = cols[order[k]];
+                Ax[pos] = 0;
+            }
+            Ax[pos] += vals[order[k]];
+        }
+    }
+    Ap[n] = pos + 1;
+}
+
+// funcion para calcular la transpuesta T = A^T de una matriz dispersa
+void sparse_transpose(const SparseMatrix* A, SparseMatrix* T) {
+    int n = A->get_nrows(), m = A->get_ncols(), nnz = A->get_nnz();
+    const int* Ap = A->get_row_ptr();
+    const int* Aj = A->get_col_idx();
+    const float* Ax = A->get_values();
+
+    T->set_size(m, n, nnz);
+    int* Tp = T->get_row_ptr();
+    int* Tj = T->get_col_idx();
+    float* Tx = T->get_values();
+
+    for (int k = 0; k < nnz; k++) Tp[Aj[k] + 1]++;  // contar entradas por columna de A
+    for (int c = 0; c < m; c++) Tp[c + 1] += Tp[c];
+
+    std::vector<int> next(Tp, Tp + m);
+    for (int r = 0; r < n; r++)
+        for (int k = Ap[r]; k < Ap[r + 1]; k++) {
+            int dest = next[Aj[k]]++;
+            Tj[dest] = r;  // las filas se recorren en orden, asi que cada fila de T queda ordenada
+            Tx[dest] = Ax[k];
+        }
+}
+
+// funcion para multiplicar dos matrices dispersas R = A * B (algoritmo de Gustavson); devuelve false si las dimensiones no son compatibles
+bool sparse_product_matrix_by_matrix(const SparseMatrix* A, const SparseMatrix* B, SparseMatrix* R) {
+    int n = A->get_nrows(), m = A->get_ncols(), q = B->get_ncols();
+    if (m != B->get_nrows()) return false;
+    const int* Ap = A->get_row_ptr();
+    const int* Aj = A->get_col_idx();
+    const float* Ax = A->get_values();
+    const int* Bp = B->get_row_ptr();
+    const int* Bj = B->get_col_idx();
+    const float* Bx = B->get_values();
+
+    std::vector<int> marker(q, -1);   // ultima fila en la que aparecio cada columna
+    std::vector<float> acc(q, 0.0f);  // acumulador denso de la fila actual
+
+    // fase simbolica: cantidad de entradas por fila
+    std::vector<int> counts(n + 1, 0);
+    for (int r = 0; r < n; r++)
+        for (int ka = Ap[r]; ka < Ap[r + 1]; ka++)
+            for (int kb = Bp[Aj[ka]]; kb < Bp[Aj[ka] + 1]; kb++)
+                if (marker[Bj[kb]] != r) {
+                    marker[Bj[kb]] = r;
+                    counts[r + 1]++;
+                }
+    for (int r = 0; r < n; r++) counts[r + 1] += counts[r];
+
+    R->set_size(n, q, counts[n]);
+    int* Rp = R->get_row_ptr();
+    int* Rj = R->get_col_idx();
+    float* Rx = R->get_values();
+    for (int r = 0; r <= n; r++) Rp[r] = counts[r];
+
+    // fase numerica
+    std::fill(marker.begin(), marker.end(), -1);
+    std::vector<int> row_cols;
+    for (int r = 0; r < n; r++) {
+        row_cols.clear();
+        for (int ka = Ap[r]; ka < Ap[r + 1]; ka++) {
+            float a = Ax[ka];
+            for (int kb = Bp[Aj[ka]]; kb < Bp[Aj[ka] + 1]; kb++) {
+                int c = Bj[kb];
+                if (marker[c] != r) {
+                    marker[c] = r;
+                    acc[c] = 0;
+                    row_cols.push_back(c);
+                }
+                acc[c] += a * Bx[kb];
+            }
+        }
+        std::sort(row_cols.begin(), row_cols.end());
+        int k = Rp[r];
+        for (int c : row_cols) {
+            Rj[k] = c;
+            Rx[k] = acc[c];
+            k++;
+        }
+    }
+    return true;
+}
+
+// funcion para calcular el producto de Galerkin Ac = P^T * A * P; devuelve false si las dimensiones no son compatibles
+bool galerkin_product(const SparseMatrix* A, const SparseMatrix* P, SparseMatrix* Ac) {
+    SparseMatrix AP, Pt;
+    if (!sparse_product_matrix_by_matrix(A, P, &AP)) return false;
+    sparse_transpose(P, &Pt);
+    return sparse_product_matrix_by_matrix(&Pt, &AP, Ac);
+}
+
+// funcion para estimar el radio espectral de D^-1 * A con iteraciones de potencia
+float estimate_spectral_radius(const SparseMatrix* A, const Vector* inv_diag, int iterations = 15) {
+    int n = A->get_nrows();
+    Vector x(n), y(n);
+    for (int i = 0; i < n; i++) x.set(1.0f + (float)((i * 7919) % 13) / 13.0f, i);  // vector inicial no trivial
+
+    double rho = 0;
+    for (int it = 0; it < iterations; it++) {
+        A->multiply(&x, &y);
+        double norm = 0;
+        for (int i = 0; i < n; i++) {
+            float v = inv_diag->get(i) * y.get(i);
+            y.set(v, i);
+            norm += (double)v * v;
+        }
+        norm = std::sqrt(norm);
+        if (norm == 0) return 0;
+        double x_norm = 0;
+        for (int i = 0; i < n; i++) x_norm += (double)x.get(i) * x.get(i);
+        rho = norm / std::sqrt(x_norm);
+        for (int i = 0; i < n; i++) x.set((float)(y.get(i) / norm), i);
+    }
+    return (float)rho;
+}
+
+#endif //SIMU_PROJEKT_SPARSE_OPERATIONS_HPP
\ No newline at end of file
@@ -0,0 +1,185 @@
+#ifndef SIMU_PROJEKT_SYMMETRIC_SPARSE_MATRIX_HPP
+#define SIMU_PROJEKT_SYMMETRIC_SPARSE_MATRIX_HPP
+
+#include <algorithm>
+#include <cstdlib> // for malloc and free
+#include <vector>
+
+#include "sparse_matrix.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+/*
+  Symmetric sparse matrix that stores only the upper triangle in CSR format:
+  each row keeps its diagonal entry first, followed by the entries to the
+  right of the diagonal in increasing column order. This needs about half
+  the memory (and half the memory traffic per product) of the full CSR
+  matrix.
+
+  The product y = A x visits every stored entry once: a_rc contributes
+  a_rc * x_c to y_r (row part) and, off the diagonal, a_rc * x_r to y_c
+  (transpose part). The transpose part writes outside the rows of the
+  block being processed, so the parallel product gives each thread a
+  private partial vector that covers its first row up to the largest
+  column it touches; a second pass adds the partial vectors that overlap
+  each row block. With a banded ordering the partial vectors are short.
+ */
+class SymmetricSparseMatrix {
+private:
+    int nrows, nnz;    // dimension and number of stored entries
+    int* row_ptr;      // start of each row in col_idx/values (nrows + 1 entries)
+    int* col_idx;      // column of each stored entry (the diagonal first)
+    float* values;     // value of each stored entry
+
+    // parallel product state
+    std::vector<int> block_start;                  // first row of each thread block (num_blocks + 1 entries)
+    std::vector<int> block_reach;                  // one past the largest column touched by each block
+    mutable std::vector<std::vector<float>> partial;  // private partial vector of each block, from block_start
+    ThreadPool* pool;                              // workers of the parallel product (not owned; nullptr: serial)
+
+    // method to release the data structure
+    void release() {
+        if (row_ptr != nullptr) free(row_ptr);
+        if (col_idx != nullptr) free(col_idx);
+        if (values != nullptr) free(values);
+        row_ptr = nullptr;
+        col_idx = nullptr;
+        values = nullptr;
+    }
+
+    // method to compute the contribution of rows [begin, end) into out, where out[i] holds y[offset + i]
+    void multiply_rows(const float* x, float* out, int offset, int begin, int end) const {
+        for (int r = begin; r < end; r++) {
+            int k = row_ptr[r];
+            float xr = x[r];
+            float acc = values[k] * xr;
+            for (k++; k < row_ptr[r + 1]; k++) {
+                int c = col_idx[k];
+                acc += values[k] * x[c];
+                out[c - offset] += values[k] * xr;
+            }
+            out[r - offset] += acc;
+        }
+    }
+
+public:
+    // default constructor
+    SymmetricSparseMatrix() : nrows(0), nnz(0), row_ptr(nullptr), col_idx(nullptr), values(nullptr), pool(nullptr) {}
+
+    // destructor to free allocated memory
+    ~SymmetricSparseMatrix() {
+        release();
+    }
+
+    SymmetricSparseMatrix(const SymmetricSparseMatrix&) = delete;
+    SymmetricSparseMatrix& operator=(const SymmetricSparseMatrix&) = delete;
+
+    // method to build the matrix from the upper triangle of a full CSR matrix with sorted columns
+    void from_csr(const SparseMatrix* A) {
+        release();
+        nrows = A->get_nrows();
+        const int* A_row_ptr = A->get_row_ptr();
+        const int* A_col_idx = A->get_col_idx();
+        const float* A_values = A->get_values();
+
+        row_ptr = (int*)calloc(nrows + 1, sizeof(int));
+        for (int r = 0; r < nrows; r++) {
+            int count = 1;  // the diagonal is always stored
+            for (int k = A_row_ptr[r]; k < A_row_ptr[r + 1]; k++)
+                if (A_col_idx[k] > r) count++;
+            row_ptr[r + 1] = row_ptr[r] + count;
+        }
+        nnz = row_ptr[nrows];
+        col_idx = (int*)malloc(sizeof(int) * (nnz > 0 ? nnz : 1));
+        values = (float*)malloc(sizeof(float) * (nnz > 0 ? nnz : 1));
+
+        for (int r = 0; r < nrows; r++) {
+            int k = row_ptr[r];
+            col_idx[k] = r;
+            values[k] = A->get_diagonal(r);
+            for (int j = A_row_ptr[r]; j < A_row_ptr[r + 1]; j++)
+                if (A_col_idx[j] > r) {
+                    k++;
+                    col_idx[k] = A_col_idx[j];
+                    values[k] = A_values[j];
+                }
+        }
+        set_pool(nullptr);
+    }
+
+    /*
+      Method to prepare the parallel product on the threads of a pool (the
+      caller keeps it alive while the matrix is used): the rows are split
+      into one block per thread with about the same number of stored
+      entries, and each block gets a partial vector from its first row up to
+      the largest column it touches.
+     */
+    void set_pool(ThreadPool* threads) {
+        pool = threads;
+        int num_threads = parallel_width(pool);
+        if (num_threads > nrows) num_threads = nrows > 0 ? nrows : 1;
+        block_start.assign(num_threads + 1, nrows);
+        block_start[0] = 0;
+        for (int t = 1, r = 0; t < num_threads; t++) {
+            long long target = (long long)nnz * t / num_threads;
+            while (r < nrows && row_ptr[r] < target) r++;
+            block_start[t] = r;
+        }
+
+        block_reach.assign(num_threads, 0);
+        partial.assign(num_threads, std::vector<float>());
+        for (int t = 0; t < num_threads; t++) {
+            int reach = block_start[t + 1];
+            for (int r = block_start[t]; r < block_start[t + 1]; r++)
+                if (row_ptr[r + 1] > row_ptr[r]) reach = std::max(reach, col_idx[row_ptr[r + 1] - 1] + 1);
+            block_reach[t] = reach;
+            if (num_threads > 1) partial[t].resize(reach - block_start[t]);
+        }
+        if (num_threads == 1) pool = nullptr;
+    }
+
+    // method to get the number of rows in the matrix
+    int get_nrows() const { return nrows; }
+
+    // method to get the number of columns in the matrix
+    int get_ncols() const { return nrows; }
+
+    // method to get the number of stored entries (upper triangle and diagonal)
+    int get_nnz() const { return nnz; }
+
+    // method to get the number of entries of the full matrix
+    long long get_full_nnz() const { return 2LL * nnz - nrows; }
+
+    // method to get the diagonal entry of a row
+    float get_diagonal(int row) const { return values[row_ptr[row]]; }
+
+    // method to compute y = A * x
+    void multiply(const Vector* x, Vector* y) const {
+        const float* xv = x->get_data();
+        float* yv = y->get_data();
+        int num_blocks = (int)partial.size();
+        if (pool == nullptr) {
+            std::fill(yv, yv + nrows, 0.0f);
+            multiply_rows(xv, yv, 0, 0, nrows);
+            return;
+        }
+
+        pool->run_blocks(num_blocks, [this, xv](int t) {
+            std::vector<float>& out = partial[t];
+            std::fill(out.begin(), out.end(), 0.0f);
+            multiply_rows(xv, out.data(), block_start[t], block_start[t], block_start[t + 1]);
+        });
+
+        // y[i] is the sum of the partial vectors of the blocks that start at or before i and reach past it
+        pool->run_blocks(num_blocks, [this, yv](int t) {
+            for (int i = block_start[t]; i < block_start[t + 1]; i++) yv[i] = 0;
+            for (int s = 0; s <= t; s++) {
+                const std::vector<float>& source = partial[s];
+                int end = std::min(block_start[t + 1], block_reach[s]);
+                for (int i = block_start[t]; i < end; i++) yv[i] += source[i - block_start[s]];
+            }
+        });
+    }
+};
+
+#endif //SIMU_PROJEKT_SYMMETRIC_SPARSE_MATRIX_HPP
\ No newline at end of file
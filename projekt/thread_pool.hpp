@@ -0,0 +1,222 @@
+#ifndef SIMU_PROJEKT_THREAD_POOL_HPP
+#define SIMU_PROJEKT_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// definicion de la clase ThreadPool: conjunto fijo de hilos que ejecutan tareas de una cola comun
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;          // hilos de trabajo
+    std::queue<std::function<void()>> tasks;   // tareas pendientes
+    std::mutex mtx;                            // protege la cola y los contadores
+    std::condition_variable task_available;    // avisa a los hilos que hay trabajo
+    std::condition_variable all_done;          // avisa que no quedan tareas pendientes ni en ejecucion
+    int running;                               // tareas en ejecucion
+    bool stopping;                             // indica que el pool se esta destruyendo
+
+    // bucle que ejecuta cada hilo de trabajo
+    void worker_loop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+                running++;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                running--;
+                if (running == 0 && tasks.empty()) all_done.notify_all();
+            }
+        }
+    }
+
+public:
+    // constructor que lanza num_threads hilos (al menos uno)
+    explicit ThreadPool(int num_threads) : running(0), stopping(false) {
+        if (num_threads < 1) num_threads = 1;
+        for (int i = 0; i < num_threads; i++)
+            workers.emplace_back([this] { worker_loop(); });
+    }
+
+    // destructor: termina las tareas pendientes y une los hilos
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        task_available.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // metodo para encolar una tarea; puede llamarse desde otra tarea del pool
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push(std::move(task));
+        }
+        task_available.notify_one();
+    }
+
+    // metodo que bloquea hasta que la cola este vacia y ningun hilo este trabajando
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(mtx);
+        all_done.wait(lock, [this] { return running == 0 && tasks.empty(); });
+    }
+
+    /*
+      Metodo para ejecutar work(b) para b = 0..num_blocks-1 entre los hilos
+      del pool y el hilo que llama, y esperar a que terminen todos. Cada hilo
+      toma el siguiente bloque libre cuando termina el anterior, asi que los
+      bloques de costo desparejo se equilibran solos. El que llama tambien
+      procesa bloques y solo espera a los que ya estan en curso: puede
+      llamarse desde una tarea del pool (o anidado) sin bloquearse aunque
+      todos los hilos esten ocupados.
+     */
+    template <class Work>
+    void run_blocks(int num_blocks, Work work) {
+        if (num_blocks <= 1) {
+            if (num_blocks == 1) work(0);
+            return;
+        }
+        // el estado es compartido: una tarea auxiliar puede empezar cuando ya no quedan bloques
+        struct State {
+            std::atomic<int> next{ 0 };
+            int done = 0;
+            std::mutex mtx;
+            std::condition_variable finished;
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+        Work* shared_work = &work;
+        auto run = [state, shared_work, num_blocks] {
+            int completed = 0;
+            for (int b; (b = state->next++) < num_blocks; completed++) (*shared_work)(b);
+            if (completed == 0) return;
+            std::lock_guard<std::mutex> lock(state->mtx);
+            state->done += completed;
+            if (state->done == num_blocks) state->finished.notify_all();
+        };
+        int helpers = std::min(num_blocks - 1, get_num_threads());
+        for (int h = 0; h < helpers; h++) submit(run);
+        run();
+        std::unique_lock<std::mutex> lock(state->mtx);
+        state->finished.wait(lock, [&state, num_blocks] { return state->done == num_blocks; });
+    }
+
+    // metodo para obtener la cantidad de hilos
+    int get_num_threads() const {
+        return (int)workers.size();
+    }
+};
+
+// funcion para obtener cuantos hilos trabajan en ThreadPool::run_blocks: los del pool y el que llama (pool nullptr: uno)
+inline int parallel_width(const ThreadPool* pool) {
+    return pool != nullptr ? pool->get_num_threads() + 1 : 1;
+}
+
+// funcion para ejecutar work(t) para t = 0..num_blocks-1 entre los hilos del pool (nullptr: en orden, sin hilos)
+template <class Work>
+void run_threads(int num_blocks, ThreadPool* pool, Work work) {
+    if (pool != nullptr) {
+        pool->run_blocks(num_blocks, work);
+        return;
+    }
+    for (int t = 0; t < num_blocks; t++) work(t);
+}
+
+// definicion de la clase Semaphore: contador de permisos para acotar recursos en uso
+class Semaphore {
+private:
+    std::mutex mtx;
+    std::condition_variable released;
+    int permits;
+
+public:
+    explicit Semaphore(int initial_permits) : permits(initial_permits) {}
+
+    // metodo que espera hasta obtener un permiso
+    void acquire() {
+        std::unique_lock<std::mutex> lock(mtx);
+        released.wait(lock, [this] { return permits > 0; });
+        permits--;
+    }
+
+    // metodo que devuelve un permiso
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            permits++;
+        }
+        released.notify_one();
+    }
+};
+
+// definicion de la clase BoundedQueue: cola de capacidad fija entre una etapa productora y una consumidora
+template <typename T>
+class BoundedQueue {
+private:
+    std::queue<T> items;                    // elementos en espera
+    size_t capacity;                        // cantidad maxima de elementos en espera
+    std::mutex mtx;                         // protege la cola
+    std::condition_variable not_empty;      // avisa al consumidor que hay elementos
+    std::condition_variable not_full;       // avisa al productor que hay lugar
+    bool closed;                            // indica que no se agregaran mas elementos
+
+public:
+    explicit BoundedQueue(size_t max_items) : capacity(max_items < 1 ? 1 : max_items), closed(false) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // metodo que espera a que haya lugar y agrega el elemento; devuelve false si la cola fue cerrada
+    bool push(T item) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+            if (closed) return false;
+            items.push(std::move(item));
+        }
+        not_empty.notify_one();
+        return true;
+    }
+
+    // metodo que espera un elemento y lo extrae; devuelve false si la cola esta cerrada y vacia
+    bool pop(T* item) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            not_empty.wait(lock, [this] { return closed || !items.empty(); });
+            if (items.empty()) return false;
+            *item = std::move(items.front());
+            items.pop();
+        }
+        not_full.notify_one();
+        return true;
+    }
+
+    // metodo para cerrar la cola: despierta a quienes esperan; los elementos ya agregados se pueden extraer
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+};
+
+#endif  // SIMU_PROJEKT_THREAD_POOL_HPP
\ No newline at end of file
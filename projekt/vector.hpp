@@ -4,26 +4,94 @@
 #include <iostream>
 #include <cstdlib> // for malloc and free
 
+// Non-owning view of float values separated by a fixed stride (a vector segment, a matrix row or column)
+class VectorView {
+private:
+    float* data;  // first value of the view
+    int size;     // number of values
+    int stride;   // distance between consecutive values
+
+public:
+    // Constructor from a pointer, a size and an optional stride
+    VectorView(float* values = nullptr, int num_values = 0, int step = 1) : data(values), size(num_values), stride(step) {}
+
+    // Method to get the size of the view
+    int get_size() const { return size; }
+
+    // Method to get the stride of the view
+    int get_stride() const { return stride; }
+
+    // Method to get direct access to the first value (contiguous only when the stride is 1)
+    float* get_data() const { return data; }
+
+    // Method to set the value of an element at a given position
+    void set(float value, int position) const { data[position * stride] = value; }
+
+    // Method to add a value to an element at a given position
+    void add(float value, int position) const { data[position * stride] += value; }
+
+    // Method to get the value of an element at a given position
+    float get(int position) const { return data[position * stride]; }
+
+    // Method to set every element to zero
+    void init() const {
+        for (int i = 0; i < size; i++)
+            data[i * stride] = 0;
+    }
+
+    // Method to get a view of num_values elements starting at a given position
+    VectorView segment(int start, int num_values) const {
+        return VectorView(data + start * stride, num_values, stride);
+    }
+};
+
 // Definition of the Vector class
 class Vector {
 private:
-    int size;     // size of the vector
-    float* data;  // pointer to store vector data
+    int size;      // size of the vector
+    int capacity;  // number of values the allocated buffer can hold
+    float* data;   // pointer to store vector data
 
     // Method to create the vector data structure
     void create() {
-        data = (float*)malloc(sizeof(float) * size);  // allocate memory for vector data
+        capacity = size;
+        data = (float*)malloc(sizeof(float) * (size > 0 ? size : 1));  // allocate memory for vector data
     }
 
 public:
     // Default constructor
-    Vector() : size(0), data(nullptr) {}
+    Vector() : size(0), capacity(0), data(nullptr) {}
 
     // Constructor that initializes the vector with a number of elements
-    Vector(int data_qty) : size(data_qty), data(nullptr) {
+    Vector(int data_qty) : size(data_qty), capacity(0), data(nullptr) {
         create();  // create the vector data structure
     }
 
+    // Move constructor: takes the buffer of the other vector, which is left empty
+    Vector(Vector&& other) noexcept : size(other.size), capacity(other.capacity), data(other.data) {
+        other.size = 0;
+        other.capacity = 0;
+        other.data = nullptr;
+    }
+
+    // Move assignment: releases the current buffer and takes the one of the other vector
+    Vector& operator=(Vector&& other) noexcept {
+        if (this != &other) {
+            if (data != nullptr) free(data);
+            size = other.size;
+            capacity = other.capacity;
+            data = other.data;
+            other.size = 0;
+            other.capacity = 0;
+            other.data = nullptr;
+        }
+        return *this;
+    }
+
+    // Copies would share the buffer and free it twice
+    Vector(const Vector&) = delete;
+    Vector& operator=(const Vector&) = delete;
+
     // Destructor to free allocated memory
     ~Vector() {
         if (data != nullptr) {
@@ -37,8 +105,12 @@ public:
             data[i] = 0;  // assign zero to each element of the vector
     }
 
-    // Method to set the size of the vector and create the data structure
+    // Method to set the size of the vector; the current buffer is reused when it is large enough
     void set_size(int num_values) {
+        if (data != nullptr && num_values <= capacity) {
+            size = num_values;
+            return;
+        }
         if (data != nullptr) {
             free(data);
         }
@@ -66,17 +138,35 @@ public:
         return data[position];
     }
 
+    // Method to get direct access to the contiguous vector data
+    float* get_data() {
+        return data;
+    }
+
+    // Method to get read-only access to the contiguous vector data
+    const float* get_data() const {
+        return data;
+    }
+
+    // Method to get a view of the whole vector
+    VectorView view() {
+        return VectorView(data, size);
+    }
+
+    // Method to get a view of num_values elements starting at a given position
+    VectorView segment(int start, int num_values) {
+        return VectorView(data + start, num_values);
+    }
+
+    // Method to get a view of every step-th element starting at a given position
+    VectorView strided(int start, int step) {
+        return VectorView(data + start, start < size ? (size - start + step - 1) / step : 0, step);
+    }
+
     // Method to remove an element from the vector
     void remove_row(int row) {
-        int neo_index = 0;
-        float* neo_data = (float*)malloc(sizeof(float) * (size - 1));
-        for (int i = 0; i < size; i++)
-            if (i != row) {
-                neo_data[neo_index] = data[i];
-                neo_index++;
-            }
-        free(data);
-        data = neo_data;
+        for (int i = row; i < size - 1; i++)
+            data[i] = data[i + 1];
         size--;
     }
 
@@ -89,5 +179,4 @@ public:
     }
 };
 
-#endif  // SIMU_PROJEKT_VECTOR_HPP
-
+#endif  // SIMU_PROJEKT_VECTOR_HPP
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef SIMU_PROJEKT_WORKSPACE_HPP
+#define SIMU_PROJEKT_WORKSPACE_HPP
+
+#include <cstdlib> // for malloc and free
+#include <vector>
+
+#include "matrix.hpp"
+#include "vector.hpp"
+
+/*
+  Scratch memory for temporaries that are needed on every call of a routine.
+  Views are carved from large buffers with a bump pointer; reset() makes the
+  whole space available again without releasing it, so a workspace kept
+  alive across calls stops allocating once it has grown to the largest
+  request. Buffers are never moved, so views stay valid until reset().
+ */
+class Workspace {
+private:
+    std::vector<float*> buffers;   // allocated buffers, in order of creation
+    std::vector<size_t> sizes;     // number of floats of each buffer
+    size_t current;                // buffer being carved
+    size_t used;                   // floats already handed out from the current buffer
+
+    static const size_t MIN_BUFFER = 4096;
+
+    // method to get n contiguous floats, moving to the next buffer (or creating one) when needed
+    float* take(size_t n) {
+        while (current < buffers.size() && used + n > sizes[current]) {
+            current++;
+            used = 0;
+        }
+        if (current == buffers.size()) {
+            size_t size = n > MIN_BUFFER ? n : MIN_BUFFER;
+            buffers.push_back((float*)malloc(sizeof(float) * size));
+            sizes.push_back(size);
+            used = 0;
+        }
+        float* values = buffers[current] + used;
+        used += n;
+        return values;
+    }
+
+public:
+    // default constructor, the first buffer is created on demand
+    Workspace() : current(0), used(0) {}
+
+    // destructor to free allocated memory
+    ~Workspace() {
+        for (float* buffer : buffers) free(buffer);
+    }
+
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    // method to get an uninitialized rows x cols matrix
+    MatrixView get_matrix(int rows, int cols) {
+        return MatrixView(take((size_t)rows * cols), rows, cols, cols);
+    }
+
+    // method to get an uninitialized vector of the given size
+    VectorView get_vector(int size) {
+        return VectorView(take((size_t)size), size, 1);
+    }
+
+    // method to make all the space available again; previously returned views become invalid
+    void reset() {
+        current = 0;
+        used = 0;
+    }
+};
+
+#endif //SIMU_PROJEKT_WORKSPACE_HPP
\ No newline at end of file